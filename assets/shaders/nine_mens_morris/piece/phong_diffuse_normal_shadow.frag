@@ -9,11 +9,11 @@ in vec4 v_fragment_position_light_space;
 in vec3 v_view_position_tangent_space;
 in vec3 v_light_direction_tangent_space;
 in vec3 v_light_position_tangent_space[D_POINT_LIGHTS];
+flat in vec3 v_highlight_color;
 
 layout(location = 0) out vec4 o_fragment_color;
 
 layout(binding = 2) uniform sampler2D u_shadow_map;
-uniform vec3 u_highlight_color;
 
 layout(shared, binding = 1) uniform DirectionalLight {
     DirectionalLight_ u_directional_light;
@@ -57,5 +57,5 @@ void main() {
         );
     }
 
-    o_fragment_color = vec4(color + u_highlight_color, ambient_diffuse.a);
+    o_fragment_color = vec4(color + v_highlight_color, ambient_diffuse.a);
 }
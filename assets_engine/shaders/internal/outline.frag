@@ -1,9 +1,9 @@
 #version 430 core
 
-layout(location = 0) out vec4 o_fragment_color;
+in flat vec3 g_color;
 
-uniform vec3 u_color;
+layout(location = 0) out vec4 o_fragment_color;
 
 void main() {
-    o_fragment_color = vec4(u_color, 1.0);
+    o_fragment_color = vec4(g_color, 1.0);
 }
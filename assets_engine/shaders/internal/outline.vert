@@ -1,13 +1,17 @@
 #version 430 core
 
 layout(location = 0) in vec3 a_position;
+layout(location = 8) in mat4 a_model_matrix;  // Per instance
+layout(location = 12) in vec4 a_outline;  // Per instance; color and width
 
-uniform mat4 u_model_matrix;
+out vec4 v_outline;
 
 layout(binding = 0) uniform ProjectionView {
     mat4 u_projection_view_matrix;
 };
 
 void main() {
-    gl_Position = u_projection_view_matrix * u_model_matrix * vec4(a_position, 1.0);
+    v_outline = a_outline;
+
+    gl_Position = u_projection_view_matrix * a_model_matrix * vec4(a_position, 1.0);
 }
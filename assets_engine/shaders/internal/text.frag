@@ -10,5 +10,14 @@ layout(binding = 0) uniform sampler2D u_bitmap;
 uniform vec3 u_color[D_MAX_TEXTS];
 
 void main() {
+#ifdef D_DISTANCE_FIELD_EDGE
+    // Antialias the outline over about one pixel on the screen, whatever the scale of the text
+    const float edge = float(D_DISTANCE_FIELD_EDGE) / 255.0;
+    const float distance = texture(u_bitmap, v_texture_coordinate).r;
+    const float smoothing = fwidth(distance) * 0.5;
+
+    o_fragment_color = vec4(u_color[v_index], smoothstep(edge - smoothing, edge + smoothing, distance));
+#else
     o_fragment_color = vec4(u_color[v_index], texture(u_bitmap, v_texture_coordinate).r);
+#endif
 }
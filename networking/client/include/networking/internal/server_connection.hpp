@@ -3,8 +3,6 @@
 #include <utility>
 #include <atomic>
 
-#include <boost/endian/conversion.hpp>
-
 #include "networking/internal/connection.hpp"
 
 namespace networking {
@@ -34,7 +32,9 @@ namespace networking::internal {
 
         void task_write_header_payload();
         void task_read_header();
+        void task_read_extended_size();
         void task_read_payload();
+        void start_reading_payload();
         void task_send_message(const Message& message);
         void task_connect_to_server();
 
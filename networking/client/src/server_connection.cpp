@@ -28,12 +28,10 @@ namespace networking::internal {
     void ServerConnection::task_write_header_payload() {
         assert(!m_outgoing_messages.empty());
 
-        MsgHeader header_to_write {m_outgoing_messages.front().header};
-        boost::endian::native_to_big_inplace(header_to_write.id);
-        boost::endian::native_to_big_inplace(header_to_write.payload_size);
+        const std::size_t header_size {encode_header(m_outgoing_messages.front().header, m_outgoing_header)};
 
         std::vector<boost::asio::const_buffer> buffers;
-        buffers.emplace_back(&header_to_write, sizeof(MsgHeader));
+        buffers.emplace_back(m_outgoing_header.data(), header_size);
 
         if (m_outgoing_messages.front().header.payload_size > 0) {
             buffers.emplace_back(m_outgoing_messages.front().payload.get(), m_outgoing_messages.front().header.payload_size);
@@ -62,7 +60,7 @@ namespace networking::internal {
     }
 
     void ServerConnection::task_read_header() {
-        boost::asio::async_read(m_tcp_socket, boost::asio::buffer(&m_incoming_message.header, sizeof(MsgHeader)),
+        boost::asio::async_read(m_tcp_socket, boost::asio::buffer(m_incoming_header.data(), COMPACT_HEADER_SIZE),
             [this](boost::system::error_code ec, [[maybe_unused]] std::size_t bytes_transferred) {
                 if (ec) {
                     m_tcp_socket.close();
@@ -70,25 +68,53 @@ namespace networking::internal {
                     throw ConnectionError("Could not read header: " + ec.message());
                 }
 
-                assert(bytes_transferred == sizeof(MsgHeader));
+                assert(bytes_transferred == COMPACT_HEADER_SIZE);
 
-                boost::endian::big_to_native_inplace(m_incoming_message.header.id);
-                boost::endian::big_to_native_inplace(m_incoming_message.header.payload_size);
+                if (decode_compact_header(m_incoming_header, m_incoming_message.header)) {
+                    task_read_extended_size();
+                } else {
+                    start_reading_payload();
+                }
+            }
+        );
+    }
 
-                // A payload may be empty
-                if (m_incoming_message.header.payload_size > 0) {
-                    // Allocate space so that we write to it later
-                    m_incoming_message.payload = std::make_unique<unsigned char[]>(m_incoming_message.header.payload_size);
+    void ServerConnection::task_read_extended_size() {
+        boost::asio::async_read(m_tcp_socket, boost::asio::buffer(m_incoming_header.data() + COMPACT_HEADER_SIZE, EXTENDED_HEADER_SIZE - COMPACT_HEADER_SIZE),
+            [this](boost::system::error_code ec, [[maybe_unused]] std::size_t bytes_transferred) {
+                if (ec) {
+                    m_tcp_socket.close();
 
-                    task_read_payload();
-                } else {
-                    add_to_incoming_messages();
-                    task_read_header();
+                    throw ConnectionError("Could not read extended header: " + ec.message());
                 }
+
+                assert(bytes_transferred == EXTENDED_HEADER_SIZE - COMPACT_HEADER_SIZE);
+
+                try {
+                    decode_extended_size(m_incoming_header, m_incoming_message.header);
+                } catch (const ConnectionError&) {
+                    m_tcp_socket.close();
+                    throw;
+                }
+
+                start_reading_payload();
             }
         );
     }
 
+    void ServerConnection::start_reading_payload() {
+        // A payload may be empty
+        if (m_incoming_message.header.payload_size > 0) {
+            // Allocate space so that we write to it later
+            m_incoming_message.payload = std::make_unique<unsigned char[]>(m_incoming_message.header.payload_size);
+
+            task_read_payload();
+        } else {
+            add_to_incoming_messages();
+            task_read_header();
+        }
+    }
+
     void ServerConnection::task_read_payload() {
         boost::asio::async_read(m_tcp_socket, boost::asio::buffer(m_incoming_message.payload.get(), m_incoming_message.header.payload_size),
             [this](boost::system::error_code ec, [[maybe_unused]] std::size_t bytes_transferred) {
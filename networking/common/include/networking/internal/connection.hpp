@@ -38,6 +38,10 @@ namespace networking::internal {
 
         SyncQueue<BasicMessage> m_outgoing_messages;
         BasicMessage m_incoming_message;
+
+        // Must outlive the asynchronous operations
+        HeaderBuffer m_outgoing_header {};
+        HeaderBuffer m_incoming_header {};
     };
 
     template<typename T>
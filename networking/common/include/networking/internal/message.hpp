@@ -2,9 +2,8 @@
 
 #include <cstdint>
 #include <cstddef>
-#include <type_traits>
 #include <memory>
-#include <limits>
+#include <array>
 #include <sstream>
 
 #include <cereal/cereal.hpp>
@@ -15,18 +14,40 @@
 namespace networking::internal {
     class Message;
 
-    inline constexpr std::size_t MAX_ITEM_SIZE {std::numeric_limits<std::uint16_t>::max()};
+    // On the wire, a header is the ID and the payload size, both 16-bit and big endian
+    // Payloads that don't fit are marked by the maximum 16-bit size and an extra 32-bit size follows
+    inline constexpr std::size_t COMPACT_HEADER_SIZE {4};
+    inline constexpr std::size_t EXTENDED_HEADER_SIZE {8};
+    inline constexpr std::uint16_t EXTENDED_SIZE_MARK {0xFFFF};
+    inline constexpr std::size_t MAX_COMPACT_PAYLOAD_SIZE {EXTENDED_SIZE_MARK - 1};
+    inline constexpr std::size_t MAX_PAYLOAD_SIZE {1024 * 1024 * 4};  // Bigger messages are rejected
 
     struct MsgHeader final {
         std::uint16_t id {};
-        std::uint16_t payload_size {};
+        std::uint32_t payload_size {};
     };
 
-    static_assert(std::is_trivially_copyable_v<MsgHeader>);
+    using HeaderBuffer = std::array<unsigned char, EXTENDED_HEADER_SIZE>;
+
+    // Get the size of the header on the wire
+    std::size_t header_size(std::size_t payload_size) noexcept;
+
+    // Write the header in the wire format and return its size
+    std::size_t encode_header(const MsgHeader& header, HeaderBuffer& buffer) noexcept;
+
+    // Read the compact part of a header; returns true, if the extended size must be read next
+    bool decode_compact_header(const HeaderBuffer& buffer, MsgHeader& header) noexcept;
+
+    // Read the extended size that follows the compact part
+    // Throws ConnectionError, if the size is not valid
+    void decode_extended_size(const HeaderBuffer& buffer, MsgHeader& header);
 
     struct BasicMessage final {
         MsgHeader header;
         std::unique_ptr<unsigned char[]> payload;
+
+        // Get the size on the wire
+        std::size_t size() const noexcept;
     };
 
     BasicMessage basic_message(Message&& message) noexcept;
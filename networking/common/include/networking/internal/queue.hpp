@@ -3,6 +3,7 @@
 #include <deque>
 #include <mutex>
 #include <utility>
+#include <iterator>
 #include <cstddef>
 
 namespace networking::internal {
@@ -87,6 +88,25 @@ namespace networking::internal {
             std::lock_guard lock {m_mutex};
             return m_queue.clear();
         }
+
+        // Swap the item with the last one matching the predicate, ignoring the first `begin` items
+        template<typename Predicate>
+        bool swap_back_if(std::size_t begin, Predicate&& predicate, T& item) {
+            std::lock_guard lock {m_mutex};
+
+            for (auto iter {m_queue.rbegin()}; iter != m_queue.rend(); iter++) {
+                if (static_cast<std::size_t>(std::distance(iter, m_queue.rend())) <= begin) {
+                    break;
+                }
+
+                if (predicate(*iter)) {
+                    std::swap(*iter, item);
+                    return true;
+                }
+            }
+
+            return false;
+        }
     private:
         std::deque<T> m_queue;
         mutable std::mutex m_mutex;
@@ -1,9 +1,63 @@
 #include "networking/internal/message.hpp"
 
 #include <utility>
+#include <string>
 #include <cstring>
 
 namespace networking::internal {
+    std::size_t header_size(std::size_t payload_size) noexcept {
+        return payload_size > MAX_COMPACT_PAYLOAD_SIZE ? EXTENDED_HEADER_SIZE : COMPACT_HEADER_SIZE;
+    }
+
+    std::size_t encode_header(const MsgHeader& header, HeaderBuffer& buffer) noexcept {
+        const bool extended {header.payload_size > MAX_COMPACT_PAYLOAD_SIZE};
+        const std::uint16_t compact_size {extended ? EXTENDED_SIZE_MARK : static_cast<std::uint16_t>(header.payload_size)};
+
+        buffer[0] = static_cast<unsigned char>(header.id >> 8);
+        buffer[1] = static_cast<unsigned char>(header.id);
+        buffer[2] = static_cast<unsigned char>(compact_size >> 8);
+        buffer[3] = static_cast<unsigned char>(compact_size);
+
+        if (!extended) {
+            return COMPACT_HEADER_SIZE;
+        }
+
+        buffer[4] = static_cast<unsigned char>(header.payload_size >> 24);
+        buffer[5] = static_cast<unsigned char>(header.payload_size >> 16);
+        buffer[6] = static_cast<unsigned char>(header.payload_size >> 8);
+        buffer[7] = static_cast<unsigned char>(header.payload_size);
+
+        return EXTENDED_HEADER_SIZE;
+    }
+
+    bool decode_compact_header(const HeaderBuffer& buffer, MsgHeader& header) noexcept {
+        header.id = static_cast<std::uint16_t>((buffer[0] << 8) | buffer[1]);
+        header.payload_size = static_cast<std::uint16_t>((buffer[2] << 8) | buffer[3]);
+
+        return header.payload_size == EXTENDED_SIZE_MARK;
+    }
+
+    void decode_extended_size(const HeaderBuffer& buffer, MsgHeader& header) {
+        header.payload_size =
+            (std::uint32_t(buffer[4]) << 24) |
+            (std::uint32_t(buffer[5]) << 16) |
+            (std::uint32_t(buffer[6]) << 8) |
+            std::uint32_t(buffer[7]);
+
+        // Small payloads must always use the compact header
+        if (header.payload_size <= MAX_COMPACT_PAYLOAD_SIZE) {
+            throw ConnectionError("Extended header with a compact payload size");
+        }
+
+        if (header.payload_size > MAX_PAYLOAD_SIZE) {
+            throw ConnectionError("Payload size exceeds the maximum: " + std::to_string(header.payload_size));
+        }
+    }
+
+    std::size_t BasicMessage::size() const noexcept {
+        return header_size(header.payload_size) + header.payload_size;
+    }
+
     BasicMessage basic_message(Message&& message) noexcept {
         BasicMessage result;
         result.header = message.m_header;
@@ -40,7 +94,7 @@ namespace networking::internal {
     }
 
     std::size_t Message::size() const noexcept {
-        return sizeof(MsgHeader) + m_header.payload_size;
+        return header_size(m_header.payload_size) + m_header.payload_size;
     }
 
     std::uint16_t Message::id() const noexcept {
@@ -48,8 +102,12 @@ namespace networking::internal {
     }
 
     void Message::write_payload(std::string&& buffer) {
+        if (buffer.size() > MAX_PAYLOAD_SIZE) {
+            throw SerializationError("Payload size exceeds the maximum: " + std::to_string(buffer.size()));
+        }
+
         m_payload = std::make_unique<unsigned char[]>(buffer.size());
         std::memcpy(m_payload.get(), reinterpret_cast<unsigned char*>(buffer.data()), buffer.size());
-        m_header.payload_size = buffer.size();
+        m_header.payload_size = static_cast<std::uint32_t>(buffer.size());
     }
 }
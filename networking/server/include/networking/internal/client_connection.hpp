@@ -3,6 +3,10 @@
 #include <utility>
 #include <memory>
 #include <functional>
+#include <optional>
+#include <chrono>
+#include <mutex>
+#include <cstddef>
 
 #include <spdlog/spdlog.h>
 
@@ -14,6 +18,23 @@ namespace networking {
 }
 
 namespace networking::internal {
+    // Watermarks for the outgoing queue of every connection
+    // A connection is under pressure once it goes over any of the high watermarks and
+    // it stops being under pressure once it goes back under both of the low watermarks
+    struct OutgoingLimits {
+        std::size_t high_bytes {1024 * 256};
+        std::size_t low_bytes {1024 * 64};
+        std::size_t high_messages {1024};
+        std::size_t low_messages {256};
+        std::chrono::steady_clock::duration max_pressure_time {std::chrono::seconds(10)};  // Then it's disconnected
+    };
+
+    // Used to specify how a message should be treated in regard to the outgoing queue
+    enum class SendPolicy {
+        Always,  // Critical message; always queue it
+        Coalesce  // Don't queue the message, if the connection is under pressure; otherwise replace the last queued message with the same ID, if it's not yet being written
+    };
+
     // Object representing a connection to a client
     // Should be managed by a smart pointer
     class ClientConnection final : public Connection, public std::enable_shared_from_this<ClientConnection> {
@@ -23,33 +44,56 @@ namespace networking::internal {
             boost::asio::ip::tcp::socket&& tcp_socket,
             SyncQueue<std::pair<std::shared_ptr<ClientConnection>, Message>>& incoming_messages,
             ClientId client_id,
-            std::shared_ptr<spdlog::logger> logger
+            std::shared_ptr<spdlog::logger> logger,
+            const OutgoingLimits& outgoing_limits
         )
             : Connection(context, std::move(tcp_socket)), m_incoming_messages(incoming_messages),
-            m_logger(logger), m_client_id(client_id) {}
+            m_logger(logger), m_client_id(client_id), m_outgoing_limits(outgoing_limits) {}
 
         // Send a message asynchronously
-        void send(const Message& message);
+        // Returns false, if the message was dropped
+        bool send(const Message& message, SendPolicy policy = SendPolicy::Always);
 
         // Close the connection asynchronously
         void close();
 
         // Get the ID of the client
         ClientId get_id() const noexcept;
+
+        // Check if the connection is under pressure, meaning that the client doesn't keep up
+        bool would_block() const;
+
+        // Get the amount of data that is waiting to be sent
+        std::size_t get_outgoing_bytes() const;
+        std::size_t get_outgoing_messages() const;
     private:
         void start_communication();
         void add_to_incoming_messages();
 
         void task_write_header_payload();
         void task_read_header();
+        void task_read_extended_size();
         void task_read_payload();
-        void task_send_message(const Message& message);
+        void start_reading_payload();
+        void task_send_message(const Message& message, SendPolicy policy);
+
+        void outgoing_added(std::size_t size);
+        void outgoing_removed(std::size_t size);
+        void update_pressure();
+        bool pressure_exceeded(std::chrono::steady_clock::time_point now) const;
 
         SyncQueue<std::pair<std::shared_ptr<ClientConnection>, Message>>& m_incoming_messages;
         std::shared_ptr<spdlog::logger> m_logger;
         ClientId m_client_id {};  // Given by the server
         bool m_used {false};  // Set to true after using the connection and calling on_client_disconnected()
 
+        // Outgoing queue accounting; includes messages not yet queued by the network thread
+        OutgoingLimits m_outgoing_limits;
+        std::size_t m_outgoing_bytes {};
+        std::size_t m_outgoing_count {};
+        std::optional<std::chrono::steady_clock::time_point> m_pressure_begin;  // Set while under pressure
+        mutable std::mutex m_outgoing_mutex;
+
         friend class ::networking::Server;
     };
 }
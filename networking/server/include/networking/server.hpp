@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
 #include <memory>
 #include <thread>
 #include <forward_list>
@@ -12,6 +13,7 @@
 #include <filesystem>
 
 #include <spdlog/spdlog.h>
+#include <spdlog/async.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/rotating_file_sink.h>
 
@@ -29,6 +31,8 @@ namespace networking {
     using ConnectionError = internal::ConnectionError;
     using SerializationError = internal::SerializationError;
     using ClientId = internal::ClientId;
+    using OutgoingLimits = internal::OutgoingLimits;
+    using SendPolicy = internal::SendPolicy;
 
     // Used to specify where logs are emitted
     enum LogTarget : unsigned int {
@@ -37,16 +41,29 @@ namespace networking {
         LogTargetFile = 1u << 1
     };
 
+    // Used to specify what happens when the logging queue is full
+    // Block may stall the network thread, the others never do, but they lose messages
+    // DiscardNew needs spdlog 1.13 or newer; with older versions it behaves like OverrunOldest
+    enum class LogOverflowPolicy {
+        Block,
+        OverrunOldest,
+        DiscardNew
+    };
+
     // Main class for the server program
     class Server final {
     public:
         // Sending messages or calling check_connections is prohibited in on_client_disconnected
+        // Logging is asynchronous; messages are formatted and written by a dedicated thread
+        // Specify the maximum amount of messages waiting to be logged and what to do when there is no room
         // Throws server errors
         Server(
             std::function<void(std::shared_ptr<ClientConnection>)> on_client_connected,
             std::function<void(std::shared_ptr<ClientConnection>)> on_client_disconnected,
             unsigned int log_target,
-            const std::filesystem::path& log_file_path = "logs/rotating.log"
+            const std::filesystem::path& log_file_path = "logs/rotating.log",
+            std::size_t log_queue_size = 8192,
+            LogOverflowPolicy log_overflow_policy = LogOverflowPolicy::DiscardNew
         );
 
         ~Server();
@@ -58,9 +75,14 @@ namespace networking {
 
         // Start the internal event loop and start accepting connection requests
         // You may call this only once in the beginning or after calling stop()
-        // Specify the port number on which to listen and the maximum amount of clients allowed
+        // Specify the port number on which to listen, the maximum amount of clients allowed and
+        // the limits of the outgoing queues
         // Throws connection
-        void start(std::uint16_t port, std::uint32_t max_clients = std::numeric_limits<std::uint16_t>::max());
+        void start(
+            std::uint16_t port,
+            std::uint32_t max_clients = std::numeric_limits<std::uint16_t>::max(),
+            const OutgoingLimits& outgoing_limits = {}
+        );
 
         // Disconnect from all the clients and stop the internal event loop
         // You may call this at any time
@@ -74,6 +96,7 @@ namespace networking {
         void accept_connections();
 
         // Check the state of all connections
+        // Closes connections that have been under pressure for too long
         // Invokes on_client_disconnected() when needed
         // Throws connection errors
         void check_connections();
@@ -86,8 +109,13 @@ namespace networking {
         bool available_messages() const;
 
         // Send a message to a specific client; invokes on_client_disconnected() when needed
+        // Non-critical messages may be dropped or coalesced according to the policy
+        // Returns false, if the message was not sent
         // Throws connection errors
-        void send_message(std::shared_ptr<ClientConnection> connection, const Message& message);
+        bool send_message(std::shared_ptr<ClientConnection> connection, const Message& message, SendPolicy policy = SendPolicy::Always);
+
+        // Check if a client doesn't keep up with the messages sent to it
+        bool would_block(std::shared_ptr<ClientConnection> connection) const;
 
         // Send a message to all clients; invokes on_client_disconnected() when needed
         // Throws connection errors
@@ -99,6 +127,9 @@ namespace networking {
 
         // Get a pointer to the logger
         std::shared_ptr<spdlog::logger> get_logger() { return m_logger; }
+
+        // Get the total number of log messages lost, because the logging queue was full
+        std::size_t get_dropped_log_messages() const;
     private:
         using ConnectionsIter = std::forward_list<std::shared_ptr<ClientConnection>>::iterator;
 
@@ -106,7 +137,12 @@ namespace networking {
         void task_accept_connection();
         void maybe_client_disconnected(std::shared_ptr<ClientConnection> connection);
         void maybe_client_disconnected(std::shared_ptr<ClientConnection> connection, ConnectionsIter& iter, ConnectionsIter before_iter);
-        void initialize_logging(unsigned int log_target, const std::filesystem::path& log_file_path);
+        void initialize_logging(
+            unsigned int log_target,
+            const std::filesystem::path& log_file_path,
+            std::size_t log_queue_size,
+            LogOverflowPolicy log_overflow_policy
+        );
 
         std::forward_list<std::shared_ptr<ClientConnection>> m_connections;
         internal::SyncQueue<std::shared_ptr<ClientConnection>> m_new_connections;
@@ -120,7 +156,9 @@ namespace networking {
         std::function<void(std::shared_ptr<ClientConnection>)> m_on_client_disconnected;
 
         internal::Pool m_pool;
+        OutgoingLimits m_outgoing_limits;
         std::exception_ptr m_error;
+        std::shared_ptr<spdlog::details::thread_pool> m_log_thread_pool;
         std::shared_ptr<spdlog::logger> m_logger;
         std::shared_ptr<spdlog::sinks::stdout_color_sink_mt> m_console_sink;
         std::shared_ptr<spdlog::sinks::rotating_file_sink_mt> m_rotating_file_sink;
@@ -4,13 +4,18 @@
 #include <cstddef>
 #include <cassert>
 
-#include <boost/endian/conversion.hpp>
-
 #include "networking/internal/error.hpp"
 
 namespace networking::internal {
-    void ClientConnection::send(const Message& message) {
-        task_send_message(message);
+    bool ClientConnection::send(const Message& message, SendPolicy policy) {
+        if (policy == SendPolicy::Coalesce && would_block()) {
+            return false;
+        }
+
+        outgoing_added(message.size());
+        task_send_message(message, policy);
+
+        return true;
     }
 
     void ClientConnection::close() {
@@ -21,6 +26,24 @@ namespace networking::internal {
         return m_client_id;
     }
 
+    bool ClientConnection::would_block() const {
+        std::lock_guard lock {m_outgoing_mutex};
+
+        return m_pressure_begin.has_value();
+    }
+
+    std::size_t ClientConnection::get_outgoing_bytes() const {
+        std::lock_guard lock {m_outgoing_mutex};
+
+        return m_outgoing_bytes;
+    }
+
+    std::size_t ClientConnection::get_outgoing_messages() const {
+        std::lock_guard lock {m_outgoing_mutex};
+
+        return m_outgoing_count;
+    }
+
     void ClientConnection::start_communication() {
         task_read_header();
     }
@@ -37,12 +60,10 @@ namespace networking::internal {
     void ClientConnection::task_write_header_payload() {
         assert(!m_outgoing_messages.empty());
 
-        MsgHeader header_to_write {m_outgoing_messages.front().header};
-        boost::endian::native_to_big_inplace(header_to_write.id);
-        boost::endian::native_to_big_inplace(header_to_write.payload_size);
+        const std::size_t header_size {encode_header(m_outgoing_messages.front().header, m_outgoing_header)};
 
         std::vector<boost::asio::const_buffer> buffers;
-        buffers.emplace_back(&header_to_write, sizeof(MsgHeader));
+        buffers.emplace_back(m_outgoing_header.data(), header_size);
 
         if (m_outgoing_messages.front().header.payload_size > 0) {
             buffers.emplace_back(m_outgoing_messages.front().payload.get(), m_outgoing_messages.front().header.payload_size);
@@ -62,6 +83,7 @@ namespace networking::internal {
                 assert(bytes_transferred == size);
 
                 m_outgoing_messages.pop_front();
+                outgoing_removed(size);
 
                 // Thus writing tasks can stop
                 if (!m_outgoing_messages.empty()) {
@@ -72,7 +94,7 @@ namespace networking::internal {
     }
 
     void ClientConnection::task_read_header() {
-        boost::asio::async_read(m_tcp_socket, boost::asio::buffer(&m_incoming_message.header, sizeof(MsgHeader)),
+        boost::asio::async_read(m_tcp_socket, boost::asio::buffer(m_incoming_header.data(), COMPACT_HEADER_SIZE),
             [this](boost::system::error_code ec, [[maybe_unused]] std::size_t bytes_transferred) {
                 if (ec) {
                     m_tcp_socket.close();
@@ -81,25 +103,56 @@ namespace networking::internal {
                     return;
                 }
 
-                assert(bytes_transferred == sizeof(MsgHeader));
+                assert(bytes_transferred == COMPACT_HEADER_SIZE);
 
-                boost::endian::big_to_native_inplace(m_incoming_message.header.id);
-                boost::endian::big_to_native_inplace(m_incoming_message.header.payload_size);
+                if (decode_compact_header(m_incoming_header, m_incoming_message.header)) {
+                    task_read_extended_size();
+                } else {
+                    start_reading_payload();
+                }
+            }
+        );
+    }
 
-                // A payload may be empty
-                if (m_incoming_message.header.payload_size > 0) {
-                    // Allocate space so that we write to it later
-                    m_incoming_message.payload = std::make_unique<unsigned char[]>(m_incoming_message.header.payload_size);
+    void ClientConnection::task_read_extended_size() {
+        boost::asio::async_read(m_tcp_socket, boost::asio::buffer(m_incoming_header.data() + COMPACT_HEADER_SIZE, EXTENDED_HEADER_SIZE - COMPACT_HEADER_SIZE),
+            [this](boost::system::error_code ec, [[maybe_unused]] std::size_t bytes_transferred) {
+                if (ec) {
+                    m_tcp_socket.close();
 
-                    task_read_payload();
-                } else {
-                    add_to_incoming_messages();
-                    task_read_header();
+                    m_logger->warn("[{}] Could not read extended header: {}", get_id(), ec.message());
+                    return;
+                }
+
+                assert(bytes_transferred == EXTENDED_HEADER_SIZE - COMPACT_HEADER_SIZE);
+
+                try {
+                    decode_extended_size(m_incoming_header, m_incoming_message.header);
+                } catch (const ConnectionError& e) {
+                    m_tcp_socket.close();
+
+                    m_logger->warn("[{}] Invalid header: {}", get_id(), e.what());
+                    return;
                 }
+
+                start_reading_payload();
             }
         );
     }
 
+    void ClientConnection::start_reading_payload() {
+        // A payload may be empty
+        if (m_incoming_message.header.payload_size > 0) {
+            // Allocate space so that we write to it later
+            m_incoming_message.payload = std::make_unique<unsigned char[]>(m_incoming_message.header.payload_size);
+
+            task_read_payload();
+        } else {
+            add_to_incoming_messages();
+            task_read_header();
+        }
+    }
+
     void ClientConnection::task_read_payload() {
         boost::asio::async_read(m_tcp_socket, boost::asio::buffer(m_incoming_message.payload.get(), m_incoming_message.header.payload_size),
             [this](boost::system::error_code ec, [[maybe_unused]] std::size_t bytes_transferred) {
@@ -118,12 +171,25 @@ namespace networking::internal {
         );
     }
 
-    void ClientConnection::task_send_message(const Message& message) {
+    void ClientConnection::task_send_message(const Message& message, SendPolicy policy) {
         boost::asio::post(m_context,
-            [this, message = message]() mutable {
+            [this, message = message, policy]() mutable {
                 const bool writing_tasks_stopped {m_outgoing_messages.empty()};
 
-                m_outgoing_messages.push_back(basic_message(std::move(message)));
+                auto basic {basic_message(std::move(message))};
+
+                if (policy == SendPolicy::Coalesce) {
+                    const auto id {basic.header.id};
+
+                    // The front message may be currently in writing, so don't touch it
+                    if (m_outgoing_messages.swap_back_if(1, [id](const BasicMessage& item) { return item.header.id == id; }, basic)) {
+                        // Now the old message is in basic
+                        outgoing_removed(basic.size());
+                        return;
+                    }
+                }
+
+                m_outgoing_messages.push_back(std::move(basic));
 
                 // Restart the writing process, if it has stopped before
                 if (writing_tasks_stopped) {
@@ -132,4 +198,48 @@ namespace networking::internal {
             }
         );
     }
+
+    void ClientConnection::outgoing_added(std::size_t size) {
+        std::lock_guard lock {m_outgoing_mutex};
+
+        m_outgoing_bytes += size;
+        m_outgoing_count++;
+
+        update_pressure();
+    }
+
+    void ClientConnection::outgoing_removed(std::size_t size) {
+        std::lock_guard lock {m_outgoing_mutex};
+
+        assert(m_outgoing_bytes >= size && m_outgoing_count > 0);
+
+        m_outgoing_bytes -= size;
+        m_outgoing_count--;
+
+        update_pressure();
+    }
+
+    void ClientConnection::update_pressure() {
+        // Called with the lock held
+
+        if (!m_pressure_begin) {
+            if (m_outgoing_bytes > m_outgoing_limits.high_bytes || m_outgoing_count > m_outgoing_limits.high_messages) {
+                m_pressure_begin = std::chrono::steady_clock::now();
+            }
+        } else {
+            if (m_outgoing_bytes <= m_outgoing_limits.low_bytes && m_outgoing_count <= m_outgoing_limits.low_messages) {
+                m_pressure_begin.reset();
+            }
+        }
+    }
+
+    bool ClientConnection::pressure_exceeded(std::chrono::steady_clock::time_point now) const {
+        std::lock_guard lock {m_outgoing_mutex};
+
+        if (!m_pressure_begin) {
+            return false;
+        }
+
+        return now - *m_pressure_begin > m_outgoing_limits.max_pressure_time;
+    }
 }
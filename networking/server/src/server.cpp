@@ -1,6 +1,7 @@
 #include "networking/server.hpp"
 
 #include <string>
+#include <chrono>
 #include <stdexcept>
 #include <cassert>
 
@@ -9,23 +10,26 @@ namespace networking {
         std::function<void(std::shared_ptr<ClientConnection>)> on_client_connected,
         std::function<void(std::shared_ptr<ClientConnection>)> on_client_disconnected,
         unsigned int log_target,
-        const std::filesystem::path& log_file_path
+        const std::filesystem::path& log_file_path,
+        std::size_t log_queue_size,
+        LogOverflowPolicy log_overflow_policy
     )
         : m_acceptor(m_context), m_on_client_connected(std::move(on_client_connected)),
         m_on_client_disconnected(std::move(on_client_disconnected)) {
-        initialize_logging(log_target, log_file_path);
+        initialize_logging(log_target, log_file_path, log_queue_size, log_overflow_policy);
     }
 
     Server::~Server() {
         stop();
     }
 
-    void Server::start(std::uint16_t port, std::uint32_t max_clients) {
+    void Server::start(std::uint16_t port, std::uint32_t max_clients, const OutgoingLimits& outgoing_limits) {
         if (m_context.stopped()) {
             m_context.restart();
         }
 
         m_pool.create(max_clients);
+        m_outgoing_limits = outgoing_limits;
 
         const auto endpoint {boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), port)};
 
@@ -108,6 +112,8 @@ namespace networking {
     void Server::check_connections() {
         throw_if_error();
 
+        const auto now {std::chrono::steady_clock::now()};
+
         for (auto before_iter {m_connections.before_begin()}, iter {m_connections.begin()}; iter != m_connections.end();) {
             const auto& connection {*iter};
 
@@ -118,6 +124,18 @@ namespace networking {
                 continue;
             }
 
+            // The connection is dealt with in the next check
+            if (connection->pressure_exceeded(now)) {
+                m_logger->warn(
+                    "[{}] Closing slow connection ({} bytes, {} messages pending)",
+                    connection->get_id(),
+                    connection->get_outgoing_bytes(),
+                    connection->get_outgoing_messages()
+                );
+
+                connection->close();
+            }
+
             before_iter++, iter++;
         }
     }
@@ -130,17 +148,23 @@ namespace networking {
         return !m_incoming_messages.empty();
     }
 
-    void Server::send_message(std::shared_ptr<ClientConnection> connection, const Message& message) {
+    bool Server::send_message(std::shared_ptr<ClientConnection> connection, const Message& message, SendPolicy policy) {
         throw_if_error();
 
         assert(connection != nullptr);
 
         if (!connection->is_open()) {
             maybe_client_disconnected(connection);
-            return;
+            return false;
         }
 
-        connection->send(message);
+        return connection->send(message, policy);
+    }
+
+    bool Server::would_block(std::shared_ptr<ClientConnection> connection) const {
+        assert(connection != nullptr);
+
+        return connection->would_block();
     }
 
     void Server::send_message_all(const Message& message) {
@@ -185,6 +209,14 @@ namespace networking {
         }
     }
 
+    std::size_t Server::get_dropped_log_messages() const {
+#ifdef NM3D_SPDLOG_NO_DISCARD_NEW
+        return m_log_thread_pool->overrun_counter();
+#else
+        return m_log_thread_pool->overrun_counter() + m_log_thread_pool->discard_counter();
+#endif
+    }
+
     void Server::throw_if_error() {
         if (!m_error) {
             return;
@@ -222,7 +254,8 @@ namespace networking {
                                 std::move(socket),
                                 m_incoming_messages,
                                 *new_id,
-                                m_logger
+                                m_logger,
+                                m_outgoing_limits
                             )
                         );
                     }
@@ -259,10 +292,36 @@ namespace networking {
         m_pool.free_id(connection->get_id());
     }
 
-    void Server::initialize_logging(unsigned int log_target, const std::filesystem::path& log_file_path) {
-        m_logger = std::make_shared<spdlog::logger>("ServerLogger");
+    void Server::initialize_logging(
+        unsigned int log_target,
+        const std::filesystem::path& log_file_path,
+        std::size_t log_queue_size,
+        LogOverflowPolicy log_overflow_policy
+    ) {
+        spdlog::async_overflow_policy policy {};
+
+        switch (log_overflow_policy) {
+            case LogOverflowPolicy::Block:
+                policy = spdlog::async_overflow_policy::block;
+                break;
+            case LogOverflowPolicy::OverrunOldest:
+                policy = spdlog::async_overflow_policy::overrun_oldest;
+                break;
+            case LogOverflowPolicy::DiscardNew:
+#ifdef NM3D_SPDLOG_NO_DISCARD_NEW
+                policy = spdlog::async_overflow_policy::overrun_oldest;  // Closest one that doesn't block either
+#else
+                policy = spdlog::async_overflow_policy::discard_new;
+#endif
+                break;
+        }
 
         try {
+            // The queue is a fixed size ring buffer; one thread does all the formatting and writing,
+            // so that the network thread only ever enqueues messages
+            m_log_thread_pool = std::make_shared<spdlog::details::thread_pool>(log_queue_size, 1);
+            m_logger = std::make_shared<spdlog::async_logger>("ServerLogger", spdlog::sinks_init_list(), m_log_thread_pool, policy);
+
             if (log_target & LogTargetConsole) {
                 m_console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
                 m_console_sink->set_pattern("%^[%l] [%H:%M:%S]%$ %v");
@@ -0,0 +1,377 @@
+#include <iostream>
+#include <random>
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <initializer_list>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+
+#include <networking/client.hpp>
+#include <networking/server.hpp>
+#include <networking/internal/message.hpp>
+
+// Feeds malformed headers through the decoder and through the read paths of a client and of a server
+// Both must either reject them or close the connection; they must never deliver a message
+// The seed is taken from the first argument or from NM3D_TEST_SEED; otherwise it's random
+
+using namespace networking::internal;
+
+static int g_failures {0};
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << __FILE__ << ':' << __LINE__ << ": Check failed: " #condition "\n"; \
+            g_failures++; \
+        } \
+    } while (false)
+
+static constexpr auto READ_TIMEOUT {std::chrono::seconds(5)};
+
+static HeaderBuffer compact_header(std::uint16_t id, std::uint16_t size) {
+    HeaderBuffer buffer {};
+    buffer[0] = static_cast<unsigned char>(id >> 8);
+    buffer[1] = static_cast<unsigned char>(id);
+    buffer[2] = static_cast<unsigned char>(size >> 8);
+    buffer[3] = static_cast<unsigned char>(size);
+
+    return buffer;
+}
+
+static HeaderBuffer extended_header(std::uint16_t id, std::uint32_t size) {
+    HeaderBuffer buffer {compact_header(id, EXTENDED_SIZE_MARK)};
+    buffer[4] = static_cast<unsigned char>(size >> 24);
+    buffer[5] = static_cast<unsigned char>(size >> 16);
+    buffer[6] = static_cast<unsigned char>(size >> 8);
+    buffer[7] = static_cast<unsigned char>(size);
+
+    return buffer;
+}
+
+// Return true, if the header is accepted
+static bool decode(const HeaderBuffer& buffer, MsgHeader& header) {
+    if (!decode_compact_header(buffer, header)) {
+        return true;
+    }
+
+    try {
+        decode_extended_size(buffer, header);
+    } catch (const ConnectionError&) {
+        return false;
+    }
+
+    return true;
+}
+
+static void test_round_trip(std::mt19937& random) {
+    std::uniform_int_distribution<std::uint32_t> size_distribution {0, static_cast<std::uint32_t>(MAX_PAYLOAD_SIZE)};
+    std::uniform_int_distribution<std::uint32_t> id_distribution {0, 0xFFFF};
+
+    for (int i {0}; i < 10000; i++) {
+        const MsgHeader header {static_cast<std::uint16_t>(id_distribution(random)), size_distribution(random)};
+
+        HeaderBuffer buffer {};
+        const std::size_t size {encode_header(header, buffer)};
+
+        CHECK(size == header_size(header.payload_size));
+
+        MsgHeader decoded;
+        CHECK(decode(buffer, decoded));
+        CHECK(decoded.id == header.id);
+        CHECK(decoded.payload_size == header.payload_size);
+    }
+
+    // The edges
+    for (const std::uint32_t payload_size : {0u, std::uint32_t(MAX_COMPACT_PAYLOAD_SIZE), std::uint32_t(MAX_COMPACT_PAYLOAD_SIZE + 1), std::uint32_t(MAX_PAYLOAD_SIZE)}) {
+        HeaderBuffer buffer {};
+        encode_header(MsgHeader {1, payload_size}, buffer);
+
+        MsgHeader decoded;
+        CHECK(decode(buffer, decoded));
+        CHECK(decoded.payload_size == payload_size);
+    }
+}
+
+static void test_random_headers(std::mt19937& random) {
+    std::uniform_int_distribution<unsigned int> byte_distribution {0, 0xFF};
+
+    for (int i {0}; i < 100000; i++) {
+        HeaderBuffer buffer {};
+
+        for (unsigned char& byte : buffer) {
+            byte = static_cast<unsigned char>(byte_distribution(random));
+        }
+
+        // Make the extended header more likely
+        if (i % 2 == 0) {
+            buffer[2] = 0xFF;
+            buffer[3] = 0xFF;
+        }
+
+        MsgHeader header;
+
+        if (!decode(buffer, header)) {
+            continue;
+        }
+
+        // Whatever is accepted must be within the limits and in canonical form
+        CHECK(header.payload_size <= MAX_PAYLOAD_SIZE);
+
+        HeaderBuffer encoded {};
+        const std::size_t size {encode_header(header, encoded)};
+
+        for (std::size_t j {0}; j < size; j++) {
+            CHECK(encoded[j] == buffer[j]);
+        }
+    }
+}
+
+static void test_invalid_headers() {
+    MsgHeader header;
+
+    // Non-canonical
+    CHECK(!decode(extended_header(1, 0), header));
+    CHECK(!decode(extended_header(1, 1), header));
+    CHECK(!decode(extended_header(1, std::uint32_t(MAX_COMPACT_PAYLOAD_SIZE)), header));
+
+    // Oversized
+    CHECK(!decode(extended_header(1, std::uint32_t(MAX_PAYLOAD_SIZE + 1)), header));
+    CHECK(!decode(extended_header(1, 0xFFFFFFFF), header));
+}
+
+// Serve the bytes to a client and check that it closes the connection without delivering any message
+static void test_read_path(const std::vector<unsigned char>& bytes, bool close_after_writing) {
+    boost::asio::io_context context;
+    boost::asio::ip::tcp::acceptor acceptor {context, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)};
+
+    networking::Client client;
+    client.connect("127.0.0.1", acceptor.local_endpoint().port());
+
+    boost::asio::ip::tcp::socket socket {context};
+    acceptor.accept(socket);
+
+    boost::asio::write(socket, boost::asio::buffer(bytes));
+
+    if (close_after_writing) {
+        socket.close();
+    }
+
+    bool closed {false};
+    const auto begin {std::chrono::steady_clock::now()};
+
+    while (std::chrono::steady_clock::now() - begin < READ_TIMEOUT) {
+        try {
+            client.connection_established();
+        } catch (const ConnectionError&) {
+            closed = true;
+            break;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    CHECK(closed);
+    CHECK(!client.available_messages());
+}
+
+static std::vector<unsigned char> header_bytes(const HeaderBuffer& buffer, std::size_t size) {
+    return std::vector<unsigned char>(buffer.begin(), buffer.begin() + size);
+}
+
+static void test_read_path_invalid_headers() {
+    // Rejected while the peer is still connected
+    test_read_path(header_bytes(extended_header(1, 16), EXTENDED_HEADER_SIZE), false);
+    test_read_path(header_bytes(extended_header(1, std::uint32_t(MAX_COMPACT_PAYLOAD_SIZE)), EXTENDED_HEADER_SIZE), false);
+    test_read_path(header_bytes(extended_header(1, std::uint32_t(MAX_PAYLOAD_SIZE + 1)), EXTENDED_HEADER_SIZE), false);
+    test_read_path(header_bytes(extended_header(1, 0xFFFFFFFF), EXTENDED_HEADER_SIZE), false);
+
+    // Truncated
+    test_read_path(header_bytes(compact_header(1, 16), 2), true);
+    test_read_path(header_bytes(extended_header(1, std::uint32_t(MAX_COMPACT_PAYLOAD_SIZE + 1)), 6), true);
+    test_read_path(header_bytes(compact_header(1, 16), COMPACT_HEADER_SIZE), true);  // Without the payload
+}
+
+static void test_read_path_valid_header() {
+    // Control case; a valid message must get through
+    boost::asio::io_context context;
+    boost::asio::ip::tcp::acceptor acceptor {context, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)};
+
+    networking::Client client;
+    client.connect("127.0.0.1", acceptor.local_endpoint().port());
+
+    boost::asio::ip::tcp::socket socket {context};
+    acceptor.accept(socket);
+
+    const std::uint32_t payload_size {std::uint32_t(MAX_COMPACT_PAYLOAD_SIZE + 1)};
+    std::vector<unsigned char> bytes {header_bytes(extended_header(7, payload_size), EXTENDED_HEADER_SIZE)};
+    bytes.resize(bytes.size() + payload_size);
+
+    boost::asio::write(socket, boost::asio::buffer(bytes));
+
+    const auto begin {std::chrono::steady_clock::now()};
+
+    while (!client.available_messages() && std::chrono::steady_clock::now() - begin < READ_TIMEOUT) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    CHECK(client.available_messages());
+
+    if (client.available_messages()) {
+        const networking::Message message {client.next_message()};
+        CHECK(message.id() == 7);
+        CHECK(message.size() == EXTENDED_HEADER_SIZE + payload_size);
+    }
+}
+
+// Find a port that is free at the moment
+static std::uint16_t free_port() {
+    boost::asio::io_context context;
+    boost::asio::ip::tcp::acceptor acceptor {context, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)};
+
+    return acceptor.local_endpoint().port();
+}
+
+static networking::Message message_of_size(std::uint16_t id, std::uint32_t payload_size) {
+    return networking::Message(MsgHeader {id, payload_size}, std::make_unique<unsigned char[]>(payload_size));
+}
+
+// Send messages of the edge sizes to a server and back and check that they arrive unchanged
+static void test_server_round_trip() {
+    networking::Server server {[](auto) {}, [](auto) {}, networking::LogTargetNone};
+
+    const std::uint16_t port {free_port()};
+    server.start(port);
+
+    networking::Client client;
+    client.connect("127.0.0.1", port);
+
+    const auto begin {std::chrono::steady_clock::now()};
+
+    while (!client.connection_established() && std::chrono::steady_clock::now() - begin < READ_TIMEOUT) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    for (const std::uint32_t payload_size : {0u, std::uint32_t(MAX_COMPACT_PAYLOAD_SIZE), std::uint32_t(MAX_COMPACT_PAYLOAD_SIZE + 1), std::uint32_t(MAX_PAYLOAD_SIZE)}) {
+        const std::uint16_t id {static_cast<std::uint16_t>(payload_size % 0xFFFF)};
+
+        client.send_message(message_of_size(id, payload_size));
+
+        const auto begin {std::chrono::steady_clock::now()};
+
+        while (!server.available_messages() && std::chrono::steady_clock::now() - begin < READ_TIMEOUT) {
+            server.accept_connections();
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        CHECK(server.available_messages());
+
+        if (!server.available_messages()) {
+            continue;
+        }
+
+        const auto [connection, message] {server.next_message()};
+        CHECK(message.id() == id);
+        CHECK(message.size() == header_size(payload_size) + payload_size);
+
+        // And back to the client
+        server.send_message(connection, message);
+
+        while (!client.available_messages() && std::chrono::steady_clock::now() - begin < READ_TIMEOUT) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        CHECK(client.available_messages());
+
+        if (client.available_messages()) {
+            const networking::Message echo {client.next_message()};
+            CHECK(echo.id() == id);
+            CHECK(echo.size() == header_size(payload_size) + payload_size);
+        }
+    }
+}
+
+// Send the bytes to a server and check that it closes the connection without delivering any message
+static void test_server_read_path(const std::vector<unsigned char>& bytes, bool close_after_writing) {
+    bool disconnected {false};
+    networking::Server server {[](auto) {}, [&](auto) { disconnected = true; }, networking::LogTargetNone};
+
+    const std::uint16_t port {free_port()};
+    server.start(port);
+
+    boost::asio::io_context context;
+    boost::asio::ip::tcp::socket socket {context};
+    socket.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), port));
+
+    boost::asio::write(socket, boost::asio::buffer(bytes));
+
+    if (close_after_writing) {
+        socket.close();
+    }
+
+    const auto begin {std::chrono::steady_clock::now()};
+
+    while (!disconnected && std::chrono::steady_clock::now() - begin < READ_TIMEOUT) {
+        server.accept_connections();
+        server.check_connections();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    CHECK(disconnected);
+    CHECK(!server.available_messages());
+}
+
+static void test_server_read_path_invalid_headers() {
+    // Rejected while the peer is still connected
+    test_server_read_path(header_bytes(extended_header(1, 16), EXTENDED_HEADER_SIZE), false);
+    test_server_read_path(header_bytes(extended_header(1, std::uint32_t(MAX_COMPACT_PAYLOAD_SIZE)), EXTENDED_HEADER_SIZE), false);
+    test_server_read_path(header_bytes(extended_header(1, std::uint32_t(MAX_PAYLOAD_SIZE + 1)), EXTENDED_HEADER_SIZE), false);
+    test_server_read_path(header_bytes(extended_header(1, 0xFFFFFFFF), EXTENDED_HEADER_SIZE), false);
+
+    // Truncated
+    test_server_read_path(header_bytes(compact_header(1, 16), 2), true);
+    test_server_read_path(header_bytes(extended_header(1, std::uint32_t(MAX_COMPACT_PAYLOAD_SIZE + 1)), 6), true);
+    test_server_read_path(header_bytes(compact_header(1, 16), COMPACT_HEADER_SIZE), true);  // Without the payload
+}
+
+static unsigned int seed_from(int argc, char** argv) {
+    const char* string {argc > 1 ? argv[1] : std::getenv("NM3D_TEST_SEED")};
+
+    if (string != nullptr) {
+        try {
+            return static_cast<unsigned int>(std::stoul(string));
+        } catch (const std::logic_error&) {
+            std::cerr << "Invalid seed: " << string << '\n';
+        }
+    }
+
+    return std::random_device()();
+}
+
+int main(int argc, char** argv) {
+    const unsigned int seed {seed_from(argc, argv)};
+    std::cout << "Seed: " << seed << '\n';
+
+    std::mt19937 random {seed};
+
+    test_round_trip(random);
+    test_random_headers(random);
+    test_invalid_headers();
+    test_read_path_invalid_headers();
+    test_read_path_valid_header();
+    test_server_round_trip();
+    test_server_read_path_invalid_headers();
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "All checks passed\n";
+    return EXIT_SUCCESS;
+}
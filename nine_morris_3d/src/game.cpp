@@ -6,6 +6,10 @@
 
 #include "nine_morris_3d_engine/external/resmanager.h++"
 
+// Enough for the board textures and one skybox at full quality, both decoded and on the GPU
+// Switching skyboxes goes over it, so the least recently used resources, usually of the previous skybox, are dropped
+static constexpr std::size_t RESOURCES_MEMORY_BUDGET {384 * 1024 * 1024};
+
 void game_start(sm::Ctx& ctx) {
     auto& g {ctx.global<Global>()};
 
@@ -37,18 +41,21 @@ void game_start(sm::Ctx& ctx) {
         ctx.set_window_size(DEFAULT_WIDTH_LARGE, DEFAULT_HEIGHT_LARGE);
     }
 
-    sm::TexturePostProcessing post_processing;
-    post_processing.flip = false;
+    // Nobody sees the icons without a window; don't bother decoding them
+    if (!ctx.is_window_headless()) {
+        sm::TexturePostProcessing post_processing;
+        post_processing.flip = false;
 
-    ctx.set_window_icons(
-        {
-            std::make_unique<sm::TextureData>(sm::utils::read_file(ctx.path_assets("icons/32x32/nine_morris_3d.png")), post_processing),
-            std::make_unique<sm::TextureData>(sm::utils::read_file(ctx.path_assets("icons/64x64/nine_morris_3d.png")), post_processing),
-            std::make_unique<sm::TextureData>(sm::utils::read_file(ctx.path_assets("icons/128x128/nine_morris_3d.png")), post_processing),
-            std::make_unique<sm::TextureData>(sm::utils::read_file(ctx.path_assets("icons/256x256/nine_morris_3d.png")), post_processing),
-            std::make_unique<sm::TextureData>(sm::utils::read_file(ctx.path_assets("icons/512x512/nine_morris_3d.png")), post_processing)
-        }
-    );
+        ctx.set_window_icons(
+            {
+                std::make_unique<sm::TextureData>(sm::utils::read_file(ctx.path_assets("icons/32x32/nine_morris_3d.png")), post_processing),
+                std::make_unique<sm::TextureData>(sm::utils::read_file(ctx.path_assets("icons/64x64/nine_morris_3d.png")), post_processing),
+                std::make_unique<sm::TextureData>(sm::utils::read_file(ctx.path_assets("icons/128x128/nine_morris_3d.png")), post_processing),
+                std::make_unique<sm::TextureData>(sm::utils::read_file(ctx.path_assets("icons/256x256/nine_morris_3d.png")), post_processing),
+                std::make_unique<sm::TextureData>(sm::utils::read_file(ctx.path_assets("icons/512x512/nine_morris_3d.png")), post_processing)
+            }
+        );
+    }
 
     // We said earlier to not initialize the renderer with default parameters
     sm::RendererSpecification specification;
@@ -57,6 +64,8 @@ void game_start(sm::Ctx& ctx) {
     specification.shadow_map_size = g.options.shadow_quality;
 
     ctx.initialize_renderer(specification);
+
+    ctx.set_resources_memory_budget(RESOURCES_MEMORY_BUDGET);
 }
 
 void game_stop(sm::Ctx& ctx) {
@@ -51,6 +51,7 @@ public:
     virtual PlayerColor get_player_color() const = 0;
     virtual bool is_turn_finished() const = 0;
     virtual void setup_pieces(bool animate = true) = 0;
+    virtual void cancel_user_move() = 0;
 
     void user_click_press();
     void user_click_release();
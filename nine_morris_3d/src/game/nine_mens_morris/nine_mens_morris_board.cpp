@@ -334,6 +334,12 @@ void NineMensMorrisBoard::setup_pieces(bool animate) {
     }
 }
 
+void NineMensMorrisBoard::cancel_user_move() {
+    // Any piece placed or moved visually is put back by setup_pieces()
+    m_capture_piece = false;
+    m_select_id = -1;
+}
+
 void NineMensMorrisBoard::update(sm::Ctx& ctx, glm::vec3 ray, glm::vec3 camera, bool user_input) {
     if (user_input) {
         update_hover_id(ray, camera, [this]() {
@@ -614,6 +620,63 @@ std::string NineMensMorrisBoard::move_to_string(const Move& move) {
     return result;
 }
 
+NineMensMorrisBoard::Move NineMensMorrisBoard::move_from_protocol(protocol::Move move) {
+    const int index1 {protocol::move_index(move, 0)};
+    const int index2 {protocol::move_index(move, 1)};
+    const int index3 {protocol::move_index(move, 2)};
+
+    if (index1 >= NODES || index2 >= NODES || index3 >= NODES) {
+        throw BoardError("Invalid move encoding");
+    }
+
+    switch (protocol::move_type(move)) {
+        case protocol::MoveType::Place:
+            return Move::create_place(index1);
+        case protocol::MoveType::PlaceCapture:
+            return Move::create_place_capture(index1, index2);
+        case protocol::MoveType::Move:
+            return Move::create_move(index1, index2);
+        case protocol::MoveType::MoveCapture:
+            return Move::create_move_capture(index1, index2, index3);
+    }
+
+    throw BoardError("Invalid move encoding");
+}
+
+protocol::Move NineMensMorrisBoard::move_to_protocol(const Move& move) {
+    protocol::Move result {};
+
+    switch (move.type) {
+        case MoveType::Place:
+            result = protocol::encode_move(protocol::MoveType::Place, move.place.place_index);
+            break;
+        case MoveType::PlaceCapture:
+            result = protocol::encode_move(
+                protocol::MoveType::PlaceCapture,
+                move.place_capture.place_index,
+                move.place_capture.capture_index
+            );
+            break;
+        case MoveType::Move:
+            result = protocol::encode_move(
+                protocol::MoveType::Move,
+                move.move.source_index,
+                move.move.destination_index
+            );
+            break;
+        case MoveType::MoveCapture:
+            result = protocol::encode_move(
+                protocol::MoveType::MoveCapture,
+                move.move_capture.source_index,
+                move.move_capture.destination_index,
+                move.move_capture.capture_index
+            );
+            break;
+    }
+
+    return result;
+}
+
 NineMensMorrisBoard::Position NineMensMorrisBoard::position_from_string(const std::string& string) {
     const std::regex re {R"(^(w|b):(w|b)([a-g][1-7])?(,[a-g][1-7])*:(w|b)([a-g][1-7])?(,[a-g][1-7])*:[0-9]{1,3}$)"};
 
@@ -817,7 +880,7 @@ void NineMensMorrisBoard::update_nodes_highlight(std::function<bool()>&& highlig
 void NineMensMorrisBoard::update_pieces_highlight(std::function<bool(const PieceObj&)>&& highlight, bool enabled) {
     if (!enabled) {
         for (PieceObj& piece : m_pieces) {
-            piece.get_model()->get_material()->set_vec3("u_highlight_color"_H, glm::vec3(0.0f));
+            piece.get_model()->highlight_color = glm::vec3(0.0f);
         }
 
         return;
@@ -825,9 +888,9 @@ void NineMensMorrisBoard::update_pieces_highlight(std::function<bool(const Piece
 
     for (PieceObj& piece : m_pieces) {
         if (piece.get_id() == m_hover_id && highlight(piece)) {
-            piece.get_model()->get_material()->set_vec3("u_highlight_color"_H, glm::vec3(0.1f));
+            piece.get_model()->highlight_color = glm::vec3(0.1f);
         } else {
-            piece.get_model()->get_material()->set_vec3("u_highlight_color"_H, glm::vec3(0.0f));
+            piece.get_model()->highlight_color = glm::vec3(0.0f);
         }
     }
 
@@ -836,7 +899,7 @@ void NineMensMorrisBoard::update_pieces_highlight(std::function<bool(const Piece
         const int piece_id {m_nodes[m_select_id].piece_id};
 
         if (piece_id != -1) {
-            m_pieces[PIECE(piece_id)].get_model()->get_material()->set_vec3("u_highlight_color"_H, glm::vec3(0.175f));
+            m_pieces[PIECE(piece_id)].get_model()->highlight_color = glm::vec3(0.175f);
         }
     }
 }
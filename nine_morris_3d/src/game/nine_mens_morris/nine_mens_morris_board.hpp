@@ -6,6 +6,7 @@
 #include <string>
 
 #include <nine_morris_3d_engine/nine_morris_3d.hpp>
+#include <protocol.hpp>
 
 #include "game/board.hpp"
 #include "game/nine_mens_morris/node.hpp"
@@ -110,6 +111,7 @@ public:
     PlayerColor get_player_color() const override;
     bool is_turn_finished() const override;
     void setup_pieces(bool animate = true) override;
+    void cancel_user_move() override;
 
     Player get_player() const { return m_position.player; }
     const Position& setup_position() const { return m_setup_position; }
@@ -130,6 +132,8 @@ public:
 
     static Move move_from_string(const std::string& string);
     static std::string move_to_string(const Move& move);
+    static Move move_from_protocol(protocol::Move move);
+    static protocol::Move move_to_protocol(const Move& move);
     static Position position_from_string(const std::string& string);
     static std::string position_to_string(const Position& position);
 
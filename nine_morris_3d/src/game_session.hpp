@@ -18,6 +18,7 @@ public:
     bool get_remote_joined() const { return m_remote_joined; }
     bool get_remote_offered_draw() const { return m_remote_offered_draw; }
     bool set_remote_offered_draw(bool remote_offered_draw) { return m_remote_offered_draw = remote_offered_draw; }
+    const protocol::Messages& get_messages() const { return m_messages; }
     void set_messages(const protocol::Messages& messages) { m_messages = messages; }
 
     void remote_joined(const std::string& player_name);
@@ -11,6 +11,7 @@
 #include "scenes/loading_scene.hpp"
 #include "scenes/nine_mens_morris_scene.hpp"
 #include "scenes/twelve_mens_morris_scene.hpp"
+#include "scenes/benchmark_scene.hpp"
 #include "game.hpp"
 #include "global.hpp"
 #include "window_size.hpp"
@@ -20,11 +21,12 @@ struct Paths {
     std::filesystem::path logs;
     std::filesystem::path saved_data;
     std::filesystem::path assets;
+    std::filesystem::path baked_assets;
 };
 
 static void get_paths([[maybe_unused]] Paths& paths) {
 #ifndef SM_BUILD_DISTRIBUTION
-    return;
+    paths.baked_assets = NM3D_BAKED_ASSETS_DIRECTORY;
 #else
 
 #if defined(SM_PLATFORM_LINUX)
@@ -40,10 +42,12 @@ static void get_paths([[maybe_unused]] Paths& paths) {
     paths.saved_data = home / "Documents\\Nine Morris 3D";
 #endif
 
+    paths.baked_assets = paths.assets;  // Exported together with the other assets
+
 #endif  // SM_BUILD_DISTRIBUTION
 }
 
-static int game() {
+static int game(bool benchmark) {
     Paths paths;
 
     try {
@@ -66,10 +70,16 @@ static int game() {
     properties.path_logs = paths.logs;
     properties.path_saved_data = paths.saved_data;
     properties.path_assets = paths.assets;
+    properties.path_baked_assets = paths.baked_assets;
     properties.build_date = __DATE__;
     properties.build_time = __TIME__;
     properties.default_renderer_parameters = false;
 
+    if (benchmark) {
+        properties.headless = true;
+        properties.max_frames = 1000;  // In case the benchmark doesn't finish by itself
+    }
+
     sm::UserFunctions functions;
     functions.start = game_start;
     functions.stop = game_stop;
@@ -79,8 +89,9 @@ static int game() {
         game.add_scene<LoadingScene>();
         game.add_scene<NineMensMorrisScene>();
         game.add_scene<TwelveMensMorrisScene>();
+        game.add_scene<BenchmarkScene>();
         game.set_global_data<Global>();
-        game.run("loading"_H, functions);
+        game.run(benchmark ? "benchmark"_H : "loading"_H, functions);
     } catch (const sm::RuntimeError& e) {
         std::cerr << "Terminated game with error: " << e.type() << ": " << e.what() << '\n';
         return 1;
@@ -106,9 +117,16 @@ static void crash_handler(int) {
 int sm_application_main(int argc, char** argv) {
     // argv can be empty; avoid an infinite loop
     if (argc == 0 || argc > 1 && std::strcmp(argv[1], "--game") == 0) {
-        return game();
+        return game(false);
     }
 
+#ifndef SM_BUILD_DISTRIBUTION
+    // Measure the scene graph offscreen, without the crash handler
+    if (argc > 1 && std::strcmp(argv[1], "--benchmark") == 0) {
+        return game(true);
+    }
+#endif
+
 #ifdef SM_BUILD_DISTRIBUTION
 
 #ifdef SM_PLATFORM_WINDOWS
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <filesystem>
+#include <string>
 #include <vector>
 #include <utility>
 #include <stdexcept>
@@ -14,6 +15,9 @@
 
 using namespace sm::localization_literals;
 
+// Moves with player's time after the move attached
+using TimedMoves = std::vector<std::pair<std::string, protocol::ClockTime>>;
+
 struct SavedGame {
     enum class GameType {
         Local,
@@ -31,7 +35,7 @@ struct SavedGame {
     GameType game_type {};
     Ending ending {};
     std::string initial_position;
-    protocol::Moves moves;
+    TimedMoves moves;
     std::time_t game_time;  // The time when the game has finished
 
     template<typename Archive>
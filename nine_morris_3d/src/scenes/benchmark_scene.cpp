@@ -0,0 +1,125 @@
+#include "scenes/benchmark_scene.hpp"
+
+#include <utility>
+
+static constexpr unsigned int GROUPS {16};
+static constexpr unsigned int MODELS_PER_GROUP {256};
+static constexpr unsigned int FRAMES_PER_PHASE {300};
+
+void BenchmarkScene::on_start() {
+    ctx.render_3d()->camera.set_position_orientation(glm::vec3(0.0f, 40.0f, 40.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    ctx.render_3d()->camera.set_projection(ctx.get_window_width(), ctx.get_window_height(), 45.0f, 1.0f, 200.0f);
+
+    setup_models();
+
+    LOG_INFO("Benchmarking scene graph with {} models...", GROUPS * MODELS_PER_GROUP);
+}
+
+void BenchmarkScene::on_stop() {
+    m_groups.clear();
+    m_models.clear();
+}
+
+void BenchmarkScene::on_update() {
+    if (m_frames == FRAMES_PER_PHASE) {
+        next_phase();
+    }
+
+    if (m_phase == Phase::Done) {
+        return;
+    }
+
+    animate_models();
+
+    // Rendering is left out; it costs the same in both phases and would hide the difference
+    const auto begin {std::chrono::steady_clock::now()};
+
+    if (m_phase == Phase::Rebuilt) {
+        add_models();
+    }
+
+    update_transforms();
+
+    m_phase_time += std::chrono::steady_clock::now() - begin;
+    m_frames++;
+}
+
+void BenchmarkScene::setup_models() {
+    const auto mesh {ctx.load_mesh(ctx.path_baked_assets("nine_mens_morris/node.mesh"))};
+    const auto vertex_array {ctx.load_vertex_array("benchmark_node"_H, mesh)};
+    const auto material {ctx.load_material(sm::MaterialType::Phong)};
+
+    const auto material_instance {ctx.load_material_instance("benchmark_node"_H, material)};
+    material_instance->set_vec3("u_material.ambient_diffuse"_H, glm::vec3(0.5f));
+    material_instance->set_vec3("u_material.specular"_H, glm::vec3(0.05f));
+    material_instance->set_float("u_material.shininess"_H, 8.0f);
+
+    for (unsigned int i {0}; i < GROUPS; i++) {
+        const auto group {std::make_shared<sm::ModelNode>(mesh, vertex_array, material_instance)};
+        group->position = glm::vec3(static_cast<float>(i % 4) * 16.0f - 24.0f, 0.0f, static_cast<float>(i / 4) * 16.0f - 24.0f);
+
+        std::vector<std::shared_ptr<sm::ModelNode>> models;
+
+        for (unsigned int j {0}; j < MODELS_PER_GROUP; j++) {
+            const auto model {std::make_shared<sm::ModelNode>(mesh, vertex_array, material_instance)};
+            model->position = glm::vec3(static_cast<float>(j % 16) - 7.5f, 0.0f, static_cast<float>(j / 16) - 7.5f);
+            model->scale = 0.5f;
+
+            models.push_back(model);
+        }
+
+        m_groups.push_back(group);
+        m_models.push_back(std::move(models));
+    }
+}
+
+void BenchmarkScene::add_models() {
+    // Children are cleared recursively, so the whole graph has to be rebuilt
+    for (std::size_t i {0}; i < m_groups.size(); i++) {
+        for (const auto& model : m_models[i]) {
+            m_groups[i]->add_node(model);
+        }
+
+        ctx.render_3d()->add_node(m_groups[i]);
+    }
+}
+
+void BenchmarkScene::animate_models() {
+    // Only one group moves, so the rest of the transforms stay valid
+    m_groups[0]->rotation.y += 1.0f;
+}
+
+void BenchmarkScene::update_transforms() {
+    // This traversal updates the world transforms on the way; the renderer then finds them up to date
+    ctx.render_3d()->traverse([](const sm::SceneNode3D*, sm::Context3D&) {
+        return false;
+    });
+}
+
+void BenchmarkScene::next_phase() {
+    const auto milliseconds {std::chrono::duration<double, std::milli>(m_phase_time).count()};
+
+    switch (m_phase) {
+        case Phase::Rebuilt:
+            LOG_INFO("Rebuilt graph: {:.3f} ms per frame", milliseconds / FRAMES_PER_PHASE);
+
+            // The graph was cleared after the last frame; build it once more
+            add_models();
+            ctx.render_3d()->retained = true;
+            m_phase = Phase::Retained;
+
+            break;
+        case Phase::Retained:
+            LOG_INFO("Retained graph: {:.3f} ms per frame", milliseconds / FRAMES_PER_PHASE);
+
+            ctx.running = false;
+            m_phase = Phase::Done;
+
+            break;
+        case Phase::Done:
+            break;
+    }
+
+    m_frames = 0;
+    m_phase_time = {};
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <chrono>
+
+#include <nine_morris_3d_engine/nine_morris_3d.hpp>
+
+// Scene used only for measuring the cost of the scene graph
+// It times the traversal and the transform update of thousands of models, but not their rendering,
+// first rebuilding the graph every frame and then retaining it
+class BenchmarkScene : public sm::ApplicationScene {
+public:
+    explicit BenchmarkScene(sm::Ctx& ctx)
+        : sm::ApplicationScene(ctx) {}
+
+    SM_SCENE_NAME("benchmark")
+
+    void on_start() override;
+    void on_stop() override;
+    void on_update() override;
+private:
+    enum class Phase {
+        Rebuilt,
+        Retained,
+        Done
+    };
+
+    void setup_models();
+    void add_models();
+    void animate_models();
+    void update_transforms();
+    void next_phase();
+
+    std::vector<std::shared_ptr<sm::ModelNode>> m_groups;
+    std::vector<std::vector<std::shared_ptr<sm::ModelNode>>> m_models;  // Children of every group
+    Phase m_phase {Phase::Rebuilt};
+    unsigned int m_frames {};
+    std::chrono::steady_clock::duration m_phase_time {};
+};
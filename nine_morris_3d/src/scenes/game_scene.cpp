@@ -160,45 +160,31 @@ void GameScene::on_imgui_update() {
 }
 
 void GameScene::reload_and_set_skybox() {
-    ctx.add_task_async([this](sm::AsyncTask& task) {
-        try {
-            reload_skybox_texture_data();
-        } catch (const sm::RuntimeError&) {
-            task.set_done(std::current_exception());
-            return;
-        }
-
-        ctx.add_task_immediate([this]() {
-            setup_skybox(true);
-            setup_lights();
-            m_ui.set_loading_skybox_done();
+    const sm::Job skybox {ctx.add_job([this]() {
+        reload_skybox_texture_data();
+    })};
 
-            return sm::Task::Result::Done;
-        });
-
-        task.set_done();
-    });
+    ctx.add_job_main([this]() {
+        setup_skybox(true);
+        setup_lights();
+        m_ui.set_loading_skybox_done();
+    }, {skybox});
 }
 
 void GameScene::reload_and_set_textures() {
-    ctx.add_task_async([this](sm::AsyncTask& task) {
-        try {
-            reload_skybox_texture_data();
-            reload_scene_texture_data();
-        } catch (const sm::RuntimeError&) {
-            task.set_done(std::current_exception());
-            return;
-        }
-
-        ctx.add_task_immediate([this]() {
-            setup_skybox(true);
-            reload_and_set_scene_textures();
+    // The skybox and the scene textures are decoded in parallel
+    const sm::Job skybox {ctx.add_job([this]() {
+        reload_skybox_texture_data();
+    })};
 
-            return sm::Task::Result::Done;
-        });
+    const sm::Job scene {ctx.add_job([this]() {
+        reload_scene_texture_data();
+    })};
 
-        task.set_done();
-    });
+    ctx.add_job_main([this]() {
+        setup_skybox(true);
+        reload_and_set_scene_textures();
+    }, {skybox, scene});
 }
 
 bool GameScene::resign_available() const {
@@ -237,7 +223,7 @@ bool GameScene::game_in_progress() const {
     return m_game_state != GameState::Ready && m_game_state != GameState::Over;
 }
 
-void GameScene::reset(const std::string& string, const TimedMoves& moves) {
+bool GameScene::reset(const std::string& string, const protocol::Moves& moves) {
     if (m_engine) {
         try {
             m_engine->stop_thinking();  // Stop the engine first
@@ -255,6 +241,7 @@ void GameScene::reset(const std::string& string, const TimedMoves& moves) {
     m_clock.reset(clock_time(m_game_options.time_enum));
     m_moves_list.clear();
     m_game_session.reset();
+    m_interrupted_session.reset();
     m_game_analysis.reset();
     m_current_game = {};  // Must reset the current game here
 
@@ -263,19 +250,8 @@ void GameScene::reset(const std::string& string, const TimedMoves& moves) {
         m_moves_list.skip_first(true);
     }
 
-    // Play the moves offscreen
-    board().enable_move_callback(false);
-    board().enable_move_animations(false);
-
-    for (const auto& move : moves) {
-        play_move(move.first);
-        m_clock.switch_turn();
-        m_moves_list.push(move.first);
-        m_current_game.moves.emplace_back(move.first, move.second);  // Remember the previously played moves
-    }
-
-    board().enable_move_animations(true);
-    board().enable_move_callback(true);
+    // Stop at an invalid move, but finish resetting anyway
+    const bool valid_moves {play_moves_offscreen(moves)};
 
     // After the played moves, the game might be already over
     if (board().get_game_over() != GameOver::None) {
@@ -289,6 +265,8 @@ void GameScene::reset(const std::string& string, const TimedMoves& moves) {
     reset_camera_position();
 
     sm::Ctx::play_audio_sound(m_sound_new_game);
+
+    return valid_moves;
 }
 
 void GameScene::reset_camera_position() {
@@ -383,7 +361,7 @@ void GameScene::connect() {
     auto& g {ctx.global<Global>()};
 
     // To prevent bad states and desynchronizations
-    reset_game_if_session();
+    interrupt_game_if_session();
 
     try {
         g.client.connect();
@@ -485,6 +463,12 @@ void GameScene::client_request_join_game_session(const std::string& session_id)
     payload.player_name = g.options.name;
     payload.game_mode = protocol::GameMode(g.options.game_mode);
 
+    // Tell the server what we already have, if we are rejoining an interrupted game
+    if (m_interrupted_session && m_interrupted_session->session_id == payload.session_id) {
+        payload.known_plies = static_cast<std::uint32_t>(m_current_game.moves.size());
+        payload.known_messages = static_cast<std::uint32_t>(m_interrupted_session->messages.size());
+    }
+
     networking::Message message {protocol::message::Client_RequestJoinGameSession};
 
     if (!try_write_message(message, payload)) {
@@ -506,7 +490,14 @@ void GameScene::client_play_move(const std::string& move, protocol::ClockTime ti
     payload.session_id = m_game_session->get_session_id();
     payload.time = time;
     payload.game_over = game_over;
-    payload.move = move;
+    const auto protocol_move {move_to_protocol(move)};
+
+    if (!protocol_move) {
+        invalid_move_error();
+        return;
+    }
+
+    payload.move = *protocol_move;
 
     networking::Message message {protocol::message::Client_PlayMove};
 
@@ -744,6 +735,50 @@ void GameScene::setup_lights() {
     }
 }
 
+bool GameScene::play_moves_offscreen(const protocol::Moves& moves) {
+    board().enable_move_callback(false);
+    board().enable_move_animations(false);
+
+    bool valid_moves {true};
+
+    for (const auto& [move, time] : moves) {
+        // The notation is only needed for displaying and saving the game
+        const auto string {move_from_protocol(move)};
+
+        // Moves come from the server; don't trust them
+        if (!string || !play_move(move)) {
+            valid_moves = false;
+            break;
+        }
+
+        m_clock.switch_turn();
+
+        m_moves_list.push(*string);
+        m_current_game.moves.emplace_back(*string, time);  // Remember the previously played moves
+    }
+
+    board().enable_move_animations(true);
+    board().enable_move_callback(true);
+
+    return valid_moves;
+}
+
+bool GameScene::resync(const protocol::Moves& moves) {
+    // Continue the kept game with only the moves missed in the meantime
+    const bool valid_moves {play_moves_offscreen(moves)};
+
+    m_game_state = GameState::Ready;
+
+    // After the played moves, the game might be already over
+    if (board().get_game_over() != GameOver::None) {
+        m_game_state = GameState::Over;
+    }
+
+    board().setup_pieces();
+
+    return valid_moves;
+}
+
 void GameScene::load_icons() {
     load_game_icons();
 
@@ -805,13 +840,17 @@ void GameScene::reload_skybox_texture_data() const {
             break;
     }
 
-    if (!skybox.empty()) {
-        ctx.reload_texture_data(ctx.path_assets("textures/skybox/" + skybox + "/px.png"), post_processing);
-        ctx.reload_texture_data(ctx.path_assets("textures/skybox/" + skybox + "/nx.png"), post_processing);
-        ctx.reload_texture_data(ctx.path_assets("textures/skybox/" + skybox + "/py.png"), post_processing);
-        ctx.reload_texture_data(ctx.path_assets("textures/skybox/" + skybox + "/ny.png"), post_processing);
-        ctx.reload_texture_data(ctx.path_assets("textures/skybox/" + skybox + "/pz.png"), post_processing);
-        ctx.reload_texture_data(ctx.path_assets("textures/skybox/" + skybox + "/nz.png"), post_processing);
+    if (skybox.empty()) {
+        return;
+    }
+
+    for (const char* face : {"px", "nx", "py", "ny", "pz", "nz"}) {
+        // Don't keep decoding, if the scene has stopped in the meantime
+        if (sm::Job::stop_requested()) {
+            return;
+        }
+
+        ctx.reload_texture_data(ctx.path_assets("textures/skybox/" + skybox + "/" + face + ".png"), post_processing);
     }
 }
 
@@ -1185,8 +1224,8 @@ std::vector<std::string> GameScene::current_analysis_position(std::size_t ply) {
 void GameScene::connection_error(const networking::ConnectionError& e) {
     LOG_DIST_ERROR("Connection error: {}", e.what());
 
-    // To prevent bad states and desynchronizations
-    reset_game_if_session();
+    // Keep the board, so that the game can be continued after reconnecting
+    interrupt_game_if_session();
 
     m_ui.clear_modal_window(  // The user may already be blocked in a modal window
         ModalWindowWaitServerAcceptGameSession |
@@ -1211,6 +1250,22 @@ void GameScene::serialization_error(const networking::SerializationError& e) {
     m_ui.push_modal_window(ModalWindowConnectionError);
 }
 
+void GameScene::invalid_move_error() {
+    LOG_DIST_CRITICAL("Invalid move; dropping the connection");
+
+    // The game cannot continue from a corrupted history
+    reset();
+    disconnect();
+
+    m_ui.clear_modal_window(  // The user may already be blocked in a modal window
+        ModalWindowWaitServerAcceptGameSession |
+        ModalWindowWaitRemoteJoinGameSession |
+        ModalWindowWaitServerAcceptJoinGameSession |
+        ModalWindowWaitRemoteRematch
+    );
+    m_ui.push_modal_window(ModalWindowConnectionError);
+}
+
 bool GameScene::try_write_message(networking::Message& message, auto payload) {
     try {
         message.write(payload);
@@ -1247,11 +1302,33 @@ bool GameScene::try_send_message(const networking::Message& message) {
 }
 
 void GameScene::reset_game_if_session() {
-    if (m_game_session) {
+    if (m_game_session || m_interrupted_session) {
         reset();
     }
 }
 
+void GameScene::interrupt_game_if_session() {
+    if (!m_game_session) {
+        return;
+    }
+
+    // The board can be kept only at points where nothing is half done
+    const bool stable_state {m_game_state == GameState::HumanThinking || m_game_state == GameState::RemoteThinking};
+
+    if (!stable_state || !board().is_turn_finished()) {
+        reset();
+        return;
+    }
+
+    board().cancel_user_move();
+    board().setup_pieces(false);
+
+    m_clock.stop();
+    m_game_state = GameState::Ready;
+    m_interrupted_session = InterruptedSession {m_game_session->get_session_id(), m_game_session->get_messages()};
+    m_game_session.reset();
+}
+
 void GameScene::update_connection_state() {
     auto& g {ctx.global<Global>()};
 
@@ -1377,6 +1454,11 @@ void GameScene::server_accept_game_session(const networking::Message& message) {
         return;
     }
 
+    // A new session doesn't continue a kept board
+    if (m_interrupted_session) {
+        reset();
+    }
+
     m_game_session = GameSession(payload.session_id);
 
     m_ui.clear_modal_window(ModalWindowWaitServerAcceptGameSession);
@@ -1404,13 +1486,41 @@ void GameScene::server_accept_join_game_session(const networking::Message& messa
     m_game_options.remote_color = PlayerColor(payload.remote_player);
     set_time_control_options(payload.initial_time);
 
-    // This resets the camera; call it after setting the color
-    // This resets the session; call it before creating the session
-    reset(payload.moves);
+    protocol::Messages messages;
+
+    if (
+        m_interrupted_session &&
+        m_interrupted_session->session_id == payload.session_id &&
+        payload.first_ply == m_current_game.moves.size() &&
+        payload.first_message == m_interrupted_session->messages.size()
+    ) {
+        // Only the missing part has been received
+        messages = std::move(m_interrupted_session->messages);
+        messages.insert(messages.end(), payload.messages.begin(), payload.messages.end());
+        m_interrupted_session.reset();
+
+        if (!resync(payload.moves)) {
+            invalid_move_error();
+            return;
+        }
+    } else {
+        if (m_interrupted_session && m_interrupted_session->session_id == payload.session_id) {
+            LOG_DIST_WARNING("Kept board doesn't match the server's; starting over from its moves");
+        }
+
+        messages = std::move(payload.messages);
+
+        // This resets the camera; call it after setting the color
+        // This resets the session; call it before creating the session
+        if (!reset(payload.moves)) {
+            invalid_move_error();
+            return;
+        }
+    }
 
     m_game_session = GameSession(payload.session_id);
     m_game_session->remote_joined(payload.remote_name);
-    m_game_session->set_messages(payload.messages);
+    m_game_session->set_messages(messages);
 
     switch (m_game_options.remote_color) {
         case PlayerColorWhite:
@@ -1506,7 +1616,9 @@ void GameScene::server_remote_played_move(const networking::Message& message) {
             break;
     }
 
-    play_move(payload.move);
+    if (!play_move(payload.move)) {
+        invalid_move_error();
+    }
 }
 
 void GameScene::server_remote_timed_out(const networking::Message&) {
@@ -45,8 +45,12 @@ enum class GamePlayer {
     Remote
 };
 
-// Moves with player's time after the move attached
-using TimedMoves = protocol::Moves;
+// Session left because of a connection error in the middle of a game
+// The board is kept, so that only the missed moves need to be played when rejoining
+struct InterruptedSession {
+    protocol::SessionId session_id {};
+    protocol::Messages messages;
+};
 
 // Base class for scenes representing games
 class GameScene : public sm::ApplicationScene {
@@ -69,12 +73,15 @@ public:
     virtual const BoardObj& board() const = 0;
     virtual GamePlayer player_type() const = 0;
     virtual std::string setup_position() const = 0;
-    virtual void reset(const TimedMoves& moves = {}) = 0;
+    virtual bool reset(const protocol::Moves& moves = {}) = 0;
     virtual void reset_board(const std::string& string) = 0;
     virtual bool second_player_starting() = 0;
     virtual Clock::Time clock_time(int time_enum) = 0;
     virtual void set_time_control_options(Clock::Time time) = 0;
     virtual void play_move(const std::string& string) = 0;
+    virtual bool play_move(protocol::Move move) = 0;
+    virtual std::optional<protocol::Move> move_to_protocol(const std::string& string) const = 0;
+    virtual std::optional<std::string> move_from_protocol(protocol::Move move) const = 0;
     virtual void timeout(PlayerColor color) = 0;
     virtual void resign(PlayerColor color) = 0;
     virtual void accept_draw() = 0;
@@ -110,7 +117,7 @@ public:
     bool accept_draw_available() const;
     bool game_in_progress() const;
 
-    void reset(const std::string& string, const TimedMoves& moves = {});
+    bool reset(const std::string& string, const protocol::Moves& moves = {});
     void reset_camera_position();
     void analyze_game(std::size_t game_index);
     void analyze_position();
@@ -143,6 +150,9 @@ protected:
     void setup_skybox(bool reload = false);
     void setup_lights();
 
+    bool play_moves_offscreen(const protocol::Moves& moves);
+    bool resync(const protocol::Moves& moves);
+
     void load_icons();
     void load_sounds();
     void reload_skybox_texture_data() const;
@@ -166,10 +176,12 @@ protected:
 
     void connection_error(const networking::ConnectionError& e);
     void serialization_error(const networking::SerializationError& e);
+    void invalid_move_error();
     bool try_write_message(networking::Message& message, auto payload);
     bool try_read_message(const networking::Message& message, auto& payload);
     bool try_send_message(const networking::Message& message);
     void reset_game_if_session();
+    void interrupt_game_if_session();
     void update_connection_state();
     void handle_message(const networking::Message& message);
     void server_hello_accept(const networking::Message& message);
@@ -208,6 +220,7 @@ protected:
     glm::vec3 m_white_camera_position {};
     glm::vec3 m_black_camera_position {};
     std::optional<GameSession> m_game_session;  // It's something when the session is alive
+    std::optional<InterruptedSession> m_interrupted_session;  // It's something when the board is kept after a connection error
     GameOptions m_game_options;
     Clock m_clock;
     MovesList m_moves_list;
@@ -1,20 +1,14 @@
 #include "scenes/loading_scene.hpp"
 
+#include <string>
+
 #include "nine_morris_3d_engine/external/resmanager.h++"
+#include "nine_morris_3d_engine/external/imgui.h++"
 
 #include "global.hpp"
 
 void LoadingScene::on_start() {
-    ctx.add_task_async([this](sm::AsyncTask& task) {
-        try {
-            load_assets(task);
-        } catch (const sm::RuntimeError&) {
-            task.set_done(std::current_exception());
-            return;
-        }
-
-        task.set_done();
-    });
+    load_assets();
 
     m_loading_image = std::make_shared<sm::ImageNode>(load_splash_screen());
 }
@@ -23,6 +17,28 @@ void LoadingScene::on_stop() {
 
 }
 
+void LoadingScene::on_imgui_update() {
+    const float width {static_cast<float>(ctx.get_window_width()) / 3.0f};
+
+    ImGui::SetNextWindowPos(
+        ImVec2(static_cast<float>(ctx.get_window_width()) / 2.0f, static_cast<float>(ctx.get_window_height()) * 0.9f),
+        ImGuiCond_Always,
+        ImVec2(0.5f, 0.5f)
+    );
+
+    ImGui::SetNextWindowSize(ImVec2(width, 0.0f), ImGuiCond_Always);
+
+    if (ImGui::Begin("##Loading", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_NoInputs)) {
+        const std::string overlay {
+            std::to_string(m_loader->get_loaded_count()) + " / " + std::to_string(m_loader->get_asset_count())
+        };
+
+        ImGui::ProgressBar(m_loader->get_progress(), ImVec2(-1.0f, 0.0f), overlay.c_str());
+    }
+
+    ImGui::End();
+}
+
 void LoadingScene::on_update() {
     update_loading_image();
 
@@ -70,128 +86,50 @@ std::shared_ptr<sm::GlTexture> LoadingScene::load_splash_screen() {
     );
 }
 
-void LoadingScene::load_assets(sm::AsyncTask& task) {
+void LoadingScene::load_assets() {
     const auto& g {ctx.global<Global>()};
 
-    {
-        sm::TexturePostProcessing post_processing;
-        post_processing.flip = false;
-
-        if (g.options.texture_quality == TextureQualityHalf) {
-            post_processing.size = sm::TextureSize::Half;
-        }
-
-        std::string skybox;
-
-        switch (g.options.skybox) {
-            case SkyboxNone:
-                break;
-            case SkyboxField:
-                skybox = "field";
-                break;
-            case SkyboxAutumn:
-                skybox = "autumn";
-                break;
-            case SkyboxSummer:
-                skybox = "summer";
-                break;
-            case SkyboxNight:
-                skybox = "night";
-                break;
-            case SkyboxSunset:
-                skybox = "sunset";
-                break;
-            case SkyboxSky:
-                skybox = "sky";
-                break;
-        }
-
-        if (!skybox.empty()) {
-            ctx.load_texture_data(ctx.path_assets("textures/skybox/" + skybox + "/px.png"), post_processing);
-            ctx.load_texture_data(ctx.path_assets("textures/skybox/" + skybox + "/nx.png"), post_processing);
-            ctx.load_texture_data(ctx.path_assets("textures/skybox/" + skybox + "/py.png"), post_processing);
-            ctx.load_texture_data(ctx.path_assets("textures/skybox/" + skybox + "/ny.png"), post_processing);
-            ctx.load_texture_data(ctx.path_assets("textures/skybox/" + skybox + "/pz.png"), post_processing);
-            ctx.load_texture_data(ctx.path_assets("textures/skybox/" + skybox + "/nz.png"), post_processing);
-        }
-    }
-
-    if (task.stop_requested()) {
-        task.set_done();
-        return;
-    }
-
-    {
-        sm::MeshSpecification specification;
-        specification.object_name = "Board";
-        specification.type = sm::MeshType::PNTT;
-
-        ctx.load_mesh(ctx.path_assets("nine_mens_morris/board.obj"), specification);
-
-        sm::TexturePostProcessing post_processing;
-
-        if (g.options.texture_quality == TextureQualityHalf) {
-            post_processing.size = sm::TextureSize::Half;
-        }
-
-        ctx.load_texture_data(ctx.path_assets("nine_mens_morris/board_diffuse.png"), post_processing);
-        ctx.load_texture_data(ctx.path_assets("nine_mens_morris/board_normal.png"), post_processing);
-    }
-
-    if (task.stop_requested()) {
-        task.set_done();
-        return;
+    std::string skybox;
+
+    switch (g.options.skybox) {
+        case SkyboxNone:
+            break;
+        case SkyboxField:
+            skybox = "field";
+            break;
+        case SkyboxAutumn:
+            skybox = "autumn";
+            break;
+        case SkyboxSummer:
+            skybox = "summer";
+            break;
+        case SkyboxNight:
+            skybox = "night";
+            break;
+        case SkyboxSunset:
+            skybox = "sunset";
+            break;
+        case SkyboxSky:
+            skybox = "sky";
+            break;
     }
 
-    {
-        sm::MeshSpecification specification;
-        specification.object_name = "Paint";
-        specification.type = sm::MeshType::PNTT;
-
-        ctx.load_mesh(ctx.path_assets("nine_mens_morris/paint.obj"), specification);
-
-        sm::TexturePostProcessing post_processing;
-
-        if (g.options.texture_quality == TextureQualityHalf) {
-            post_processing.size = sm::TextureSize::Half;
-        }
+    const auto texture_size {
+        g.options.texture_quality == TextureQualityHalf ? sm::TextureSize::Half : sm::TextureSize::Default
+    };
 
-        ctx.load_texture_data(ctx.path_assets("nine_mens_morris/paint_diffuse.png"), post_processing);
-    }
-
-    {
-        sm::MeshSpecification specification;
-        specification.object_name = "Node";
-        specification.type = sm::MeshType::PN;
-
-        ctx.load_mesh(ctx.path_assets("nine_mens_morris/node.obj"), specification);
-    }
-
-    if (task.stop_requested()) {
-        task.set_done();
-        return;
-    }
-
-    {
-        sm::MeshSpecification specification;
-        specification.type = sm::MeshType::PNTT;
-
-        specification.object_name = "Piece";
-        ctx.load_mesh(ctx.path_assets("nine_mens_morris/piece.obj"), specification);
-
-        sm::TexturePostProcessing post_processing;
-
-        if (g.options.texture_quality == TextureQualityHalf) {
-            post_processing.size = sm::TextureSize::Half;
-        }
+    // Assets without a skybox are skipped
+    m_loader = std::make_unique<sm::AssetLoader>(
+        ctx.path_assets("loading.json"),
+        sm::AssetLoader::Variables {{"skybox", skybox}},
+        texture_size
+    );
 
-        ctx.load_texture_data(ctx.path_assets("nine_mens_morris/piece_white_diffuse.png"), post_processing);
-        ctx.load_texture_data(ctx.path_assets("nine_mens_morris/piece_black_diffuse.png"), post_processing);
-        ctx.load_texture_data(ctx.path_assets("nine_mens_morris/piece_normal.png"), post_processing);
-    }
+    // Assets are loaded in parallel; they are cancelled if the scene stops
+    const sm::Job assets {m_loader->load(ctx)};
 
-    ctx.add_task_immediate([this]() {
+    ctx.add_job_main([this]() {
+        m_loader->log_report();
         m_done = true;
-        return sm::Task::Result::Done;
-    });
+    }, {assets});
 }
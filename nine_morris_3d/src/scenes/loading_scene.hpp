@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include <nine_morris_3d_engine/nine_morris_3d.hpp>
 
 class LoadingScene : public sm::ApplicationScene {
@@ -12,11 +14,13 @@ public:
     void on_start() override;
     void on_stop() override;
     void on_update() override;
+    void on_imgui_update() override;
 private:
     void update_loading_image();
     std::shared_ptr<sm::GlTexture> load_splash_screen();
-    void load_assets(sm::AsyncTask& task);
+    void load_assets();
 
     bool m_done {false};
     std::shared_ptr<sm::ImageNode> m_loading_image;
+    std::unique_ptr<sm::AssetLoader> m_loader;
 };
@@ -78,8 +78,8 @@ std::string NineMensMorrisBaseScene::setup_position() const {
     return NineMensMorrisBoard::position_to_string(m_board.setup_position());
 }
 
-void NineMensMorrisBaseScene::reset(const TimedMoves& moves) {
-    GameScene::reset("w:w:b:1", moves);
+bool NineMensMorrisBaseScene::reset(const protocol::Moves& moves) {
+    return GameScene::reset("w:w:b:1", moves);
 }
 
 void NineMensMorrisBaseScene::reset_board(const std::string& string) {
@@ -147,6 +147,35 @@ void NineMensMorrisBaseScene::play_move(const std::string& string) {
     }
 }
 
+bool NineMensMorrisBaseScene::play_move(protocol::Move move) {
+    try {
+        m_board.play_move(NineMensMorrisBoard::move_from_protocol(move));
+    } catch (const BoardError& e) {
+        LOG_DIST_ERROR("Invalid move {:#010x}: {}", move, e.what());
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<protocol::Move> NineMensMorrisBaseScene::move_to_protocol(const std::string& string) const {
+    try {
+        return NineMensMorrisBoard::move_to_protocol(NineMensMorrisBoard::move_from_string(string));
+    } catch (const BoardError& e) {
+        LOG_DIST_ERROR("Invalid move {}: {}", string, e.what());
+        return std::nullopt;
+    }
+}
+
+std::optional<std::string> NineMensMorrisBaseScene::move_from_protocol(protocol::Move move) const {
+    try {
+        return NineMensMorrisBoard::move_to_string(NineMensMorrisBoard::move_from_protocol(move));
+    } catch (const BoardError& e) {
+        LOG_DIST_ERROR("Invalid move {:#010x}: {}", move, e.what());
+        return std::nullopt;
+    }
+}
+
 void NineMensMorrisBaseScene::timeout(PlayerColor color) {
     switch (color) {
         case PlayerColorWhite:
@@ -299,10 +328,19 @@ void NineMensMorrisBaseScene::reload_scene_texture_data() const {
         ctx.reload_texture_data(ctx.path_assets("textures/board/board_normal.png"), post_processing);
     }
 
+    // Don't keep decoding, if the scene has stopped in the meantime
+    if (sm::Job::stop_requested()) {
+        return;
+    }
+
     {
         ctx.reload_texture_data(ctx.path_assets("textures/board/paint_diffuse.png"), post_processing);
     }
 
+    if (sm::Job::stop_requested()) {
+        return;
+    }
+
     {
         ctx.reload_texture_data(ctx.path_assets("textures/piece/piece_white_diffuse.png"), post_processing);
         ctx.reload_texture_data(ctx.path_assets("textures/piece/piece_black_diffuse.png"), post_processing);
@@ -369,7 +407,7 @@ unsigned int NineMensMorrisBaseScene::black_color() const {
 }
 
 std::shared_ptr<sm::ModelNode> NineMensMorrisBaseScene::setup_board() const {
-    const auto mesh {ctx.get_mesh("board.obj"_H)};
+    const auto mesh {ctx.get_mesh("board.mesh"_H)};
 
     const auto vertex_array {ctx.load_vertex_array("board"_H, mesh)};
 
@@ -392,7 +430,7 @@ std::shared_ptr<sm::ModelNode> NineMensMorrisBaseScene::setup_board() const {
 }
 
 std::shared_ptr<sm::ModelNode> NineMensMorrisBaseScene::setup_paint() const {
-    const auto mesh {ctx.get_mesh("paint.obj"_H)};
+    const auto mesh {ctx.get_mesh("paint.mesh"_H)};
 
     const auto vertex_array {ctx.load_vertex_array("paint"_H, mesh)};
 
@@ -419,20 +457,21 @@ std::shared_ptr<sm::ModelNode> NineMensMorrisBaseScene::setup_paint() const {
 }
 
 NineMensMorrisBoard::NodeModels NineMensMorrisBaseScene::setup_nodes() const {
-    const auto mesh {ctx.get_mesh("node.obj"_H)};
+    const auto mesh {ctx.get_mesh("node.mesh"_H)};
 
     const auto vertex_array {ctx.load_vertex_array("node"_H, mesh)};
 
     const auto material {ctx.load_material(sm::MaterialType::Phong)};
 
+    // All nodes look the same, so they share the material and are drawn instanced
+    const auto material_instance {ctx.load_material_instance("node"_H, material)};
+    material_instance->set_vec3("u_material.ambient_diffuse"_H, glm::vec3(0.065f));  // FIXME depends on the environment lighting
+    material_instance->set_vec3("u_material.specular"_H, glm::vec3(0.05f));
+    material_instance->set_float("u_material.shininess"_H, 8.0f);
+
     NineMensMorrisBoard::NodeModels models;
 
     for (int i {0}; i < NineMensMorrisBoard::NODES; i++) {
-        const auto material_instance {ctx.load_material_instance(sm::Id("node" + std::to_string(i)), material)};
-        material_instance->set_vec3("u_material.ambient_diffuse"_H, glm::vec3(0.065f));  // FIXME depends on the environment lighting
-        material_instance->set_vec3("u_material.specular"_H, glm::vec3(0.05f));
-        material_instance->set_float("u_material.shininess"_H, 8.0f);
-
         const auto model {std::make_shared<sm::ModelNode>(mesh, vertex_array, material_instance)};
         model->cast_shadow = sm::NodeFlag::Disabled;
 
@@ -443,7 +482,7 @@ NineMensMorrisBoard::NodeModels NineMensMorrisBaseScene::setup_nodes() const {
 }
 
 NineMensMorrisBoard::PieceModels NineMensMorrisBaseScene::setup_white_pieces() const {
-    const auto mesh {ctx.get_mesh("piece.obj"_H)};
+    const auto mesh {ctx.get_mesh("piece.mesh"_H)};
 
     const auto vertex_array {ctx.load_vertex_array("piece"_H, mesh)};
 
@@ -457,17 +496,16 @@ NineMensMorrisBoard::PieceModels NineMensMorrisBaseScene::setup_white_pieces() c
         sm::MaterialType::PhongDiffuseNormalShadow
     )};
 
-    material->add_uniform(sm::Material::Uniform::Vec3, "u_highlight_color"_H);
+    // All pieces of a color share the material and are drawn instanced; the highlight is per instance
+    const auto material_instance {ctx.load_material_instance("piece_white"_H, material)};
+    material_instance->set_texture("u_material.ambient_diffuse"_H, diffuse, 0);
+    material_instance->set_vec3("u_material.specular"_H, glm::vec3(0.05f));
+    material_instance->set_float("u_material.shininess"_H, 8.0f);
+    material_instance->set_texture("u_material.normal"_H, normal, 1);
 
     NineMensMorrisBoard::PieceModels models;
 
     for (int i {0}; i < pieces_count() / 2; i++) {
-        const auto material_instance {ctx.load_material_instance(sm::Id("piece_white" + std::to_string(i)), material)};
-        material_instance->set_texture("u_material.ambient_diffuse"_H, diffuse, 0);
-        material_instance->set_vec3("u_material.specular"_H, glm::vec3(0.05f));
-        material_instance->set_float("u_material.shininess"_H, 8.0f);
-        material_instance->set_texture("u_material.normal"_H, normal, 1);
-
         models.push_back(std::make_shared<sm::ModelNode>(mesh, vertex_array, material_instance));
     }
 
@@ -475,7 +513,7 @@ NineMensMorrisBoard::PieceModels NineMensMorrisBaseScene::setup_white_pieces() c
 }
 
 NineMensMorrisBoard::PieceModels NineMensMorrisBaseScene::setup_black_pieces() const {
-    const auto mesh {ctx.get_mesh("piece.obj"_H)};
+    const auto mesh {ctx.get_mesh("piece.mesh"_H)};
 
     const auto vertex_array {ctx.load_vertex_array("piece"_H, mesh)};
 
@@ -489,17 +527,16 @@ NineMensMorrisBoard::PieceModels NineMensMorrisBaseScene::setup_black_pieces() c
         sm::MaterialType::PhongDiffuseNormalShadow
     )};
 
-    material->add_uniform(sm::Material::Uniform::Vec3, "u_highlight_color"_H);
+    // All pieces of a color share the material and are drawn instanced; the highlight is per instance
+    const auto material_instance {ctx.load_material_instance("piece_black"_H, material)};
+    material_instance->set_texture("u_material.ambient_diffuse"_H, diffuse, 0);
+    material_instance->set_vec3("u_material.specular"_H, glm::vec3(0.05f));
+    material_instance->set_float("u_material.shininess"_H, 8.0f);
+    material_instance->set_texture("u_material.normal"_H, normal, 1);
 
     NineMensMorrisBoard::PieceModels models;
 
     for (int i {0}; i < pieces_count() / 2; i++) {
-        const auto material_instance {ctx.load_material_instance(sm::Id("piece_black" + std::to_string(i)), material)};
-        material_instance->set_texture("u_material.ambient_diffuse"_H, diffuse, 0);
-        material_instance->set_vec3("u_material.specular"_H, glm::vec3(0.05f));
-        material_instance->set_float("u_material.shininess"_H, 8.0f);
-        material_instance->set_texture("u_material.normal"_H, normal, 1);
-
         models.push_back(std::make_shared<sm::ModelNode>(mesh, vertex_array, material_instance));
     }
 
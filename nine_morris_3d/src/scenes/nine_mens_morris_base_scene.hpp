@@ -27,12 +27,15 @@ public:
     const BoardObj& board() const override;
     GamePlayer player_type() const override;
     std::string setup_position() const override;
-    void reset(const TimedMoves& moves = {}) override;
+    bool reset(const protocol::Moves& moves = {}) override;
     void reset_board(const std::string& string) override;
     bool second_player_starting() override;
     Clock::Time clock_time(int time_enum) override;
     void set_time_control_options(Clock::Time time) override;
     void play_move(const std::string& string) override;
+    bool play_move(protocol::Move move) override;
+    std::optional<protocol::Move> move_to_protocol(const std::string& string) const override;
+    std::optional<std::string> move_from_protocol(protocol::Move move) const override;
     void timeout(PlayerColor color) override;
     void resign(PlayerColor color) override;
     void accept_draw() override;
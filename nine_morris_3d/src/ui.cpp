@@ -1248,6 +1248,7 @@ void Ui::set_scale(sm::Ctx& ctx, int scale) {
 void Ui::set_scale_task(sm::Ctx& ctx, int scale) {
     ctx.add_task_immediate([&ctx, scale]() {
         set_scale(ctx, scale);
+        ctx.set_renderer_scale(scale);
 
         return sm::Task::Result::Done;
     });
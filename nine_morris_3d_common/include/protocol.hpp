@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <cstddef>
 
+#include <cereal/cereal.hpp>
 #include <cereal/types/string.hpp>
 #include <cereal/types/vector.hpp>
 #include <cereal/types/chrono.hpp>
@@ -67,11 +68,18 @@ namespace protocol {
             The server accepts or rejects the request, with Server_AcceptJoinGameSession and Server_RejectJoinGameSession.
             It is called when the client presses the join game button.
 
+            A client that got disconnected in the middle of a game keeps its board and sends the number of
+            plies and messages it already has, in order to rejoin the session. Otherwise it sends zeros.
+
         Server_AcceptJoinGameSession
             Acknowledge a game session with that specific ID. The client unblocks and the game is ready to start.
             The client receives the played moves so far, enabling it to continue an interrupted game. It also
             receives the messages. A disconnected client may rejoin the session.
 
+            Only the moves and messages that the client doesn't already have are sent, starting from first_ply
+            and first_message. If the client claims to have more than the server, everything is sent and the
+            client must start over.
+
         Server_RejectJoinGameSession
             Fail to find a session with that specific ID. Send an error code.
 
@@ -215,7 +223,135 @@ namespace protocol {
     using Messages = std::vector<std::pair<std::string, std::string>>;  // Player name of the message and the actual message
     inline constexpr std::size_t MAX_MESSAGE_SIZE {128};
 
-    using Moves = std::vector<std::pair<std::string, ClockTime>>;  // The actual move and the player's time after the move
+    // Clients are compatible with the server only if they have this minor version
+    // Minor version 7 introduced compact moves
+    inline constexpr unsigned int CLIENT_VERSION_MINOR {7};
+
+    /*
+        Moves travel and are stored in a compact binary form, instead of the string notation.
+
+        A move is a 32-bit integer: the type in the lowest 2 bits, followed by three 5-bit node indices.
+        Unused indices are zero. The indices are in the order in which they appear in the string notation,
+        so "a1-d1xg7" is MoveCapture, a1, d1, g7.
+
+        A list of moves is serialized as a varint count, followed by each move as a fixed 4-byte integer and
+        the player's time after the move, as a zigzag varint difference from the same player's previous time
+        (or the initial time).
+    */
+
+    using Move = std::uint32_t;
+
+    enum class MoveType : std::uint32_t {
+        Place,
+        PlaceCapture,
+        Move,
+        MoveCapture
+    };
+
+    inline constexpr std::uint32_t MOVE_TYPE_BITS {2};
+    inline constexpr std::uint32_t MOVE_INDEX_BITS {5};
+    inline constexpr std::uint32_t MOVE_INDEX_MASK {(1u << MOVE_INDEX_BITS) - 1};
+
+    constexpr Move encode_move(MoveType type, int index1, int index2 = 0, int index3 = 0) {
+        return (
+            static_cast<std::uint32_t>(type) |
+            ((static_cast<std::uint32_t>(index1) & MOVE_INDEX_MASK) << MOVE_TYPE_BITS) |
+            ((static_cast<std::uint32_t>(index2) & MOVE_INDEX_MASK) << (MOVE_TYPE_BITS + MOVE_INDEX_BITS)) |
+            ((static_cast<std::uint32_t>(index3) & MOVE_INDEX_MASK) << (MOVE_TYPE_BITS + MOVE_INDEX_BITS * 2))
+        );
+    }
+
+    constexpr MoveType move_type(Move move) {
+        return static_cast<MoveType>(move & ((1u << MOVE_TYPE_BITS) - 1));
+    }
+
+    // Get the first, second or third index, i.e. 0, 1 or 2
+    constexpr int move_index(Move move, int index) {
+        return static_cast<int>((move >> (MOVE_TYPE_BITS + MOVE_INDEX_BITS * static_cast<std::uint32_t>(index))) & MOVE_INDEX_MASK);
+    }
+
+    struct TimedMove {
+        Move move {};
+        ClockTime time {};  // The player's time after the move
+    };
+
+    using Moves = std::vector<TimedMove>;
+
+    namespace internal {
+        template<typename Archive>
+        void save_varint(Archive& archive, std::uint64_t value) {
+            while (value >= 0x80) {
+                archive(static_cast<std::uint8_t>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+
+            archive(static_cast<std::uint8_t>(value));
+        }
+
+        template<typename Archive>
+        std::uint64_t load_varint(Archive& archive) {
+            std::uint64_t value {};
+
+            for (unsigned int shift {0}; shift < 64; shift += 7) {
+                std::uint8_t byte {};
+                archive(byte);
+
+                value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+
+                if (!(byte & 0x80)) {
+                    return value;
+                }
+            }
+
+            throw cereal::Exception("Invalid varint");
+        }
+
+        // Wrapper for serializing moves with delta encoded clocks
+        // The initial time must be serialized before the moves
+        struct DeltaMoves {
+            Moves& moves;
+            const ClockTime& initial_time;
+        };
+
+        template<typename Archive>
+        void save(Archive& archive, const DeltaMoves& delta_moves) {
+            const Moves& moves {delta_moves.moves};
+
+            save_varint(archive, moves.size());
+
+            for (std::size_t i {0}; i < moves.size(); i++) {
+                const auto previous_time {i >= 2 ? moves[i - 2].time : delta_moves.initial_time};
+                const auto delta {static_cast<std::int64_t>(moves[i].time) - static_cast<std::int64_t>(previous_time)};
+
+                archive(moves[i].move);
+                save_varint(archive, (static_cast<std::uint64_t>(delta) << 1) ^ static_cast<std::uint64_t>(delta >> 63));
+            }
+        }
+
+        template<typename Archive>
+        void load(Archive& archive, DeltaMoves& delta_moves) {
+            Moves& moves {delta_moves.moves};
+
+            const auto size {load_varint(archive)};
+
+            moves.clear();
+
+            // Don't trust the size for reserving memory; the archive throws when it runs out of data
+            for (std::uint64_t i {0}; i < size; i++) {
+                const auto previous_time {i >= 2 ? moves[i - 2].time : delta_moves.initial_time};
+
+                TimedMove move;
+                archive(move.move);
+
+                const auto zigzag {load_varint(archive)};
+                const auto delta {static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1)};
+
+                move.time = static_cast<ClockTime>(static_cast<std::int64_t>(previous_time) + delta);
+
+                moves.push_back(move);
+            }
+        }
+    }
 
     enum class Player {
         White,
@@ -351,10 +487,12 @@ namespace protocol {
         SessionId session_id {};
         std::string player_name;
         GameMode game_mode {};
+        std::uint32_t known_plies {};
+        std::uint32_t known_messages {};
 
         template<typename Archive>
         void serialize(Archive& archive) {
-            archive(session_id, player_name, game_mode);
+            archive(session_id, player_name, game_mode, known_plies, known_messages);
         }
     };
 
@@ -365,13 +503,27 @@ namespace protocol {
         ClockTime remote_time {};
         ClockTime time {};
         bool game_over {};
+        std::uint32_t first_ply {};  // The index of the first move sent
+        std::uint32_t first_message {};  // The index of the first message sent
         Moves moves;
         Messages messages;
         std::string remote_name;
 
         template<typename Archive>
         void serialize(Archive& archive) {
-            archive(session_id, remote_player, initial_time, remote_time, time, game_over, moves, messages, remote_name);
+            archive(
+                session_id,
+                remote_player,
+                initial_time,
+                remote_time,
+                time,
+                game_over,
+                first_ply,
+                first_message,
+                internal::DeltaMoves {moves, initial_time},
+                messages,
+                remote_name
+            );
         }
     };
 
@@ -408,7 +560,7 @@ namespace protocol {
         SessionId session_id {};
         ClockTime time {};  // After player's turn
         bool game_over {};
-        std::string move;
+        Move move {};
 
         template<typename Archive>
         void serialize(Archive& archive) {
@@ -418,7 +570,7 @@ namespace protocol {
 
     struct Server_RemotePlayedMove {
         ClockTime time {};  // After player's turn
-        std::string move;
+        Move move {};
 
         template<typename Archive>
         void serialize(Archive& archive) {
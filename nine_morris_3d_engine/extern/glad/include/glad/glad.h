@@ -7,6 +7,7 @@
     APIs: gl=4.3
     Profile: core
     Extensions:
+        GL_ARB_buffer_storage,
         GL_EXT_texture_filter_anisotropic
     Loader: True
     Local files: False
@@ -14,9 +15,9 @@
     Reproducible: False
 
     Commandline:
-        --profile="core" --api="gl=4.3" --generator="c" --spec="gl" --extensions="GL_EXT_texture_filter_anisotropic"
+        --profile="core" --api="gl=4.3" --generator="c" --spec="gl" --extensions="GL_ARB_buffer_storage,GL_EXT_texture_filter_anisotropic"
     Online:
-        https://glad.dav1d.de/#profile=core&language=c&specification=gl&loader=on&api=gl%3D4.3&extensions=GL_EXT_texture_filter_anisotropic
+        https://glad.dav1d.de/#profile=core&language=c&specification=gl&loader=on&api=gl%3D4.3&extensions=GL_ARB_buffer_storage%2CGL_EXT_texture_filter_anisotropic
 */
 
 
@@ -3194,8 +3195,22 @@ typedef void (APIENTRYP PFNGLGETPOINTERVPROC)(GLenum pname, void **params);
 GLAPI PFNGLGETPOINTERVPROC glad_glGetPointerv;
 #define glGetPointerv glad_glGetPointerv
 #endif
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#define GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT 0x00004000
+#define GL_BUFFER_IMMUTABLE_STORAGE 0x821F
+#define GL_BUFFER_STORAGE_FLAGS 0x8220
 #define GL_TEXTURE_MAX_ANISOTROPY_EXT 0x84FE
 #define GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT 0x84FF
+#ifndef GL_ARB_buffer_storage
+#define GL_ARB_buffer_storage 1
+GLAPI int GLAD_GL_ARB_buffer_storage;
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+GLAPI PFNGLBUFFERSTORAGEPROC glad_glBufferStorage;
+#define glBufferStorage glad_glBufferStorage
+#endif
 #ifndef GL_EXT_texture_filter_anisotropic
 #define GL_EXT_texture_filter_anisotropic 1
 GLAPI int GLAD_GL_EXT_texture_filter_anisotropic;
@@ -7,6 +7,7 @@
     APIs: gl=4.3
     Profile: core
     Extensions:
+        GL_ARB_buffer_storage,
         GL_EXT_texture_filter_anisotropic
     Loader: True
     Local files: False
@@ -14,9 +15,9 @@
     Reproducible: False
 
     Commandline:
-        --profile="core" --api="gl=4.3" --generator="c" --spec="gl" --extensions="GL_EXT_texture_filter_anisotropic"
+        --profile="core" --api="gl=4.3" --generator="c" --spec="gl" --extensions="GL_ARB_buffer_storage,GL_EXT_texture_filter_anisotropic"
     Online:
-        https://glad.dav1d.de/#profile=core&language=c&specification=gl&loader=on&api=gl%3D4.3&extensions=GL_EXT_texture_filter_anisotropic
+        https://glad.dav1d.de/#profile=core&language=c&specification=gl&loader=on&api=gl%3D4.3&extensions=GL_ARB_buffer_storage%2CGL_EXT_texture_filter_anisotropic
 */
 
 #include <stdio.h>
@@ -835,7 +836,9 @@ PFNGLVIEWPORTARRAYVPROC glad_glViewportArrayv = NULL;
 PFNGLVIEWPORTINDEXEDFPROC glad_glViewportIndexedf = NULL;
 PFNGLVIEWPORTINDEXEDFVPROC glad_glViewportIndexedfv = NULL;
 PFNGLWAITSYNCPROC glad_glWaitSync = NULL;
+int GLAD_GL_ARB_buffer_storage = 0;
 int GLAD_GL_EXT_texture_filter_anisotropic = 0;
+PFNGLBUFFERSTORAGEPROC glad_glBufferStorage = NULL;
 static void load_GL_VERSION_1_0(GLADloadproc load) {
 	if(!GLAD_GL_VERSION_1_0) return;
 	glad_glCullFace = (PFNGLCULLFACEPROC)load("glCullFace");
@@ -1452,8 +1455,13 @@ static void load_GL_VERSION_4_3(GLADloadproc load) {
 	glad_glGetObjectPtrLabel = (PFNGLGETOBJECTPTRLABELPROC)load("glGetObjectPtrLabel");
 	glad_glGetPointerv = (PFNGLGETPOINTERVPROC)load("glGetPointerv");
 }
+static void load_GL_ARB_buffer_storage(GLADloadproc load) {
+	if(!GLAD_GL_ARB_buffer_storage) return;
+	glad_glBufferStorage = (PFNGLBUFFERSTORAGEPROC)load("glBufferStorage");
+}
 static int find_extensionsGL(void) {
 	if (!get_exts()) return 0;
+	GLAD_GL_ARB_buffer_storage = has_ext("GL_ARB_buffer_storage");
 	GLAD_GL_EXT_texture_filter_anisotropic = has_ext("GL_EXT_texture_filter_anisotropic");
 	free_exts();
 	return 1;
@@ -1541,6 +1549,7 @@ int gladLoadGLLoader(GLADloadproc load) {
 	load_GL_VERSION_4_3(load);
 
 	if (!find_extensionsGL()) return 0;
+	load_GL_ARB_buffer_storage(load);
 	return GLVersion.major != 0 || GLVersion.minor != 0;
 }
 
@@ -84,6 +84,10 @@ namespace sm {
         // Keep track of window state to skip rendering
         bool m_minimized {false};
 
+        // Used to run for a fixed number of frames
+        unsigned int m_max_frames {};
+        unsigned int m_frame_index {};
+
         // Clock variables
         struct {
             double previous_seconds {};
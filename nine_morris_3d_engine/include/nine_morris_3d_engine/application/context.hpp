@@ -1,10 +1,12 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <utility>
 #include <initializer_list>
 #include <functional>
 #include <filesystem>
+#include <cstddef>
 
 #include "nine_morris_3d_engine/application/internal/error.hpp"
 #include "nine_morris_3d_engine/application/internal/file_system.hpp"
@@ -13,6 +15,7 @@
 #include "nine_morris_3d_engine/application/internal/event_dispatcher.hpp"
 #include "nine_morris_3d_engine/application/internal/window.hpp"
 #include "nine_morris_3d_engine/application/internal/task_manager.hpp"
+#include "nine_morris_3d_engine/application/internal/job_system.hpp"
 #include "nine_morris_3d_engine/application/platform.hpp"
 #include "nine_morris_3d_engine/application/properties.hpp"
 #include "nine_morris_3d_engine/application/id.hpp"
@@ -20,6 +23,8 @@
 #include "nine_morris_3d_engine/audio/internal/audio.hpp"
 #include "nine_morris_3d_engine/audio/sound_data.hpp"
 #include "nine_morris_3d_engine/graphics/internal/shader_library.hpp"
+#include "nine_morris_3d_engine/graphics/internal/program_cache.hpp"
+#include "nine_morris_3d_engine/graphics/internal/font_atlas_cache.hpp"
 #include "nine_morris_3d_engine/graphics/internal/renderer.hpp"
 #include "nine_morris_3d_engine/graphics/internal/debug_ui.hpp"
 #include "nine_morris_3d_engine/graphics/opengl/vertex_array.hpp"
@@ -76,10 +81,12 @@ namespace sm {
         std::filesystem::path path_saved_data() const;
         std::filesystem::path path_assets() const;
         std::filesystem::path path_engine_assets() const;
+        std::filesystem::path path_baked_assets() const;
         std::filesystem::path path_logs(const std::filesystem::path& path) const;
         std::filesystem::path path_saved_data(const std::filesystem::path& path) const;
         std::filesystem::path path_assets(const std::filesystem::path& path) const;
         std::filesystem::path path_engine_assets(const std::filesystem::path& path) const;
+        std::filesystem::path path_baked_assets(const std::filesystem::path& path) const;
 
         // Events
         template<typename E, auto F, typename... T>
@@ -103,6 +110,7 @@ namespace sm {
         // Window
         int get_window_width() const;
         int get_window_height() const;
+        bool is_window_headless() const;
         void show_window() const;
         void set_window_vsync(bool enable) const;
         void set_window_icons(std::initializer_list<std::unique_ptr<TextureData>> icons);
@@ -127,7 +135,13 @@ namespace sm {
         void add_task_immediate(Task::Function&& function);
         void add_task_delayed(Task::Function&& function, double delay);
         void add_task_deffered(Task::Function&& function);
-        void add_task_async(AsyncTask::Function&& function);
+
+        // Job system
+        Job add_job(Job::Function&& function, std::initializer_list<Job> dependencies = {});
+        Job add_job(Job::Function&& function, const std::vector<Job>& dependencies);
+        Job add_job_main(Job::Function&& function, std::initializer_list<Job> dependencies = {});
+        Job add_job_main(Job::Function&& function, const std::vector<Job>& dependencies);
+        void wait_job(const Job& job);
 
         // Input
         static bool is_key_pressed(Key key);
@@ -143,15 +157,18 @@ namespace sm {
 
         // Context
         void change_scene(Id id, bool clear_resources = false);
+        // In bytes; once it is exceeded, resources referenced only by the cache are evicted
+        // Thus get functions may return null for resources loaded long before; only meshes and texture data are loaded again
+        void set_resources_memory_budget(std::size_t memory_budget);
         void show_information_text();
         float get_delta() const;
         float get_fps() const;
         std::string get_information() const;
-        std::shared_ptr<Mesh> get_mesh(Id id) const;
-        std::shared_ptr<Mesh> load_mesh(Id id, const std::filesystem::path& file_path, const MeshSpecification& specification);
-        std::shared_ptr<Mesh> load_mesh(const std::filesystem::path& file_path, const MeshSpecification& specification);
+        std::shared_ptr<Mesh> get_mesh(Id id);  // Loaded again from its file, if evicted
+        std::shared_ptr<Mesh> load_mesh(Id id, const std::filesystem::path& file_path);
+        std::shared_ptr<Mesh> load_mesh(const std::filesystem::path& file_path);
         std::shared_ptr<GlVertexArray> load_vertex_array(Id id, std::shared_ptr<Mesh> mesh);
-        std::shared_ptr<TextureData> get_texture_data(Id id) const;
+        std::shared_ptr<TextureData> get_texture_data(Id id);  // Loaded again from its file, if evicted
         std::shared_ptr<TextureData> load_texture_data(const std::filesystem::path& file_path, const TexturePostProcessing& post_processing);
         std::shared_ptr<TextureData> reload_texture_data(const std::filesystem::path& file_path, const TexturePostProcessing& post_processing);
         std::shared_ptr<GlTexture> load_texture(Id id, std::shared_ptr<TextureData> texture_data, const TextureSpecification& specification);
@@ -208,8 +225,11 @@ namespace sm {
         internal::ShaderLibrary m_shd;
         internal::EventDispatcher m_evt;
         internal::Window m_win;
+        internal::ProgramCache m_prg;
+        internal::FontAtlasCache m_atl;
         internal::Renderer m_rnd;
         internal::TaskManager m_tsk;
+        internal::JobSystem m_job;
         internal::ResourcesCache m_res;
 #ifndef SM_BUILD_DISTRIBUTION
         internal::DebugUi m_dbg;
@@ -12,6 +12,7 @@ namespace sm::internal {
             const std::filesystem::path& path_logs,
             const std::filesystem::path& path_saved_data,
             const std::filesystem::path& path_assets,
+            const std::filesystem::path& path_baked_assets,
             const std::filesystem::path& assets_directory
         );
 
@@ -20,6 +21,7 @@ namespace sm::internal {
         static bool is_directory(const std::filesystem::path& path);
         static bool create_directory(const std::filesystem::path& path);
         static bool delete_file(const std::filesystem::path& path);
+        static void rename_file(const std::filesystem::path& path, const std::filesystem::path& new_path);  // Replaces new_path
         static std::filesystem::path current_working_directory();
 
         // Retrieve paths
@@ -27,12 +29,14 @@ namespace sm::internal {
         std::filesystem::path path_saved_data() const;
         std::filesystem::path path_assets() const;
         std::filesystem::path path_engine_assets() const;
+        std::filesystem::path path_baked_assets() const;
 
         // Retrieve concatenated paths
         std::filesystem::path path_logs(const std::filesystem::path& path) const;
         std::filesystem::path path_saved_data(const std::filesystem::path& path) const;
         std::filesystem::path path_assets(const std::filesystem::path& path) const;
         std::filesystem::path path_engine_assets(const std::filesystem::path& path) const;
+        std::filesystem::path path_baked_assets(const std::filesystem::path& path) const;
 
         // Verify if the directory paths exist and create them if necessary
         void check_and_fix_directories() const;
@@ -46,6 +50,7 @@ namespace sm::internal {
         std::filesystem::path m_path_logs;
         std::filesystem::path m_path_saved_data;
         std::filesystem::path m_path_assets;
+        std::filesystem::path m_path_baked_assets;
         std::filesystem::path m_assets_directory;
 
         mutable std::string m_error_string;
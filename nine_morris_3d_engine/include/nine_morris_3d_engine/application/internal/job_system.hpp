@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <exception>
+#include <initializer_list>
+#include <span>
+#include <cstddef>
+
+#include "nine_morris_3d_engine/application/job.hpp"
+
+namespace sm::internal {
+    class DebugUi;
+
+    struct JobState {
+        Job::Function function;
+        std::shared_ptr<std::atomic_bool> stop;  // Shared by the jobs of a scene
+        bool main_thread {false};
+
+        std::atomic<std::size_t> dependencies {};  // Jobs left until this one can be scheduled
+        std::atomic_bool dependency_failed {false};
+
+        std::mutex mutex;  // Guards the following
+        std::vector<std::shared_ptr<JobState>> continuations;
+        bool finished {false};
+        bool failed {false};
+    };
+
+    // Thread safe work stealing thread pool
+    // Every worker has its own queue, pops from its back and steals from the front of the others
+    class JobSystem {
+    public:
+        // Create as many workers as the hardware threads, minus the main thread
+        JobSystem();
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+        JobSystem(JobSystem&&) = delete;
+        JobSystem& operator=(JobSystem&&) = delete;
+
+        // Enqueue a job to run on a worker after its dependencies have finished
+        Job add(Job::Function&& function, std::initializer_list<Job> dependencies = {});
+        Job add(Job::Function&& function, const std::vector<Job>& dependencies);
+
+        // Enqueue a job to run on the main thread after its dependencies have finished
+        Job add_main(Job::Function&& function, std::initializer_list<Job> dependencies = {});
+        Job add_main(Job::Function&& function, const std::vector<Job>& dependencies);
+
+        // Wait for a job to finish, executing other jobs in the meantime; may be called from any thread
+        // The main thread also executes the ready main thread jobs, as it would otherwise wait on them forever
+        void wait(const Job& job);
+
+        // Execute the ready main thread jobs; throw the last exception from the workers (if any)
+        void update();
+
+        // Cancel the jobs of the current scene and wait for the running ones; throw the last exception (if any)
+        void cancel();
+
+        std::size_t get_thread_count() const;
+    private:
+        struct Worker {
+            std::deque<std::shared_ptr<JobState>> queue;
+            std::mutex mutex;
+        };
+
+        Job create(Job::Function&& function, std::span<const Job> dependencies, bool main_thread);
+        void schedule(std::shared_ptr<JobState> state);
+        void execute(const std::shared_ptr<JobState>& state);
+        void finish(const std::shared_ptr<JobState>& state, bool failed);
+        bool execute_main_jobs();
+        bool try_execute(std::size_t worker_index);
+        std::shared_ptr<JobState> pop(std::size_t worker_index);
+        void worker_loop(std::size_t worker_index);
+        void throw_exception();
+
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::vector<std::thread> m_threads;
+        std::atomic<std::size_t> m_next_worker {};  // For jobs added outside of workers
+        std::thread::id m_main_thread;  // The one which created the job system
+
+        std::mutex m_sleep_mutex;
+        std::condition_variable m_sleep;
+        std::atomic<std::size_t> m_queued {};  // Jobs waiting in the worker queues
+        bool m_running {true};
+
+        std::atomic<std::size_t> m_unfinished {};  // Jobs added, but not yet finished
+        std::shared_ptr<std::atomic_bool> m_stop;  // Stop flag of the current scene
+        std::mutex m_stop_mutex;
+
+        std::vector<std::shared_ptr<JobState>> m_main_jobs;
+        std::mutex m_main_mutex;
+
+        std::exception_ptr m_exception;
+        std::mutex m_exception_mutex;
+
+        friend class DebugUi;
+    };
+}
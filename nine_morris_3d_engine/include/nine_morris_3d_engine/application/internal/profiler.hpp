@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+#include <filesystem>
+#include <cstdint>
+#include <cstddef>
+
+#include "nine_morris_3d_engine/application/platform.hpp"
+
+namespace sm::internal {
+    namespace profiler {
+        // A timed section of a frame; times are in microseconds since initialization
+        struct Zone {
+            const char* name {};  // Must outlive the profiler, so use string literals
+            double begin {};
+            double duration {};
+            std::size_t thread {};
+            unsigned int depth {};
+        };
+
+        struct Frame {
+            std::uint64_t index {};
+            double begin {};
+            double duration {};
+            std::vector<Zone> cpu_zones;
+            std::vector<Zone> gpu_zones;  // Filled in a few frames later, when the timer queries are ready
+            bool gpu_ready {false};
+        };
+
+        // Create the timer queries; must be called after the OpenGL context is created
+        void initialize();
+
+        // Delete the timer queries
+        void uninitialize();
+
+        // Called by the application around every frame, on the main thread
+        void begin_frame();
+        void end_frame();
+
+        // Time a section of the CPU; can be called from any thread
+        void begin_zone(const char* name);
+        void end_zone();
+
+        // Time a section of the GPU; called on the main thread, and GPU zones must not overlap
+        void begin_gpu_zone(const char* name);
+        void end_gpu_zone();
+
+        // Get the last finished frame, or the last one with GPU timings; null if there is none
+        const Frame* get_last_frame();
+        const Frame* get_last_gpu_frame();
+
+        // Write the recent frames in the Chrome trace event format, to be opened in chrome://tracing or Perfetto
+        void export_chrome_trace(const std::filesystem::path& file_path);
+
+        class Scope {
+        public:
+            explicit Scope(const char* name) {
+                begin_zone(name);
+            }
+
+            ~Scope() {
+                end_zone();
+            }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+            Scope(Scope&&) = delete;
+            Scope& operator=(Scope&&) = delete;
+        };
+
+        // Times both the CPU and the GPU
+        class GpuScope {
+        public:
+            explicit GpuScope(const char* name) {
+                begin_zone(name);
+                begin_gpu_zone(name);
+            }
+
+            ~GpuScope() {
+                end_gpu_zone();
+                end_zone();
+            }
+
+            GpuScope(const GpuScope&) = delete;
+            GpuScope& operator=(const GpuScope&) = delete;
+            GpuScope(GpuScope&&) = delete;
+            GpuScope& operator=(GpuScope&&) = delete;
+        };
+    }
+}
+
+#define SM_PROFILE_CONCATENATE_IMPL(a, b) a##b
+#define SM_PROFILE_CONCATENATE(a, b) SM_PROFILE_CONCATENATE_IMPL(a, b)
+
+// Profile the rest of the current scope; compiled out in distribution mode
+#ifndef SM_BUILD_DISTRIBUTION
+    #define SM_PROFILE_SCOPE(name) const sm::internal::profiler::Scope SM_PROFILE_CONCATENATE(profile_scope_, __LINE__) {name}
+    #define SM_PROFILE_GPU_SCOPE(name) const sm::internal::profiler::GpuScope SM_PROFILE_CONCATENATE(profile_scope_, __LINE__) {name}
+#else
+    #define SM_PROFILE_SCOPE(name)
+    #define SM_PROFILE_GPU_SCOPE(name)
+#endif
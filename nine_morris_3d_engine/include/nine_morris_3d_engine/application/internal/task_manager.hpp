@@ -2,7 +2,6 @@
 
 #include <vector>
 #include <mutex>
-#include <memory>
 
 #include "nine_morris_3d_engine/application/task.hpp"
 
@@ -12,7 +11,7 @@ namespace sm::internal {
     // Thread safe tasks API
     class TaskManager {
     public:
-        // Enqueue a normal task (guaranteed to be executed if added from inside an async task)
+        // Enqueue a normal task (guaranteed to be executed if added from inside a job)
         void add_immediate(Task::Function&& function);
 
         // Enqueue a delayed task
@@ -21,28 +20,18 @@ namespace sm::internal {
         // Enqueue a deffered task (by one frame)
         void add_deffered(Task::Function&& function);
 
-        // Enqueue an asynchronous task (running in a thread)
-        void add_async(AsyncTask::Function&& function);
-
         // Execute tasks
         void update();
 
-        // Join asynchronous tasks to complete; throw the last exception (if any)
-        void wait_async();
-
         // Remove all (normal) tasks
         void clear();
     private:
         void update_tasks();
-        void update_async_tasks();
 
         std::vector<Task> m_tasks_active;  // Front list
         std::vector<Task> m_tasks_next;  // Back list
         std::mutex m_mutex;
 
-        std::vector<std::unique_ptr<AsyncTask>> m_async_tasks;
-        std::mutex m_async_mutex;
-
         friend class DebugUi;
     };
 }
@@ -27,9 +27,12 @@ namespace sm::internal {
         // Get current window height
         int get_height() const;
 
-        // Show the window (it is always created hidden)
+        // Show the window (it is always created hidden); does nothing when headless
         void show() const;
 
+        // Check if the window is never shown and rendering happens offscreen
+        bool is_headless() const { return m_headless; }
+
         // Set VSync
         void set_vsync(bool enable) const;
 
@@ -56,6 +59,7 @@ namespace sm::internal {
     private:
         int m_width {};
         int m_height {};
+        bool m_headless {false};
 
         SDL_Window* m_window {};
         void* m_context {};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace sm {
+    namespace internal {
+        class JobSystem;
+        struct JobState;
+    }
+
+    // Handle to a procedure executed by the job system, bound to the calling scene
+    // Jobs are either executed on a worker thread, or on the main thread, as continuations of other jobs
+    // Jobs which haven't started when the scene stops are cancelled
+    class Job {
+    public:
+        using Function = std::function<void()>;
+
+        Job() = default;
+
+        // Find out if the job has finished, either by executing, by failing or by being cancelled
+        bool done() const;
+
+        // Find out, from inside a job, if its scene has stopped, so that long jobs may return early
+        static bool stop_requested();
+
+        // Find out if the handle refers to a job
+        explicit operator bool() const { return m_state != nullptr; }
+    private:
+        explicit Job(std::shared_ptr<internal::JobState> state)
+            : m_state(std::move(state)) {}
+
+        std::shared_ptr<internal::JobState> m_state;
+
+        friend class internal::JobSystem;
+    };
+}
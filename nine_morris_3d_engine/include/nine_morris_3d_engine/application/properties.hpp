@@ -8,6 +8,8 @@ namespace sm {
         bool fullscreen {false};
         bool resizable {true};
         bool default_renderer_parameters {true};
+        bool headless {false};  // Render offscreen without a visible window and without audio output
+        unsigned int max_frames {0};  // Stop after this many frames; zero means no limit
         int width {1280};
         int height {720};
         int min_width {-1};
@@ -23,6 +25,7 @@ namespace sm {
         std::filesystem::path path_logs;
         std::filesystem::path path_saved_data;
         std::filesystem::path path_assets;
+        std::filesystem::path path_baked_assets;  // Assets generated by the build, like the meshes
         void* user_data {};
     };
 }
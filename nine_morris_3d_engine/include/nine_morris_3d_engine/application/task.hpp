@@ -1,13 +1,8 @@
 #pragma once
 
 #include <functional>
-#include <thread>
-#include <atomic>
-#include <exception>
 #include <utility>
 
-#include "nine_morris_3d_engine/application/internal/error.hpp"
-
 namespace sm {
     namespace internal {
         class TaskManager;
@@ -36,48 +31,4 @@ namespace sm {
 
         friend class internal::TaskManager;
     };
-
-    // Long-lived procedure executed on a separate thread, bound to the calling scene
-    class AsyncTask {
-    public:
-        using Function = std::function<void(AsyncTask&)>;
-
-        explicit AsyncTask(Function&& function)
-            : m_thread(std::move(function), std::ref(*this)) {}
-
-        ~AsyncTask() {
-            m_thread.join();
-        }
-
-        AsyncTask(const AsyncTask&) = delete;
-        AsyncTask& operator=(const AsyncTask&) = delete;
-        AsyncTask(AsyncTask&&) = delete;
-        AsyncTask& operator=(AsyncTask&&) = delete;
-
-        // Signal that this task has finished successfully
-        // Must be called
-        void set_done() {
-            m_done.store(true);
-        }
-
-        // Signal that this task has finished with an error
-        // Must be called
-        void set_done(std::exception_ptr exception) {
-            m_exception = exception;
-            m_done.store(true);
-        }
-
-        // Find out if the application wants to stop this task (ex: the application is closing)
-        // Used by the user to prematurely stop a task, if possible, in order to avoid stalling the application
-        bool stop_requested() const {
-            return m_stop.load();
-        }
-    private:
-        std::thread m_thread;
-        std::atomic_bool m_done {false};  // Must be set by the user before the task finishes
-        std::atomic_bool m_stop {false};  // Set by task manager
-        std::exception_ptr m_exception;
-
-        friend class internal::TaskManager;
-    };
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <filesystem>
+#include <cstddef>
 
 namespace sm {
     // Resource representing a short sound
@@ -16,7 +17,11 @@ namespace sm {
 
         // Retrieve the sound data
         void* get_data() const { return m_data; }
+
+        // Size of the decoded samples in bytes
+        std::size_t get_size() const { return m_size; }
     private:
         void* m_data {};
+        std::size_t m_size {};
     };
 }
@@ -4,23 +4,30 @@
 #include <vector>
 #include <utility>
 #include <string>
+#include <cstdint>
 
 #include "nine_morris_3d_engine/graphics/opengl/texture.hpp"
 
 struct stbtt_fontinfo;
-struct stbtt_pack_context;
+
+namespace sm::internal {
+    struct FontAtlas;
+    class FontAtlasCache;
+}
 
 namespace sm {
     // Font parameters
     struct FontSpecification {
         float size_height {16.0f};
         int bitmap_size {128};
+        bool distance_field {false};  // Store signed distances to the glyph outlines, generated at 40 pixels or more, so that they can be scaled
     };
 
     // Resource representing a font
     class Font {
     public:
-        Font(const std::string& buffer, const FontSpecification& specification = {});
+        // The atlas cache is optional and must outlive the font
+        Font(const std::string& buffer, const FontSpecification& specification = {}, const internal::FontAtlasCache* cache = nullptr);
         ~Font();
 
         Font(const Font&) = delete;
@@ -31,11 +38,20 @@ namespace sm {
         // Get the texture containing the glyphs
         const GlTexture* get_bitmap() const;
 
+        // Distance field fonts must be rendered with the distance field shader
+        bool is_distance_field() const;
+
+        // Value of the glyph outlines in distance field bitmaps
+        static constexpr int DISTANCE_FIELD_EDGE {128};
+
         // Baking API
+        // Characters are only recorded; the atlas is packed, or loaded from the cache, by pack() or by end_baking()
+        // Packing doesn't touch OpenGL, so it may be done on another thread; end_baking() must be called on the main thread
         void begin_baking();
         void end_baking(const char* name = nullptr);
-        void bake_characters(int begin_codepoint, int end_codepoint);
+        void bake_characters(int begin_codepoint, int count);
         void bake_ascii();
+        void pack();
 
         struct CharacterBuffer {
             float f0, f1, f2, f3;
@@ -65,6 +81,10 @@ namespace sm {
         };
 
         void get_character_quad(int codepoint, float* x, float* y, Quad* quad) const;
+        void pack_bitmap();
+        void pack_distance_field();
+        bool load_atlas(internal::FontAtlas&& atlas);
+        void free_pack_ranges();
         static void write_bitmap_to_file(const char* name, const unsigned char* bitmap, int size);
 
         struct PackRange {
@@ -76,15 +96,17 @@ namespace sm {
 
         std::unique_ptr<unsigned char[]> m_bitmap;
         std::vector<PackRange> m_pack_ranges;
-        stbtt_pack_context* m_pack_context {};
+        bool m_packed {false};
 
         std::unique_ptr<GlTexture> m_bitmap_texture;
 
         std::string m_font_buffer;
         stbtt_fontinfo* m_font_info {};
+        const internal::FontAtlasCache* m_cache {};
 
         float m_size_height {};
         int m_bitmap_size {};
+        bool m_distance_field {false};
 
         float m_sf {};  // Scale factor
         float m_baseline {};
@@ -5,6 +5,7 @@
 #include <glm/glm.hpp>
 
 #include "nine_morris_3d_engine/application/platform.hpp"
+#include "nine_morris_3d_engine/application/internal/profiler.hpp"
 #include "nine_morris_3d_engine/graphics/scene.hpp"
 
 namespace sm {
@@ -28,6 +29,9 @@ namespace sm::internal {
         void texts(const Scene& scene);
         void tasks(Ctx& ctx);
         void frame_time(Ctx& ctx);
+        void renderer(Ctx& ctx);
+        void resources(Ctx& ctx);
+        void frame_profiler(Ctx& ctx);
 
         void shadows_lines(
             const Scene& scene,
@@ -49,11 +53,15 @@ namespace sm::internal {
         bool m_texts {false};
         bool m_tasks {false};
         bool m_frame_time {false};
+        bool m_renderer {false};
+        bool m_resources {false};
+        bool m_profiler {false};
 
         std::vector<ModelNode*> m_model_nodes;
         std::vector<PointLightNode*> m_point_light_nodes;
         std::vector<ImageNode*> m_image_nodes;
         std::vector<TextNode*> m_text_nodes;
+        std::vector<profiler::Zone> m_profiler_zones;
 
         static constexpr std::size_t FRAMES_SIZE {100};
         std::vector<float> m_frames {FRAMES_SIZE};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <filesystem>
+#include <cstdint>
+
+#include "nine_morris_3d_engine/application/internal/file_system.hpp"
+#include "nine_morris_3d_engine/graphics/font.hpp"
+
+namespace sm::internal {
+    // Result of packing the glyphs of a font
+    struct FontAtlas {
+        std::string bitmap;  // Single channel, bitmap size squared
+        std::vector<std::string> packed_characters;  // Tables of every range, in the order they were baked
+    };
+
+    // On-disk cache of baked font atlases, so that fonts are not packed on every launch
+    // Atlases are keyed by the font file, its specification and the baked ranges; can be used from any thread
+    class FontAtlasCache {
+    public:
+        explicit FontAtlasCache(const FileSystem& fs);
+
+        bool is_enabled() const;
+
+        // Ranges are pairs of begin codepoint and count
+        std::uint64_t key(std::string_view font_buffer, const FontSpecification& specification, const std::vector<std::pair<int, int>>& ranges) const;
+
+        // Return nothing, if the atlas is not cached, or if the file is invalid
+        std::optional<FontAtlas> load(std::uint64_t key) const;
+
+        // Fail silently
+        void store(std::uint64_t key, const FontAtlas& atlas) const;
+    private:
+        std::filesystem::path file_path(std::uint64_t key) const;
+
+        std::filesystem::path m_directory;
+        bool m_enabled {false};
+    };
+}
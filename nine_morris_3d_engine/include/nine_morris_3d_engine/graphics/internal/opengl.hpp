@@ -31,15 +31,26 @@ namespace sm::internal {
         // Set the viewport for the active framebuffer
         void viewport(int width, int height);
 
-        // Bind a 2D texture
+        // Bind a 2D texture; does nothing, if it's already bound to that unit
         void bind_texture_2d(unsigned int texture, int unit);
 
+        // Forget which 2D textures are bound; call it after binding or deleting 2D textures directly
+        void invalidate_texture_2d_bindings();
+
+        // Upload uniforms of the bound program by location
+        void uniform_mat4(int location, const float* matrix);
+        void uniform_int(int location, int value);
+        void uniform_float(int location, float value);
+        void uniform_vec2(int location, const float* vector);
+        void uniform_vec3(int location, const float* vector);
+        void uniform_vec4(int location, const float* vector);
+
         // Draw call routines
-        void draw_arrays(int count);
-        void draw_arrays_lines(int count);
-        void draw_elements(int count);
-        void draw_elements_instanced(int count, int instance_count);
-        void draw_elements_adjacency(int count);
+        void draw_arrays(int count, int first = 0);
+        void draw_arrays_lines(int count, int first = 0);
+        void draw_elements(int count, int base_vertex = 0);
+        void draw_elements_instanced(int count, int instance_count, int base_instance = 0);
+        void draw_elements_adjacency_instanced(int count, int instance_count, int base_instance = 0);
 
         // Depth test state
         void disable_depth_test();
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <filesystem>
+#include <initializer_list>
+#include <cstdint>
+
+#include "nine_morris_3d_engine/application/internal/file_system.hpp"
+#include "nine_morris_3d_engine/graphics/opengl/buffer.hpp"
+
+namespace sm::internal {
+    // Linked program retrieved from the driver, together with the data from introspection
+    struct ProgramBinary {
+        unsigned int format {};
+        std::string data;
+        std::vector<std::string> uniforms;
+        std::vector<UniformBlockSpecification> uniform_blocks;
+    };
+
+    // On-disk cache of shader program binaries, so that shaders are not compiled on every launch
+    // Programs are keyed by their preprocessed sources and by the driver, as binaries are specific to it
+    // Disabled when the driver doesn't support any binary format; must be created after the OpenGL context
+    class ProgramCache {
+    public:
+        explicit ProgramCache(const FileSystem& fs);
+
+        bool is_enabled() const;
+
+        // Hash the sources of the program stages together with the driver
+        std::uint64_t key(std::initializer_list<std::string_view> sources) const;
+
+        // Return nothing, if the program is not cached, or if the file is invalid
+        std::optional<ProgramBinary> load(std::uint64_t key) const;
+
+        // Fail silently
+        void store(std::uint64_t key, const ProgramBinary& binary) const;
+    private:
+        std::filesystem::path file_path(std::uint64_t key) const;
+
+        std::filesystem::path m_directory;
+        std::string m_driver;
+        std::vector<int> m_formats;  // Accepted by the driver
+        bool m_enabled {false};
+    };
+}
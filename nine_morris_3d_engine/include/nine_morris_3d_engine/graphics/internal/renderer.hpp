@@ -5,12 +5,16 @@
 #include <unordered_map>
 #include <memory>
 #include <utility>
+#include <cstdint>
+#include <cstddef>
 
 #include <glm/glm.hpp>
 
 #include "nine_morris_3d_engine/application/internal/file_system.hpp"
 #include "nine_morris_3d_engine/application/platform.hpp"
 #include "nine_morris_3d_engine/graphics/internal/shader_library.hpp"
+#include "nine_morris_3d_engine/graphics/internal/program_cache.hpp"
+#include "nine_morris_3d_engine/graphics/internal/font_atlas_cache.hpp"
 #include "nine_morris_3d_engine/graphics/internal/post_processing_context.hpp"
 #include "nine_morris_3d_engine/graphics/opengl/shader.hpp"
 #include "nine_morris_3d_engine/graphics/opengl/framebuffer.hpp"
@@ -20,6 +24,7 @@
 namespace sm {
     class GlVertexArray;
     class GlVertexBuffer;
+    class GlStreamBuffer;
     class GlUniformBuffer;
 }
 
@@ -31,12 +36,28 @@ namespace sm::internal {
         int shadow_map_size {2048};
     };
 
+    // Counters collected during the last rendered frame
+    struct RendererStatistics {
+        std::size_t draw_items {};
+        std::size_t drawn_items {};  // Main pass, after frustum culling
+        std::size_t culled_items {};
+        std::size_t drawn_shadow_items {};  // Shadow pass, after shadow box culling
+        std::size_t culled_shadow_items {};
+        std::size_t draw_calls {};
+        std::size_t shader_changes {};
+        std::size_t material_changes {};
+        std::size_t vertex_array_changes {};
+        std::size_t culling_changes {};
+        std::size_t streamed_bytes {};  // Written to stream buffers
+    };
+
     // Main class responsible for rendering stuff on the screen
     class Renderer {
     public:
-        Renderer(int width, int height, const FileSystem& fs, const ShaderLibrary& shd);
+        Renderer(int width, int height, const FileSystem& fs, const ShaderLibrary& shd, const ProgramCache& prg);
 
         // Retrieve the default font; it is null until the renderer is fully initialized
+        // It's a distance field font, thus it's the same for all scales; text using it should be scaled by get_scale()
         std::shared_ptr<Font> get_default_font() const;
 
         // Color correction (sRGB)
@@ -50,13 +71,14 @@ namespace sm::internal {
         void set_samples(int width, int height, int samples);
 
         // Set global scale
-        void set_scale(const FileSystem& fs, int scale);
+        void set_scale(int scale);
+        int get_scale() const;
 
         // Set the size of the shadow map; must be a power of 2
         void set_shadow_map_size(int size);
 
         // Fully initialize the renderer
-        void initialize(int width, int height, const FileSystem& fs, const RendererSpecification& specification = {});
+        void initialize(int width, int height, const FileSystem& fs, const FontAtlasCache& atl, const RendererSpecification& specification = {});
 
         // Register refereneces to shaders and framebuffers in order for the renderer to do special things
         void register_shader(std::shared_ptr<GlShader> shader);
@@ -77,7 +99,78 @@ namespace sm::internal {
 
         // Get the maximum supported point lights
         static std::size_t get_max_point_lights();
+
+        // Get the statistics of the last frame
+        const RendererStatistics& get_statistics() const;
     private:
+        // A model from the 3D scene, flattened once per frame and consumed by all passes
+        struct DrawItem {
+            glm::mat4 transform {1.0f};
+            std::uint64_t sort_key {};  // Shader, material and vertex array, from most to least significant
+            const ModelNode* model_node {};
+            const OutlinedModelNode* outlined_model_node {};  // Set only for outlined models
+            int index_count {};
+            bool outline {false};
+            bool disable_back_face_culling {false};
+            bool cast_shadow {false};
+        };
+
+        // Per-instance attributes of the model vertex arrays
+        struct Instance {
+            glm::mat4 model_matrix {1.0f};
+            glm::vec4 outline {};  // Color and width; only read by the outline pass
+            glm::vec4 highlight {};  // Color; only read by the model pass
+        };
+
+        struct PointLightItem {
+            const PointLightNode* point_light_node {};
+            glm::vec3 position {};
+            float distance {};  // To the camera
+        };
+
+        // Offsets of the fields of one element of the point lights array in the uniform buffer
+        struct PointLightFields {
+            std::size_t position {};
+            std::size_t ambient {};
+            std::size_t diffuse {};
+            std::size_t specular {};
+            std::size_t falloff_linear {};
+            std::size_t falloff_quadratic {};
+        };
+
+        // World space bounding boxes of the draw items, laid out for batched plane tests
+        struct DrawBounds {
+            std::vector<float> center_x;
+            std::vector<float> center_y;
+            std::vector<float> center_z;
+            std::vector<float> extent_x;
+            std::vector<float> extent_y;
+            std::vector<float> extent_z;
+        };
+
+        // Draw items that share state, merged into one instanced draw
+        struct DrawBatch {
+            const DrawItem* item {};  // The first one; the others share its state
+            int base_instance {};
+            int instance_count {};
+        };
+
+        // What is currently bound, so that redundant state changes are skipped
+        struct BindState {
+            const GlShader* shader {};
+            const MaterialInstance* material {};
+            const GlVertexArray* vertex_array {};
+        };
+
+        void extract_scene(const Scene& scene);
+        void extract_node(const SceneNode3D* node, Context3D context);
+        std::uint64_t calculate_sort_key(const ModelNode* model_node);
+        void calculate_bounds();
+        std::size_t cull(const glm::mat4& projection_view, std::vector<unsigned char>& visible) const;
+        void batch_models(const Scene& scene);
+        static void clip_batches(std::vector<DrawBatch>& batches, std::size_t instance_count);
+        void attach_instance_buffer(GlVertexArray* vertex_array) const;
+
         void set_and_upload_uniform_buffer_data(const Scene& scene);
         void post_processing(const Scene& scene);
         void finish_3d(const Scene& scene, int width, int height);
@@ -86,22 +179,24 @@ namespace sm::internal {
         void clear_expired_resources();
 
         // Draw functions
-        void draw_models(const Scene& scene);
-        void draw_model(const ModelNode* model_node, const Context3D& context);
+        void draw_models();
+        void draw_model(const DrawBatch& batch, BindState& state);
 
-        void draw_models_outlined(const Scene& scene);
-        void draw_model_outlined(const Scene& scene, const OutlinedModelNode* outlined_model_node, const Context3D& context);
+        void draw_models_outlined();
 
-        void draw_models_to_shadow_map(const Scene& scene);
+        void draw_models_to_shadow_map();
         void draw_skybox(const Scene& scene);
 
         struct TextBatch {
             std::shared_ptr<Font> font;
             std::vector<std::pair<const TextNode*, Context2D>> texts;
+            std::size_t first_character {};  // Where its characters begin in the buffer
+            std::size_t character_count {};
         };
 
         void draw_texts(const Scene& scene);
         void draw_text_batch(const Scene& scene, const TextBatch& batch);
+        static const std::vector<Font::CharacterBuffer>& layout_text(const TextNode* text_node);
 
         void draw_images(const Scene& scene);
         void draw_image(const ImageNode* image_node, const Context2D& context);
@@ -110,11 +205,12 @@ namespace sm::internal {
         void flush_images_batch();
 
         // Helper functions
+        void setup_point_light_fields(const GlUniformBuffer& uniform_buffer);
         void setup_point_light_uniform_buffer(const Scene& scene, std::shared_ptr<GlUniformBuffer> uniform_buffer);
         void setup_light_space_uniform_buffer(const Scene& scene, std::shared_ptr<GlUniformBuffer> uniform_buffer);
         void setup_scene_framebuffer(int width, int height, int samples);
         void setup_shadow_framebuffer(int size);
-        void setup_default_font(const FileSystem& fs, int scale);
+        void setup_default_font(const FileSystem& fs, const FontAtlasCache& atl);
         std::shared_ptr<GlIndexBuffer> initialize_quads_index_buffer();
 
         struct QuadVertex {
@@ -131,6 +227,7 @@ namespace sm::internal {
             std::unique_ptr<GlShader> screen_quad_shader;
             std::shared_ptr<GlShader> shadow_shader;
             std::unique_ptr<GlShader> text_shader;
+            std::unique_ptr<GlShader> text_distance_field_shader;
             std::unique_ptr<GlShader> quad_shader;
             std::unique_ptr<GlShader> skybox_shader;
             std::shared_ptr<GlShader> outline_shader;
@@ -143,11 +240,14 @@ namespace sm::internal {
             std::shared_ptr<Font> default_font;
 
             std::weak_ptr<GlVertexBuffer> wtext_vertex_buffer;
-            std::weak_ptr<GlVertexBuffer> wquad_vertex_buffer;
+            std::weak_ptr<GlStreamBuffer> wquad_stream_buffer;
+            std::shared_ptr<GlStreamBuffer> instance_stream_buffer;  // Shared by all model and outline vertex arrays
 
             struct {
+                std::vector<std::pair<const TextNode*, Context2D>> nodes;
                 std::vector<TextBatch> batches;
-                std::vector<Font::CharacterBuffer> batch_buffer;
+                std::vector<Font::CharacterBuffer> buffer;  // Characters of all batches
+                std::vector<Font::CharacterBuffer> uploaded_buffer;  // What the vertex buffer contains
                 std::vector<glm::mat4> batch_matrices;
                 std::vector<glm::vec3> batch_colors;
             } text;
@@ -158,19 +258,38 @@ namespace sm::internal {
                 std::array<unsigned int, 8> textures {};
                 std::size_t texture_index {};
                 std::size_t quad_count {};
+                int base_vertex {};  // Where the batch begins in the stream buffer
             } quad;
 
+            struct {
+                std::vector<DrawItem> items;
+                std::vector<PointLightItem> point_lights;
+                std::unordered_map<const MaterialInstance*, std::uint32_t> material_ordinals;
+                DrawBounds bounds;
+                std::vector<unsigned char> visible;  // Per item, to the camera
+                std::vector<unsigned char> visible_shadow;  // Per item, to the light
+                std::vector<DrawBatch> batches;
+                std::vector<DrawBatch> shadow_batches;
+                std::vector<DrawBatch> outline_batches;
+                std::vector<std::size_t> shadow_order;
+                std::vector<std::size_t> outline_order;
+                std::vector<Instance> instances;  // Of all passes
+            } scene;
+
             std::vector<std::weak_ptr<GlShader>> shaders;
             std::vector<std::weak_ptr<GlFramebuffer>> framebuffers;
             std::unordered_map<unsigned int, std::weak_ptr<GlUniformBuffer>> uniform_buffers;
+            std::vector<PointLightFields> point_light_fields;  // Resolved when the buffer is created
         } m_storage;
 
         PostProcessingContext m_post_processing_context;
+        RendererStatistics m_statistics;
         glm::vec3 m_clear_color {};
         bool m_color_correction {true};
+        int m_scale {1};
 
 #ifndef SM_BUILD_DISTRIBUTION
-        void debug_initialize(const FileSystem& fs);
+        void debug_initialize(const FileSystem& fs, const ProgramCache& prg);
         void debug_render(const Scene& scene);
 
         struct BufferVertex {
@@ -180,7 +299,7 @@ namespace sm::internal {
 
         struct {
             std::shared_ptr<GlShader> shader;
-            std::weak_ptr<GlVertexBuffer> wvertex_buffer;
+            std::weak_ptr<GlStreamBuffer> wstream_buffer;
             std::unique_ptr<GlVertexArray> vertex_array;
 
             std::vector<BufferVertex> lines_buffer;
@@ -195,8 +314,16 @@ namespace sm::internal {
         static constexpr std::size_t SHADER_MAX_POINT_LIGHTS {4};
         static constexpr std::size_t SHADER_MAX_BATCH_TEXTS {32};  // This should never reach the limit
         static constexpr int SHADOW_MAP_UNIT {2};
+        static constexpr unsigned int INSTANCE_MODEL_MATRIX_LOCATION {8};
+        static constexpr unsigned int INSTANCE_OUTLINE_LOCATION {12};
+        static constexpr unsigned int INSTANCE_HIGHLIGHT_LOCATION {13};
+        static constexpr std::size_t MAX_INSTANCE_COUNT {4096};  // Of all passes in a frame
         static constexpr std::size_t MAX_QUAD_COUNT {1000};
         static constexpr std::size_t MAX_QUADS_BUFFER_SIZE {MAX_QUAD_COUNT * 4 * sizeof(QuadVertex)};
         static constexpr std::size_t MAX_QUADS_INDICES {MAX_QUAD_COUNT * 6};
+        static constexpr std::size_t QUADS_STREAM_REGION_SIZE {MAX_QUADS_BUFFER_SIZE * 2};  // Fits two batches per frame
+#ifndef SM_BUILD_DISTRIBUTION
+        static constexpr std::size_t MAX_DEBUG_LINES {16384};
+#endif
     };
 }
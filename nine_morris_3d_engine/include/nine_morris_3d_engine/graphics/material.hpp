@@ -3,6 +3,9 @@
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
 
 #include <glm/glm.hpp>
 
@@ -31,6 +34,7 @@ namespace sm {
         void add_texture(Id name);
     private:
         std::shared_ptr<GlShader> m_shader;
+        std::uint64_t m_id {};  // Unique for the whole run, unlike the address
 
         std::unordered_set<Id, Hash> m_uniforms_mat4;
         std::unordered_set<Id, Hash> m_uniforms_int;
@@ -49,6 +53,7 @@ namespace sm {
         explicit MaterialInstance(std::shared_ptr<Material> material);
 
         void bind_and_upload() const;
+        void upload() const;  // The shader must be already bound; unchanged values are skipped
 
         void set_mat4(Id name, const glm::mat4& matrix);
         void set_int(Id name, int integer);
@@ -80,11 +85,26 @@ namespace sm {
             unsigned int texture {};
         };
 
+        // Uniform resolved once at creation, so that uploading needs no lookups
+        struct Binding {
+            int location {};
+            Element::Type type {};
+            std::size_t offset {};
+        };
+
+        void add_element(Id name, Element::Type type, std::size_t& offset);
+        void upload_binding(const Binding& binding) const;
+        void bind_texture(const Binding& binding) const;
+        static std::size_t element_size(Element::Type type);
+
         std::shared_ptr<GlShader> m_shader;
+        std::shared_ptr<Material> m_material;  // Determines the layout of the data
 
         std::unique_ptr<unsigned char[]> m_data;
         std::size_t m_size {};
+        mutable bool m_dirty {true};  // Set when the data changes after the last upload
 
         std::unordered_map<Id, Element, Hash> m_offsets;
+        std::vector<Binding> m_bindings;
     };
 }
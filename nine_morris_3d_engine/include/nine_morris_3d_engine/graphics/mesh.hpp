@@ -1,9 +1,11 @@
 #pragma once
 
-#include <string>
 #include <memory>
+#include <filesystem>
+#include <cstdint>
 #include <cstddef>
 
+#include "nine_morris_3d_engine/other/internal/mapped_file.hpp"
 #include "nine_morris_3d_engine/other/utilities.hpp"
 
 namespace sm {
@@ -15,20 +17,30 @@ namespace sm {
         PNTT
     };
 
-    static constexpr const char* MESH_DEFAULT_OBJECT {"defaultobject"};
+    // Baked mesh files start with this header, followed by the vertex data and then the index data
+    // They are written by the mesh baker tool
+    struct BakedMeshHeader {
+        static constexpr std::uint32_t MAGIC {0x48534d53};  // SMSH
+        static constexpr std::uint32_t VERSION {1};
 
-    struct MeshSpecification {
-        std::string object_name {MESH_DEFAULT_OBJECT};
-        MeshType type {MeshType::P};
-        bool generate_adjacency_indices {false};
-        bool flip_winding {false};
+        std::uint32_t magic {MAGIC};
+        std::uint32_t version {VERSION};
+        std::uint32_t type {};  // MeshType
+        std::uint32_t adjacency {};  // Whether the indices are of triangles with adjacency
+        float aabb_min[3] {};
+        float aabb_max[3] {};
+        std::uint64_t vertex_count {};
+        std::uint64_t vertices_size {};
+        std::uint64_t index_count {};
+        std::uint64_t indices_size {};
     };
 
     // Resource representing a mesh with vertices and indices
     // It is used to create a vertex array
     class Mesh {
     public:
-        Mesh(const std::string& buffer, const MeshSpecification& specification);
+        // Load a baked mesh; the file is mapped and its data is not copied
+        explicit Mesh(const std::filesystem::path& file_path);
         ~Mesh() = default;
 
         Mesh(const Mesh&) = delete;
@@ -42,19 +54,19 @@ namespace sm {
         std::size_t get_indices_size() const;
         const utils::AABB& get_aabb() const;
         MeshType get_type() const;
+        bool has_adjacency_indices() const;
     private:
-        void load(const MeshSpecification& specification, const void* pmesh);
-        void allocate_vertices(const void* source, std::size_t size);
-        void allocate_indices(const void* source, std::size_t size);
+        std::unique_ptr<internal::MappedFile> m_file;
 
-        // Raw data
-        std::unique_ptr<unsigned char[]> m_vertices;
-        std::unique_ptr<unsigned char[]> m_indices;
+        // Raw data, pointing into the file
+        const unsigned char* m_vertices {};
+        const unsigned char* m_indices {};
         std::size_t m_vertices_size {};
         std::size_t m_indices_size {};
 
         utils::AABB m_aabb;
 
-        MeshType m_type;
+        MeshType m_type {MeshType::P};
+        bool m_adjacency {false};
     };
 }
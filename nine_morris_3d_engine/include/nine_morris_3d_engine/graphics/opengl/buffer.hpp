@@ -2,7 +2,9 @@
 
 #include <unordered_map>
 #include <vector>
+#include <array>
 #include <string>
+#include <cstddef>
 
 #include "nine_morris_3d_engine/application/id.hpp"
 
@@ -32,11 +34,52 @@ namespace sm {
         void bind() const;
         static void unbind();
 
-        void upload_data(const void* data, std::size_t size) const;
+        void upload_data(const void* data, std::size_t size);
         void upload_sub_data(const void* data, std::size_t offset, std::size_t size) const;
+
+        // Size of the data store in bytes
+        std::size_t get_size() const;
     private:
         unsigned int m_buffer {};
         DrawHint m_hint {DrawHint::Static};
+        std::size_t m_size {};
+    };
+
+    // Vertex buffer for data that is rewritten every frame
+    // It is persistently mapped and split into regions guarded by fences, so that writing doesn't wait for the GPU
+    // Falls back to orphaning when ARB_buffer_storage is not available
+    class GlStreamBuffer {
+    public:
+        explicit GlStreamBuffer(std::size_t region_size);
+        ~GlStreamBuffer();
+
+        GlStreamBuffer(const GlStreamBuffer&) = delete;
+        GlStreamBuffer& operator=(const GlStreamBuffer&) = delete;
+        GlStreamBuffer(GlStreamBuffer&&) = delete;
+        GlStreamBuffer& operator=(GlStreamBuffer&&) = delete;
+
+        void bind() const;
+        static void unbind();
+
+        // Copy data into the buffer and return its offset in bytes, which is a multiple of the stride
+        // Size must not exceed the region size; the buffer must be bound
+        std::size_t write(const void* data, std::size_t size, std::size_t stride);
+
+        // Fence the region written this frame and move on to the next one
+        void end_frame();
+
+        std::size_t get_region_size() const;
+    private:
+        void next_region();
+
+        static constexpr std::size_t REGIONS {3};
+
+        unsigned int m_buffer {};
+        unsigned char* m_mapped {};  // Null when orphaning
+        std::array<void*, REGIONS> m_fences {};
+        std::size_t m_region_size {};
+        std::size_t m_region {};
+        std::size_t m_cursor {};  // In the current region, or in the whole buffer when orphaning
     };
 
     // Only supports unsigned int
@@ -85,6 +128,10 @@ namespace sm {
         void set(const void* field_data, Id field);
         void upload() const;
         void set_and_upload(const void* field_data, Id field);
+
+        // Resolve a field once, to then set it repeatedly without lookups
+        std::size_t get_field_offset(Id field) const;
+        void set(const void* field_data, std::size_t offset, std::size_t size);
     private:
         void allocate_memory(std::size_t size);
         static std::size_t type_size(unsigned int type);
@@ -4,6 +4,7 @@
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include <cstdint>
 
 #include <glm/glm.hpp>
 
@@ -15,13 +16,17 @@
 namespace sm {
     namespace internal {
         class Renderer;
+        class ProgramCache;
     }
 
+    class MaterialInstance;
+
     // OpenGL resource representing a shader program
     class GlShader {
     public:
-        GlShader(const std::string& source_vertex, const std::string& source_fragment);
-        GlShader(const std::string& source_vertex, const std::string& source_geometry, const std::string& source_fragment);
+        // The program is loaded from the cache, if possible, otherwise it's compiled and stored in the cache
+        GlShader(const std::string& source_vertex, const std::string& source_fragment, const internal::ProgramCache* cache = nullptr);
+        GlShader(const std::string& source_vertex, const std::string& source_geometry, const std::string& source_fragment, const internal::ProgramCache* cache = nullptr);
         ~GlShader();
 
         GlShader(const GlShader&) = delete;
@@ -53,6 +58,9 @@ namespace sm {
 
         std::vector<std::string> introspect_program();
 
+        bool load_program_binary(const internal::ProgramCache& cache, std::uint64_t key);
+        void store_program_binary(const internal::ProgramCache& cache, std::uint64_t key, const std::vector<std::string>& uniforms) const;
+
         void create_program(unsigned int vertex_shader, unsigned int fragment_shader);
         void create_program(unsigned int vertex_shader, unsigned int geometry_shader, unsigned int fragment_shader);
         void delete_intermediates(unsigned int vertex_shader, unsigned int fragment_shader);
@@ -71,6 +79,15 @@ namespace sm {
 
         std::vector<std::shared_ptr<GlUniformBuffer>> m_uniform_buffers;
 
+        // Copy of the material values last uploaded to this program, so that unchanged ones are skipped
+        // Programs keep their uniform values, so the copy stays valid until something else is uploaded
+        mutable struct {
+            std::uint64_t layout {};  // ID of the material that determines the layout of the data; zero if invalid
+            const MaterialInstance* material_instance {};  // The one whose values are current
+            std::unique_ptr<unsigned char[]> data;
+        } m_material_uniforms;
+
         friend class internal::Renderer;
+        friend class MaterialInstance;
     };
 }
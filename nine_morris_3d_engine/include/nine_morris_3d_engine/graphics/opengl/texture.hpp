@@ -3,6 +3,7 @@
 #include <memory>
 #include <optional>
 #include <initializer_list>
+#include <cstddef>
 
 #include <glm/glm.hpp>
 
@@ -89,8 +90,12 @@ namespace sm {
 
         void bind(unsigned int unit) const;
         static void unbind();
+
+        // Size of all faces in bytes
+        std::size_t get_size() const;
     private:
         unsigned int m_texture {};
+        std::size_t m_size {};
     };
 
     inline constexpr float CUBEMAP_VERTICES[] {
@@ -30,6 +30,10 @@ namespace sm {
 
         // Bind and store a vertex buffer containing various attributes
         void add_vertex_buffer(std::shared_ptr<GlVertexBuffer> vertex_buffer, const VertexBufferLayout& layout);
+        void add_vertex_buffer(std::shared_ptr<GlStreamBuffer> stream_buffer, const VertexBufferLayout& layout);
+
+        // Check if a stream buffer has been added
+        bool has_vertex_buffer(const GlStreamBuffer* stream_buffer) const;
 
         // Store an index buffer; this doesn't change any OpenGL state
         // You then access the buffers by their 0 based index
@@ -40,12 +44,15 @@ namespace sm {
 
         // Get an index buffer that was previously added
         std::shared_ptr<GlIndexBuffer> get_index_buffer(std::size_t index) const;
+
+        unsigned int get_id() const;
     private:
         static constexpr std::size_t INVALID_INDEX_BUFFER {std::numeric_limits<std::size_t>::max()};
 
         unsigned int m_array {};
 
         std::vector<std::shared_ptr<GlVertexBuffer>> m_vertex_buffers;
+        std::vector<std::shared_ptr<GlStreamBuffer>> m_stream_buffers;
         std::vector<std::shared_ptr<GlIndexBuffer>> m_index_buffers;
         std::size_t m_index_buffer_index {INVALID_INDEX_BUFFER};
     };
@@ -4,6 +4,8 @@
 #include <memory>
 #include <functional>
 #include <string>
+#include <limits>
+#include <cstdint>
 
 #include <glm/glm.hpp>
 
@@ -41,8 +43,13 @@ namespace sm {
         glm::vec3 color {};
     };
 
+    // Transform versions identify world transforms, so that children know when to recompute theirs
+    inline constexpr std::uint64_t TRANSFORM_VERSION_ROOT {0};
+    inline constexpr std::uint64_t TRANSFORM_VERSION_NONE {std::numeric_limits<std::uint64_t>::max()};  // Always recompute
+
     struct Context3D {
         glm::mat4 transform {1.0f};
+        std::uint64_t transform_version {TRANSFORM_VERSION_ROOT};
         float transform_scale {1.0f};
         bool outline {false};
         bool disable_back_face_culling {false};
@@ -81,6 +88,9 @@ namespace sm {
         // Attach a node as a child
         void add_node(std::shared_ptr<SceneNode3D> node);
 
+        // Detach a child node; mostly useful in retained mode
+        void remove_node(const SceneNode3D* node);
+
         // Recursively clear the nodes
         void clear_nodes();
 
@@ -109,6 +119,8 @@ namespace sm {
     protected:
         std::vector<std::shared_ptr<SceneNode3D>> m_children;
         std::weak_ptr<SceneNode3D> m_parent;
+
+        friend class internal::Renderer;
     };
 
     // Base class for a 2D scene node
@@ -125,6 +137,9 @@ namespace sm {
         // Attach a node as a child
         void add_node(std::shared_ptr<SceneNode2D> node);
 
+        // Detach a child node; mostly useful in retained mode
+        void remove_node(const SceneNode2D* node);
+
         // Recursively clear the nodes
         void clear_nodes();
 
@@ -171,6 +186,10 @@ namespace sm {
         void debug_add_lamp(glm::vec3 position, glm::vec3 color);
         void debug_clear();
 
+        // When set, the nodes are kept across frames instead of having to be added every frame
+        // It is reset on scene change
+        bool retained {false};
+
         Camera3D camera;
         Skybox skybox;
         DirectionalLight directional_light;
@@ -204,17 +223,41 @@ namespace sm {
         const utils::AABB& get_aabb() const { return m_mesh->get_aabb(); }
         std::shared_ptr<MaterialInstance> get_material() const { return m_material; }
 
+        // Get the transform relative to the parent
+        // It is recomputed only when position, rotation or scale have changed
+        const glm::mat4& get_local_transform() const;
+
+        // Turn the parent's world transform in the context into this node's world transform
+        // It is recomputed only when the local transform or the parent's world transform have changed
+        void update_world_transform(Context3D& context) const;
+
         glm::vec3 position {};
         glm::vec3 rotation {};
         float scale {1.0f};
 
         NodeFlag disable_back_face_culling {Inherited};
         NodeFlag cast_shadow {Inherited};
+
+        // Per instance, so that it doesn't break batching; only shaders that read it show it
+        glm::vec3 highlight_color {};
     private:
         std::shared_ptr<Mesh> m_mesh;
         std::shared_ptr<GlVertexArray> m_vertex_array;
         std::shared_ptr<MaterialInstance> m_material;
 
+        // Cache of the transforms
+        mutable struct {
+            glm::mat4 local {1.0f};
+            glm::mat4 world {1.0f};
+            glm::vec3 position {};
+            glm::vec3 rotation {};
+            float scale {1.0f};
+            bool local_valid {false};
+            bool local_changed {false};
+            std::uint64_t parent_version {TRANSFORM_VERSION_NONE};
+            std::uint64_t version {TRANSFORM_VERSION_NONE};
+        } m_transform;
+
         friend class internal::Renderer;
     };
 
@@ -254,6 +297,10 @@ namespace sm {
             return SceneNode2DType::Root2D;
         }
 
+        // When set, the nodes are kept across frames instead of having to be added every frame
+        // It is reset on scene change
+        bool retained {false};
+
         Camera2D camera;
 
         friend class internal::Renderer;
@@ -298,6 +345,14 @@ namespace sm {
     private:
         std::shared_ptr<Font> m_font;
 
+        // Glyph quads of the text, laid out again only when the font or the text change
+        // Position, scale and color are applied when rendering, so they are not part of it
+        mutable struct {
+            std::weak_ptr<Font> font;
+            std::string text;
+            std::vector<Font::CharacterBuffer> characters;
+        } m_layout;
+
         friend class internal::Renderer;
     };
 
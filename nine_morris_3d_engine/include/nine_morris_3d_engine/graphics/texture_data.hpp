@@ -15,6 +15,7 @@ namespace sm {
     };
 
     // Resource representing an image data
+    // Decoding is thread safe, so images may be loaded in parallel
     class TextureData {
     public:
         TextureData(const std::string& buffer, const TexturePostProcessing& post_processing = {});
@@ -22,8 +23,8 @@ namespace sm {
 
         TextureData(const TextureData&) = delete;
         TextureData& operator=(const TextureData&) = delete;
-        TextureData(TextureData&&) = delete;
-        TextureData& operator=(TextureData&&) = delete;
+        TextureData(TextureData&& other) noexcept;
+        TextureData& operator=(TextureData&& other) noexcept;
 
         // Retrieve image information
         int get_width() const;
@@ -32,6 +33,7 @@ namespace sm {
         unsigned char* get_data();
     private:
         void resize(int new_width, int new_height);
+        void flip_vertically();
 
         int m_width {};
         int m_height {};
@@ -8,6 +8,7 @@
 #include "nine_morris_3d_engine/application/events.hpp"
 #include "nine_morris_3d_engine/application/global_data.hpp"
 #include "nine_morris_3d_engine/application/id.hpp"
+#include "nine_morris_3d_engine/application/job.hpp"
 #include "nine_morris_3d_engine/application/logging.hpp"
 #include "nine_morris_3d_engine/application/platform.hpp"
 #include "nine_morris_3d_engine/application/properties.hpp"
@@ -32,6 +33,7 @@
 #include "nine_morris_3d_engine/graphics/scene.hpp"
 #include "nine_morris_3d_engine/graphics/skybox.hpp"
 #include "nine_morris_3d_engine/graphics/texture_data.hpp"
+#include "nine_morris_3d_engine/other/asset_loader.hpp"
 #include "nine_morris_3d_engine/other/camera_controller.hpp"
 #include "nine_morris_3d_engine/other/dependencies.hpp"
 #include "nine_morris_3d_engine/other/localization.hpp"
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+#include <atomic>
+#include <cstddef>
+
+#include "nine_morris_3d_engine/application/job.hpp"
+#include "nine_morris_3d_engine/graphics/texture_data.hpp"
+
+/*
+    Declarative asset loading.
+
+    A JSON manifest lists the assets to be loaded, together with their dependencies. Every asset is loaded by its
+    own job, which waits only for the assets it depends on, so independent assets are loaded in parallel.
+
+    {
+        "assets": [
+            {
+                "name": "board",
+                "type": "mesh",  // One of mesh, texture_data, sound_data
+                "path": "nine_mens_morris/board.mesh",  // Relative to the assets directory
+                "flip": true,  // Texture data only, optional
+                "dependencies": []  // Names of assets listed before, optional
+            }
+        ]
+    }
+
+    Paths may contain variables written as ${name}. Assets with variables that are empty or undefined are skipped.
+*/
+
+namespace sm {
+    class Ctx;
+
+    class AssetLoader {
+    public:
+        enum class AssetType {
+            Mesh,
+            TextureData,
+            SoundData
+        };
+
+        struct Asset {
+            std::string name;
+            AssetType type {};
+            std::filesystem::path file_path;
+            bool flip {true};
+            std::vector<std::size_t> dependencies;  // Indices of assets listed before
+            double duration {};  // Milliseconds spent loading
+        };
+
+        using Variables = std::unordered_map<std::string, std::string>;
+
+        // Read the manifest; texture size is applied to all texture data
+        AssetLoader(const std::filesystem::path& file_path, const Variables& variables, TextureSize texture_size);
+
+        // Add a job for every asset; the returned job finishes after all assets are loaded
+        // The loader must outlive the jobs, which are bound to the calling scene
+        Job load(Ctx& ctx);
+
+        // Retrieve the progress; can be called from any thread while loading
+        std::size_t get_loaded_count() const;
+        std::size_t get_asset_count() const;
+        float get_progress() const;
+
+        // Retrieve the assets in the order of the manifest, without the skipped ones
+        const std::vector<Asset>& get_assets() const;
+
+        // Log the time of every asset and how much faster it was than loading everything sequentially
+        void log_report() const;
+    private:
+        void load_asset(Ctx& ctx, Asset& asset);
+
+        std::vector<Asset> m_assets;
+        TextureSize m_texture_size {};
+        std::atomic<std::size_t> m_loaded {};
+        double m_duration {};  // Milliseconds from the start to the end of loading
+    };
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+// Helpers for the binary files written by the engine's on-disk caches
+
+namespace sm::internal {
+    inline constexpr std::uint64_t HASH_BASIS {0xcbf29ce484222325};
+
+    // FNV-1a, as it must be the same across runs
+    std::uint64_t hash_bytes(std::uint64_t hash, const void* data, std::size_t size);
+
+    // Appends values to a buffer in native byte order
+    class BinaryWriter {
+    public:
+        void write_uint(std::uint32_t value);
+        void write_string(std::string_view string);  // Prefixed by the size
+
+        const std::string& get_buffer() const;
+    private:
+        std::string m_buffer;
+    };
+
+    // Reads from a buffer, failing instead of going past its end
+    class BinaryReader {
+    public:
+        explicit BinaryReader(const std::string& buffer)
+            : m_buffer(buffer) {}
+
+        bool read_uint(std::uint32_t& value);
+        bool read_string(std::string& string);
+
+        bool at_end() const;
+    private:
+        const std::string& m_buffer;
+        std::size_t m_position {0};
+    };
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <filesystem>
+#include <cstddef>
+
+namespace sm::internal {
+    // Read-only view of a whole file, mapped into memory; pages are loaded lazily by the OS
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::filesystem::path& file_path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&&) = delete;
+        MappedFile& operator=(MappedFile&&) = delete;
+
+        const unsigned char* get_data() const;
+        std::size_t get_size() const;
+    private:
+        const unsigned char* m_data {};
+        std::size_t m_size {};
+
+        void* m_mapping {};  // Only used on Windows
+    };
+}
@@ -1,9 +1,19 @@
 #pragma once
 
+#include <unordered_map>
+#include <vector>
+#include <array>
+#include <memory>
 #include <mutex>
+#include <atomic>
+#include <utility>
+#include <limits>
+#include <optional>
+#include <filesystem>
+#include <cstddef>
+#include <cstdint>
 
-#include <resmanager/resmanager.hpp>
-
+#include "nine_morris_3d_engine/application/id.hpp"
 #include "nine_morris_3d_engine/audio/sound_data.hpp"
 #include "nine_morris_3d_engine/graphics/opengl/texture.hpp"
 #include "nine_morris_3d_engine/graphics/opengl/vertex_array.hpp"
@@ -18,53 +28,345 @@
 // Resources are usually cached when loaded or created
 
 namespace sm::internal {
+    // Approximate size in bytes of the memory owned by a resource, either in RAM or in VRAM
+    // Resources not accounted for are considered to take no memory
+    std::size_t resource_size(const Mesh& mesh);
+    std::size_t resource_size(const TextureData& texture_data);
+    std::size_t resource_size(const Font& font);
+    std::size_t resource_size(const GlTexture& texture);
+    std::size_t resource_size(const GlTextureCubemap& texture);
+    std::size_t resource_size(const GlVertexBuffer& vertex_buffer);
+    std::size_t resource_size(const GlIndexBuffer& index_buffer);
+    std::size_t resource_size(const SoundData& sound_data);
+
     template<typename T>
-    class LockedCache {
+    std::size_t resource_size(const T&) {
+        return 0;
+    }
+
+    // Monotonic counter shared by all caches, used to order the entries by their last use
+    std::uint64_t next_use();
+
+    struct CacheStatistics {
+        std::size_t hits {};  // Resources returned from the cache
+        std::size_t misses {};  // Resources constructed
+        std::size_t evictions {};
+        std::size_t count {};
+        std::size_t size {};  // In bytes
+    };
+
+    class CacheBase;
+
+    struct EvictionCandidate {
+        CacheBase* cache {};
+        Id id;
+        std::uint64_t last_use {};
+        std::size_t size {};
+    };
+
+    class CacheBase {
     public:
-        resmanager::Cache<T>& operator*() {
-            std::lock_guard lock {m_mutex};
+        explicit CacheBase(bool evictable)
+            : m_evictable(evictable) {}
+
+        virtual ~CacheBase() = default;
+
+        CacheBase(const CacheBase&) = delete;
+        CacheBase& operator=(const CacheBase&) = delete;
+        CacheBase(CacheBase&&) = delete;
+        CacheBase& operator=(CacheBase&&) = delete;
 
-            return m_cache;
+        virtual void clear() = 0;
+
+        // Append the entries that are referenced only by the cache
+        virtual void collect_unreferenced(std::vector<EvictionCandidate>& candidates) = 0;
+
+        // Remove the entry, if it's still unreferenced and it hasn't been used since it was collected
+        virtual bool evict(const EvictionCandidate& candidate) = 0;
+
+        virtual CacheStatistics get_statistics() const = 0;
+
+        bool is_evictable() const { return m_evictable; }
+    private:
+        bool m_evictable {false};
+    };
+
+    // Thread safe cache split into shards with their own lock, so that loads from different threads rarely contend
+    // Resources are constructed outside of the locks; when two threads construct the same resource, one is discarded
+    template<typename T>
+    class ResourceCache : public CacheBase {
+    public:
+        explicit ResourceCache(bool evictable)
+            : CacheBase(evictable) {}
+
+        bool contains(Id id) const {
+            Shard& shard {get_shard(id)};
+            std::lock_guard lock {shard.mutex};
+
+            return shard.entries.find(id) != shard.entries.cend();
         }
 
-        const resmanager::Cache<T>& operator*() const {
+        // Return null, if the resource is not present
+        std::shared_ptr<T> get(Id id) const {
+            auto resource {find(id)};
+
+            if (resource != nullptr) {
+                m_hits++;
+            }
+
+            return resource;
+        }
+
+        // Return the resource, constructing it, if it's not present
+        template<typename... Args>
+        std::shared_ptr<T> load(Id id, Args&&... args) {
+            return load_check(id, std::forward<Args>(args)...).first;
+        }
+
+        // Same as above, but also return if the resource was present
+        template<typename... Args>
+        std::pair<std::shared_ptr<T>, bool> load_check(Id id, Args&&... args) {
+            auto resource {find(id)};
+
+            if (resource != nullptr) {
+                m_hits++;
+
+                return std::make_pair(std::move(resource), true);
+            }
+
+            return insert(id, std::make_shared<T>(std::forward<Args>(args)...), false);
+        }
+
+        // Construct the resource, replacing it, if it's present
+        template<typename... Args>
+        std::shared_ptr<T> force_load(Id id, Args&&... args) {
+            return insert(id, std::make_shared<T>(std::forward<Args>(args)...), true).first;
+        }
+
+        void clear() override {
+            for (Shard& shard : m_shards) {
+                std::unordered_map<Id, Entry, Hash> entries;
+
+                {
+                    std::lock_guard lock {shard.mutex};
+
+                    std::swap(entries, shard.entries);
+                }
+
+                for (const auto& [_, entry] : entries) {
+                    m_size -= entry.size;
+                    m_count--;
+                }
+            }
+        }
+
+        void collect_unreferenced(std::vector<EvictionCandidate>& candidates) override {
+            for (Shard& shard : m_shards) {
+                std::lock_guard lock {shard.mutex};
+
+                for (const auto& [id, entry] : shard.entries) {
+                    if (entry.resource.use_count() == 1) {
+                        candidates.push_back({this, id, entry.last_use, entry.size});
+                    }
+                }
+            }
+        }
+
+        bool evict(const EvictionCandidate& candidate) override {
+            std::shared_ptr<T> resource;  // Destroyed outside of the lock
+
+            Shard& shard {get_shard(candidate.id)};
+            std::lock_guard lock {shard.mutex};
+
+            const auto iter {shard.entries.find(candidate.id)};
+
+            if (iter == shard.entries.end()) {
+                return false;
+            }
+
+            // New references are only handed out by the cache, under the lock
+            if (iter->second.resource.use_count() != 1 || iter->second.last_use != candidate.last_use) {
+                return false;
+            }
+
+            resource = std::move(iter->second.resource);
+            m_size -= iter->second.size;
+            m_count--;
+            m_evictions++;
+            shard.entries.erase(iter);
+
+            return true;
+        }
+
+        CacheStatistics get_statistics() const override {
+            CacheStatistics statistics;
+            statistics.hits = m_hits.load();
+            statistics.misses = m_misses.load();
+            statistics.evictions = m_evictions.load();
+            statistics.count = m_count.load();
+            statistics.size = m_size.load();
+
+            return statistics;
+        }
+    private:
+        struct Entry {
+            std::shared_ptr<T> resource;
+            std::size_t size {};
+            std::uint64_t last_use {};
+        };
+
+        struct Shard {
+            std::unordered_map<Id, Entry, Hash> entries;
+            std::mutex mutex;
+        };
+
+        // Lookups also record the use, thus the shards are mutable
+        std::shared_ptr<T> find(Id id) const {
+            Shard& shard {get_shard(id)};
+            std::lock_guard lock {shard.mutex};
+
+            const auto iter {shard.entries.find(id)};
+
+            if (iter == shard.entries.end()) {
+                return nullptr;
+            }
+
+            iter->second.last_use = next_use();
+
+            return iter->second.resource;
+        }
+
+        std::pair<std::shared_ptr<T>, bool> insert(Id id, std::shared_ptr<T>&& resource, bool replace) {
+            m_misses++;
+
+            const std::size_t size {resource_size(*resource)};
+            std::shared_ptr<T> previous;  // Destroyed outside of the lock
+
+            Shard& shard {get_shard(id)};
+            std::lock_guard lock {shard.mutex};
+
+            const auto iter {shard.entries.find(id)};
+
+            if (iter != shard.entries.end()) {
+                if (!replace) {
+                    // Another thread has been faster
+                    iter->second.last_use = next_use();
+                    previous = std::move(resource);
+
+                    return std::make_pair(iter->second.resource, true);
+                }
+
+                previous = std::move(iter->second.resource);
+                m_size -= iter->second.size;
+                m_count--;
+            }
+
+            Entry& entry {shard.entries[id]};
+            entry.resource = resource;
+            entry.size = size;
+            entry.last_use = next_use();
+
+            m_size += size;
+            m_count++;
+
+            return std::make_pair(std::move(resource), false);
+        }
+
+        Shard& get_shard(Id id) const {
+            return m_shards[Hash{}(id) % SHARDS];
+        }
+
+        static constexpr std::size_t SHARDS {16};
+
+        mutable std::array<Shard, SHARDS> m_shards;
+
+        mutable std::atomic<std::size_t> m_hits {};
+        std::atomic<std::size_t> m_misses {};
+        std::atomic<std::size_t> m_evictions {};
+        std::atomic<std::size_t> m_count {};
+        std::atomic<std::size_t> m_size {};
+    };
+
+    // Files from which resources have been loaded, so that they can be loaded again after being evicted
+    template<typename Source>
+    class ResourceSources {
+    public:
+        void set(Id id, const Source& source) {
             std::lock_guard lock {m_mutex};
 
-            return m_cache;
+            m_sources[id] = source;
         }
 
-        resmanager::Cache<T>* operator->() {
+        // Return nothing, if the resource has not been loaded from a file
+        std::optional<Source> get(Id id) const {
             std::lock_guard lock {m_mutex};
 
-            return &m_cache;
+            const auto iter {m_sources.find(id)};
+
+            if (iter == m_sources.cend()) {
+                return std::nullopt;
+            }
+
+            return iter->second;
         }
 
-        const resmanager::Cache<T>* operator->() const {
+        void clear() {
             std::lock_guard lock {m_mutex};
 
-            return &m_cache;
+            m_sources.clear();
         }
     private:
-        resmanager::Cache<T> m_cache;
+        std::unordered_map<Id, Source, Hash> m_sources;
         mutable std::mutex m_mutex;
     };
 
+    struct TextureDataSource {
+        std::filesystem::path file_path;
+        TexturePostProcessing post_processing;
+    };
+
     // Global cache of resources
-    struct ResourcesCache {
+    // When the memory budget is exceeded, the least recently used resources not referenced outside of the cache are
+    // evicted, except for the ones which are cheap to keep, or expensive to recreate
+    class ResourcesCache {
+    public:
+        struct NamedCache {
+            const char* name {};
+            CacheBase* cache {};
+        };
+
         void clear();
 
-        LockedCache<Mesh> mesh;
-        LockedCache<TextureData> texture_data;
-        LockedCache<Font> font;
-        LockedCache<Material> material;
-        LockedCache<MaterialInstance> material_instance;
-        LockedCache<GlTexture> texture;
-        LockedCache<GlTextureCubemap> texture_cubemap;
-        LockedCache<GlVertexArray> vertex_array;
-        LockedCache<GlVertexBuffer> vertex_buffer;
-        LockedCache<GlIndexBuffer> index_buffer;
-        LockedCache<GlShader> shader;
-        LockedCache<GlFramebuffer> framebuffer;
-        LockedCache<SoundData> sound_data;
+        // Retrieve the resource, loading it again from its file, if it has been evicted; return null, if it's unknown
+        std::shared_ptr<Mesh> get_mesh(Id id);
+        std::shared_ptr<TextureData> get_texture_data(Id id);
+
+        // Evict resources until the memory usage is within the budget; must be called on the main thread
+        void trim();
+
+        void set_memory_budget(std::size_t memory_budget);
+        std::size_t get_memory_budget() const;
+        std::size_t get_memory_usage() const;
+
+        std::array<NamedCache, 13> get_caches();
+
+        ResourceCache<Mesh> mesh {true};
+        ResourceCache<TextureData> texture_data {true};
+        ResourceCache<Font> font {false};
+        ResourceCache<Material> material {false};
+        ResourceCache<MaterialInstance> material_instance {false};
+        ResourceCache<GlTexture> texture {true};
+        ResourceCache<GlTextureCubemap> texture_cubemap {true};
+        ResourceCache<GlVertexArray> vertex_array {true};
+        ResourceCache<GlVertexBuffer> vertex_buffer {true};
+        ResourceCache<GlIndexBuffer> index_buffer {true};
+        ResourceCache<GlShader> shader {false};
+        ResourceCache<GlFramebuffer> framebuffer {false};
+        ResourceCache<SoundData> sound_data {true};
+
+        ResourceSources<std::filesystem::path> mesh_sources;
+        ResourceSources<TextureDataSource> texture_data_sources;
+    private:
+        std::size_t m_memory_budget {std::numeric_limits<std::size_t>::max()};
     };
 }
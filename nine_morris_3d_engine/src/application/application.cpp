@@ -7,18 +7,22 @@
 #include "nine_morris_3d_engine/application/scene.hpp"
 #include "nine_morris_3d_engine/application/platform.hpp"
 #include "nine_morris_3d_engine/application/logging.hpp"
+#include "nine_morris_3d_engine/application/internal/profiler.hpp"
 #include "nine_morris_3d_engine/audio/internal/audio.hpp"
 #include "nine_morris_3d_engine/graphics/internal/imgui_context.hpp"
 #include "nine_morris_3d_engine/graphics/opengl/debug.hpp"
 
 namespace sm {
     Application::Application(const ApplicationProperties& properties)
-        : m_ctx(properties) {
+        : m_ctx(properties), m_max_frames(properties.max_frames) {
         m_ctx.m_application = this;
         m_ctx.m_user_data = properties.user_data;
 
         internal::imgui_context::initialize(m_ctx.m_win.get_window(), m_ctx.m_win.get_context());
         internal::audio::initialize();
+#ifndef SM_BUILD_DISTRIBUTION
+        internal::profiler::initialize();
+#endif
 
         LOG_DIST_INFO("Working directory: {}", internal::FileSystem::current_working_directory().string());
 
@@ -41,6 +45,9 @@ namespace sm {
     }
 
     Application::~Application() {
+#ifndef SM_BUILD_DISTRIBUTION
+        internal::profiler::uninitialize();
+#endif
         internal::audio::uninitialize();
         internal::imgui_context::uninitialize();
 
@@ -48,7 +55,7 @@ namespace sm {
 
         // Cannot let exceptions escape destructors
         try {
-            m_ctx.m_tsk.wait_async();
+            m_ctx.m_job.cancel();
         } catch (...) {
             LOG_DIST_WARNING("Exception thrown inside application destructor is ignored");
         }
@@ -72,19 +79,29 @@ namespace sm {
         LOG_INFO("Entering application main loop...");
 
         while (m_ctx.running) {
+#ifndef SM_BUILD_DISTRIBUTION
+            internal::profiler::begin_frame();
+#endif
+
             m_ctx.m_delta = update_frame_counter();
             const unsigned int fixed_updates {calculate_fixed_update()};
 
             for (unsigned int i {0}; i < fixed_updates; i++) {
+                SM_PROFILE_SCOPE("Fixed update");
+
                 m_scene_current->scene->on_fixed_update();
             }
 
             // Events need to be processed before scene update
             m_ctx.m_win.poll_events();
 
-            m_scene_current->scene->pre_update();
-            m_scene_current->scene->on_update();
-            m_scene_current->scene->post_update();
+            {
+                SM_PROFILE_SCOPE("Update");
+
+                m_scene_current->scene->pre_update();
+                m_scene_current->scene->on_update();
+                m_scene_current->scene->post_update();
+            }
 
             if (!m_minimized) {
 #ifndef SM_BUILD_DISTRIBUTION
@@ -94,20 +111,44 @@ namespace sm {
                 dear_imgui_render();
             }
 
-            // Every frame the graph is rebuilt
-            m_ctx.m_scn.root_node_3d->clear_nodes();
-            m_ctx.m_scn.root_node_2d->clear_nodes();
+            // Every frame the graph is rebuilt, unless the scene keeps it
+            if (!m_ctx.m_scn.root_node_3d->retained) {
+                m_ctx.m_scn.root_node_3d->clear_nodes();
+            }
+
+            if (!m_ctx.m_scn.root_node_2d->retained) {
+                m_ctx.m_scn.root_node_2d->clear_nodes();
+            }
+
             m_ctx.m_scn.root_node_3d->debug_clear();
 
             // Swap the buffers
-            m_ctx.m_win.flip();
+            {
+                SM_PROFILE_SCOPE("Swap buffers");
+
+                m_ctx.m_win.flip();
+            }
 
             m_ctx.m_evt.update();
 
-            // Update tasks after scene update and after events
+            // Update tasks and main thread jobs after scene update and after events
             m_ctx.m_tsk.update();
+            m_ctx.m_job.update();
+
+            // Resources are released on the main thread, as they may be OpenGL objects
+            m_ctx.m_res.trim();
 
             check_changed_scene();
+
+            if (m_max_frames > 0 && ++m_frame_index == m_max_frames) {
+                LOG_INFO("Reached the maximum of {} frames", m_max_frames);
+
+                m_ctx.running = false;
+            }
+
+#ifndef SM_BUILD_DISTRIBUTION
+            internal::profiler::end_frame();
+#endif
         }
 
         LOG_INFO("Closing application...");
@@ -192,6 +233,12 @@ namespace sm {
                 m_ctx.m_res.clear();
             }
 
+            // A retained graph belongs to the previous scene
+            m_ctx.m_scn.root_node_3d->clear_nodes();
+            m_ctx.m_scn.root_node_2d->clear_nodes();
+            m_ctx.m_scn.root_node_3d->retained = false;
+            m_ctx.m_scn.root_node_2d->retained = false;
+
             m_scene_current = std::exchange(m_scene_next, nullptr);
 
             scene_on_start(m_scene_current);
@@ -216,6 +263,8 @@ namespace sm {
     }
 
     void Application::dear_imgui_render() {
+        SM_PROFILE_GPU_SCOPE("Dear ImGui");
+
         internal::imgui_context::begin_frame();
 
         m_scene_current->scene->on_imgui_update();
@@ -244,9 +293,9 @@ namespace sm {
     }
 
     void Application::scene_on_stop(MetaScene* meta_scene) {
-        // Tasks are bound to the current scene
-        m_ctx.m_tsk.wait_async();
-        m_ctx.m_tsk.update();  // MUST execute any pending immediate tasks from async tasks before clearing
+        // Tasks and jobs are bound to the current scene
+        m_ctx.m_job.cancel();
+        m_ctx.m_tsk.update();  // MUST execute any pending immediate tasks from jobs before clearing
         m_ctx.m_tsk.clear();
 
         LOG_INFO("Stopping scene...");
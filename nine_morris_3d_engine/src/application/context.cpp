@@ -3,6 +3,7 @@
 #include <resmanager/resmanager.hpp>
 
 #include "nine_morris_3d_engine/application/internal/input.hpp"
+#include "nine_morris_3d_engine/application/internal/profiler.hpp"
 #include "nine_morris_3d_engine/application/application.hpp"
 #include "nine_morris_3d_engine/application/scene.hpp"
 #include "nine_morris_3d_engine/application/logging.hpp"
@@ -15,13 +16,21 @@ namespace sm {
     Ctx::Ctx(const ApplicationProperties& properties)
         : m_build_date(properties.build_date),
         m_build_time(properties.build_time),
-        m_fs(properties.path_logs, properties.path_saved_data, properties.path_assets, properties.assets_directory),
+        m_fs(
+            properties.path_logs,
+            properties.path_saved_data,
+            properties.path_assets,
+            properties.path_baked_assets,
+            properties.assets_directory
+        ),
         m_log(properties.log_file, m_fs),
         m_shd({m_fs.path_engine_assets().string(), m_fs.path_assets().string()}),
         m_win(properties, m_evt),
-        m_rnd(properties.width, properties.height, m_fs, m_shd) {
+        m_prg(m_fs),
+        m_atl(m_fs),
+        m_rnd(properties.width, properties.height, m_fs, m_shd, m_prg) {
         if (properties.default_renderer_parameters) {
-            m_rnd.initialize(properties.width, properties.height, m_fs);
+            m_rnd.initialize(properties.width, properties.height, m_fs, m_atl);
         }
 
         if (!m_fs.get_error_string().empty()) {
@@ -73,6 +82,10 @@ namespace sm {
         return m_fs.path_engine_assets();
     }
 
+    std::filesystem::path Ctx::path_baked_assets() const {
+        return m_fs.path_baked_assets();
+    }
+
     std::filesystem::path Ctx::path_logs(const std::filesystem::path& path) const {
         return m_fs.path_logs(path);
     }
@@ -89,6 +102,10 @@ namespace sm {
         return m_fs.path_engine_assets(path);
     }
 
+    std::filesystem::path Ctx::path_baked_assets(const std::filesystem::path& path) const {
+        return m_fs.path_baked_assets(path);
+    }
+
     int Ctx::get_window_width() const {
         return m_win.get_width();
     }
@@ -97,6 +114,10 @@ namespace sm {
         return m_win.get_height();
     }
 
+    bool Ctx::is_window_headless() const {
+        return m_win.is_headless();
+    }
+
     void Ctx::show_window() const {
         m_win.show();
     }
@@ -138,7 +159,7 @@ namespace sm {
     }
 
     void Ctx::set_renderer_scale(int scale) {
-        m_rnd.set_scale(m_fs, scale);
+        m_rnd.set_scale(scale);
     }
 
     void Ctx::set_renderer_shadow_map_size(int size) {
@@ -146,7 +167,7 @@ namespace sm {
     }
 
     void Ctx::initialize_renderer(const RendererSpecification& specification) {
-        m_rnd.initialize(m_win.get_width(), m_win.get_height(), m_fs, specification);
+        m_rnd.initialize(m_win.get_width(), m_win.get_height(), m_fs, m_atl, specification);
     }
 
     void Ctx::play_audio_sound(std::shared_ptr<SoundData> sound_data) {
@@ -169,8 +190,24 @@ namespace sm {
         m_tsk.add_deffered(std::move(function));
     }
 
-    void Ctx::add_task_async(AsyncTask::Function&& function) {
-        m_tsk.add_async(std::move(function));
+    Job Ctx::add_job(Job::Function&& function, std::initializer_list<Job> dependencies) {
+        return m_job.add(std::move(function), dependencies);
+    }
+
+    Job Ctx::add_job(Job::Function&& function, const std::vector<Job>& dependencies) {
+        return m_job.add(std::move(function), dependencies);
+    }
+
+    Job Ctx::add_job_main(Job::Function&& function, std::initializer_list<Job> dependencies) {
+        return m_job.add_main(std::move(function), dependencies);
+    }
+
+    Job Ctx::add_job_main(Job::Function&& function, const std::vector<Job>& dependencies) {
+        return m_job.add_main(std::move(function), dependencies);
+    }
+
+    void Ctx::wait_job(const Job& job) {
+        m_job.wait(job);
     }
 
     bool Ctx::is_key_pressed(Key key) {
@@ -193,6 +230,10 @@ namespace sm {
         m_application->change_scene(id, clear_resources);
     }
 
+    void Ctx::set_resources_memory_budget(std::size_t memory_budget) {
+        m_res.set_memory_budget(memory_budget);
+    }
+
     void Ctx::show_information_text() {
         std::string information_text;
         information_text += std::string(opengl_debug::get_opengl_version()) + '\n';
@@ -207,6 +248,7 @@ namespace sm {
 #endif
 
         m_information_text->text = std::move(information_text);
+        m_information_text->scale = static_cast<float>(m_rnd.get_scale());
 
         // The font could be empty, because renderer initializaton might have been deferred
         if (m_information_text->get_font() == nullptr) {
@@ -257,33 +299,29 @@ namespace sm {
         return result;
     }
 
-    std::shared_ptr<Mesh> Ctx::get_mesh(Id id) const {
-        return m_res.mesh->get(id);
+    std::shared_ptr<Mesh> Ctx::get_mesh(Id id) {
+        return m_res.get_mesh(id);
     }
 
-    std::shared_ptr<Mesh> Ctx::load_mesh(Id id, const std::filesystem::path& file_path, const MeshSpecification& specification) {
-        if (m_res.mesh->contains(id)) {
-            return m_res.mesh->get(id);
-        }
+    std::shared_ptr<Mesh> Ctx::load_mesh(Id id, const std::filesystem::path& file_path) {
+        SM_PROFILE_SCOPE("Load mesh");
 
-        return m_res.mesh->force_load(id, utils::read_file(file_path), specification);
-    }
+        m_res.mesh_sources.set(id, file_path);
 
-    std::shared_ptr<Mesh> Ctx::load_mesh(const std::filesystem::path& file_path, const MeshSpecification& specification) {
-        const auto id {Id(utils::file_name(file_path))};
-
-        if (m_res.mesh->contains(id)) {
-            return m_res.mesh->get(id);
-        }
+        return m_res.mesh.load(id, file_path);
+    }
 
-        return m_res.mesh->force_load(id, utils::read_file(file_path), specification);
+    std::shared_ptr<Mesh> Ctx::load_mesh(const std::filesystem::path& file_path) {
+        return load_mesh(Id(utils::file_name(file_path)), file_path);
     }
 
     std::shared_ptr<GlVertexArray> Ctx::load_vertex_array(Id id, std::shared_ptr<Mesh> mesh) {
-        const auto vertex_buffer {m_res.vertex_buffer->load(id, mesh->get_vertices(), mesh->get_vertices_size())};
-        const auto index_buffer {m_res.index_buffer->load(id, mesh->get_indices(), mesh->get_indices_size())};
+        SM_PROFILE_SCOPE("Load vertex array");
 
-        const auto [vertex_array, present] {m_res.vertex_array->load_check(id)};
+        const auto vertex_buffer {m_res.vertex_buffer.load(id, mesh->get_vertices(), mesh->get_vertices_size())};
+        const auto index_buffer {m_res.index_buffer.load(id, mesh->get_indices(), mesh->get_indices_size())};
+
+        const auto [vertex_array, present] {m_res.vertex_array.load_check(id)};
 
         if (present) {
             return vertex_array;
@@ -321,40 +359,63 @@ namespace sm {
         return vertex_array;
     }
 
-    std::shared_ptr<TextureData> Ctx::get_texture_data(Id id) const {
-        return m_res.texture_data->get(id);
+    std::shared_ptr<TextureData> Ctx::get_texture_data(Id id) {
+        return m_res.get_texture_data(id);
     }
 
     std::shared_ptr<TextureData> Ctx::load_texture_data(const std::filesystem::path& file_path, const TexturePostProcessing& post_processing) {
+        SM_PROFILE_SCOPE("Load texture data");
+
         const auto id {Id(utils::file_name(file_path))};
 
-        if (m_res.texture_data->contains(id)) {
-            return m_res.texture_data->get(id);
+        m_res.texture_data_sources.set(id, {file_path, post_processing});
+
+        // Resources may be evicted at any time, so check and retrieve at once
+        if (auto texture_data {m_res.texture_data.get(id)}) {
+            return texture_data;
         }
 
-        return m_res.texture_data->force_load(id, utils::read_file(file_path), post_processing);
+        // Decoded before locking the cache
+        TextureData texture_data {utils::read_file(file_path), post_processing};
+
+        return m_res.texture_data.force_load(id, std::move(texture_data));
     }
 
     std::shared_ptr<TextureData> Ctx::reload_texture_data(const std::filesystem::path& file_path, const TexturePostProcessing& post_processing) {
+        SM_PROFILE_SCOPE("Load texture data");
+
         const auto id {Id(utils::file_name(file_path))};
 
-        return m_res.texture_data->force_load(id, utils::read_file(file_path), post_processing);
+        m_res.texture_data_sources.set(id, {file_path, post_processing});
+
+        // Decoded before locking the cache
+        TextureData texture_data {utils::read_file(file_path), post_processing};
+
+        return m_res.texture_data.force_load(id, std::move(texture_data));
     }
 
     std::shared_ptr<GlTexture> Ctx::load_texture(Id id, std::shared_ptr<TextureData> texture_data, const TextureSpecification& specification) {
-        return m_res.texture->load(id, texture_data, specification);
+        SM_PROFILE_SCOPE("Load texture");
+
+        return m_res.texture.load(id, texture_data, specification);
     }
 
     std::shared_ptr<GlTexture> Ctx::reload_texture(Id id, std::shared_ptr<TextureData> texture_data, const TextureSpecification& specification) {
-        return m_res.texture->force_load(id, texture_data, specification);
+        SM_PROFILE_SCOPE("Load texture");
+
+        return m_res.texture.force_load(id, texture_data, specification);
     }
 
     std::shared_ptr<GlTextureCubemap> Ctx::load_texture_cubemap(Id id, std::initializer_list<std::shared_ptr<TextureData>> texture_data, TextureFormat format) {
-        return m_res.texture_cubemap->load(id, texture_data, format);
+        SM_PROFILE_SCOPE("Load texture cubemap");
+
+        return m_res.texture_cubemap.load(id, texture_data, format);
     }
 
     std::shared_ptr<GlTextureCubemap> Ctx::reload_texture_cubemap(Id id, std::initializer_list<std::shared_ptr<TextureData>> texture_data, TextureFormat format) {
-        return m_res.texture_cubemap->force_load(id, texture_data, format);
+        SM_PROFILE_SCOPE("Load texture cubemap");
+
+        return m_res.texture_cubemap.force_load(id, texture_data, format);
     }
 
     std::shared_ptr<Material> Ctx::load_material(MaterialType type) {
@@ -370,7 +431,7 @@ namespace sm {
                     m_fs.path_engine_assets("shaders/flat.frag")
                 )};
 
-                const auto [material, present] {m_res.material->load_check(id, shader)};
+                const auto [material, present] {m_res.material.load_check(id, shader)};
 
                 if (present) {
                     return material;
@@ -389,7 +450,7 @@ namespace sm {
                     m_fs.path_engine_assets("shaders/phong.frag")
                 )};
 
-                const auto [material, present] {m_res.material->load_check(id, shader)};
+                const auto [material, present] {m_res.material.load_check(id, shader)};
 
                 if (present) {
                     return material;
@@ -410,7 +471,7 @@ namespace sm {
                     m_fs.path_engine_assets("shaders/phong_shadow.frag")
                 )};
 
-                const auto [material, present] {m_res.material->load_check(id, shader)};
+                const auto [material, present] {m_res.material.load_check(id, shader)};
 
                 if (present) {
                     return material;
@@ -431,7 +492,7 @@ namespace sm {
                     m_fs.path_engine_assets("shaders/phong_diffuse.frag")
                 )};
 
-                const auto [material, present] {m_res.material->load_check(id, shader)};
+                const auto [material, present] {m_res.material.load_check(id, shader)};
 
                 if (present) {
                     return material;
@@ -452,7 +513,7 @@ namespace sm {
                     m_fs.path_engine_assets("shaders/phong_diffuse_shadow.frag")
                 )};
 
-                const auto [material, present] {m_res.material->load_check(id, shader)};
+                const auto [material, present] {m_res.material.load_check(id, shader)};
 
                 if (present) {
                     return material;
@@ -473,7 +534,7 @@ namespace sm {
                     m_fs.path_engine_assets("shaders/phong_diffuse_normal_shadow.frag")
                 )};
 
-                const auto [material, present] {m_res.material->load_check(id, shader)};
+                const auto [material, present] {m_res.material.load_check(id, shader)};
 
                 if (present) {
                     return material;
@@ -496,7 +557,7 @@ namespace sm {
 
         const auto shader {load_shader(id, vertex_file_path, fragment_file_path)};
 
-        const auto [material, present] {m_res.material->load_check(id, shader)};
+        const auto [material, present] {m_res.material.load_check(id, shader)};
 
         if (present) {
             return material;
@@ -534,25 +595,28 @@ namespace sm {
     }
 
     std::shared_ptr<MaterialInstance> Ctx::load_material_instance(Id id, std::shared_ptr<Material> material) {
-        return m_res.material_instance->load(id, material);
+        return m_res.material_instance.load(id, material);
     }
 
     std::shared_ptr<GlShader> Ctx::load_shader(Id id, const std::filesystem::path& vertex_file_path, const std::filesystem::path& fragment_file_path) {
-        if (m_res.shader->contains(id)) {
-            return m_res.shader->get(id);
+        SM_PROFILE_SCOPE("Load shader");
+
+        if (m_res.shader.contains(id)) {
+            return m_res.shader.get(id);
         }
 
         std::shared_ptr<GlShader> shader {
-            m_res.shader->force_load(
+            m_res.shader.force_load(
                 id,
                 m_shd.load_shader(
-                    m_shd.load_shader(utils::read_file(vertex_file_path)),
+                    utils::read_file(vertex_file_path),
                     {{"D_POINT_LIGHTS", std::to_string(internal::Renderer::get_max_point_lights())}}
                 ),
                 m_shd.load_shader(
-                    m_shd.load_shader(utils::read_file(fragment_file_path)),
+                    utils::read_file(fragment_file_path),
                     {{"D_POINT_LIGHTS", std::to_string(internal::Renderer::get_max_point_lights())}}
-                )
+                ),
+                &m_prg
             )
         };
 
@@ -562,7 +626,7 @@ namespace sm {
     }
 
     std::shared_ptr<GlFramebuffer> Ctx::load_framebuffer(Id id, const FramebufferSpecification& specification) {
-        const auto [framebuffer, present] {m_res.framebuffer->load_check(id, specification)};
+        const auto [framebuffer, present] {m_res.framebuffer.load_check(id, specification)};
 
         if (present) {
             return framebuffer;
@@ -574,11 +638,13 @@ namespace sm {
     }
 
     std::shared_ptr<Font> Ctx::load_font(Id id, const std::filesystem::path& file_path, const FontSpecification& specification, const std::function<void(Font*)>& bake) {
-        if (m_res.font->contains(id)) {
-            return m_res.font->get(id);
+        SM_PROFILE_SCOPE("Load font");
+
+        if (m_res.font.contains(id)) {
+            return m_res.font.get(id);
         }
 
-        const auto font {m_res.font->force_load(id, utils::read_file(file_path), specification)};
+        const auto font {m_res.font.force_load(id, utils::read_file(file_path), specification, &m_atl)};
 
         bake(font.get());
 
@@ -586,8 +652,10 @@ namespace sm {
     }
 
     std::shared_ptr<SoundData> Ctx::load_sound_data(const std::filesystem::path& file_path) {
+        SM_PROFILE_SCOPE("Load sound data");
+
         const auto id {Id(utils::file_name(file_path))};
 
-        return m_res.sound_data->load(id, file_path);
+        return m_res.sound_data.load(id, file_path);
     }
 }
@@ -10,11 +10,13 @@ namespace sm::internal {
         const std::filesystem::path& path_logs,
         const std::filesystem::path& path_saved_data,
         const std::filesystem::path& path_assets,
+        const std::filesystem::path& path_baked_assets,
         const std::filesystem::path& assets_directory
     )
         : m_path_logs(path_logs),
         m_path_saved_data(path_saved_data),
         m_path_assets(path_assets),
+        m_path_baked_assets(path_baked_assets),
         m_assets_directory(assets_directory) {
 #ifdef SM_BUILD_DISTRIBUTION
         check_and_fix_directories();
@@ -65,6 +67,15 @@ namespace sm::internal {
         return result;
     }
 
+    void FileSystem::rename_file(const std::filesystem::path& path, const std::filesystem::path& new_path) {
+        std::error_code ec;
+        std::filesystem::rename(path, new_path, ec);
+
+        if (ec) {
+            throw OtherError("Could not rename file `" + path.string() + "` to `" + new_path.string() + "`: " + ec.message());
+        }
+    }
+
     std::filesystem::path FileSystem::current_working_directory() {
         std::error_code ec;
         const auto path {std::filesystem::current_path(ec)};
@@ -92,6 +103,10 @@ namespace sm::internal {
         return m_path_assets / "assets_engine";
     }
 
+    std::filesystem::path FileSystem::path_baked_assets() const {
+        return m_path_baked_assets / m_assets_directory;
+    }
+
     std::filesystem::path FileSystem::path_logs(const std::filesystem::path& path) const {
         return path_logs() / path;
     }
@@ -108,6 +123,10 @@ namespace sm::internal {
         return path_engine_assets() / path;
     }
 
+    std::filesystem::path FileSystem::path_baked_assets(const std::filesystem::path& path) const {
+        return path_baked_assets() / path;
+    }
+
     void FileSystem::check_and_fix_directories() const {
         check_directory(m_path_logs);
         check_directory(m_path_saved_data);
@@ -0,0 +1,352 @@
+#include "nine_morris_3d_engine/application/internal/job_system.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <limits>
+#include <cassert>
+
+#include "nine_morris_3d_engine/application/internal/profiler.hpp"
+#include "nine_morris_3d_engine/application/internal/error.hpp"
+#include "nine_morris_3d_engine/application/logging.hpp"
+
+namespace sm::internal {
+    static constexpr std::size_t NO_WORKER {std::numeric_limits<std::size_t>::max()};
+
+    static thread_local std::size_t t_worker_index {NO_WORKER};
+    static thread_local std::shared_ptr<std::atomic_bool> t_stop;  // Of the job being executed by this thread
+}
+
+namespace sm {
+    bool Job::done() const {
+        if (m_state == nullptr) {
+            return true;
+        }
+
+        std::lock_guard lock {m_state->mutex};
+
+        return m_state->finished;
+    }
+
+    bool Job::stop_requested() {
+        return internal::t_stop != nullptr && internal::t_stop->load();
+    }
+}
+
+namespace sm::internal {
+    JobSystem::JobSystem()
+        : m_main_thread(std::this_thread::get_id()) {
+        const std::size_t thread_count {std::max(std::thread::hardware_concurrency(), 2u) - 1};
+
+        m_stop = std::make_shared<std::atomic_bool>(false);
+
+        for (std::size_t i {0}; i < thread_count; i++) {
+            m_workers.push_back(std::make_unique<Worker>());
+        }
+
+        for (std::size_t i {0}; i < thread_count; i++) {
+            m_threads.emplace_back(&JobSystem::worker_loop, this, i);
+        }
+
+        LOG_INFO("Created job system with {} threads", thread_count);
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard lock {m_sleep_mutex};
+
+            m_running = false;
+        }
+
+        m_sleep.notify_all();
+
+        for (std::thread& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    Job JobSystem::add(Job::Function&& function, std::initializer_list<Job> dependencies) {
+        return create(std::move(function), std::span(dependencies.begin(), dependencies.size()), false);
+    }
+
+    Job JobSystem::add(Job::Function&& function, const std::vector<Job>& dependencies) {
+        return create(std::move(function), dependencies, false);
+    }
+
+    Job JobSystem::add_main(Job::Function&& function, std::initializer_list<Job> dependencies) {
+        return create(std::move(function), std::span(dependencies.begin(), dependencies.size()), true);
+    }
+
+    Job JobSystem::add_main(Job::Function&& function, const std::vector<Job>& dependencies) {
+        return create(std::move(function), dependencies, true);
+    }
+
+    void JobSystem::wait(const Job& job) {
+        const std::size_t worker_index {t_worker_index != NO_WORKER ? t_worker_index : 0};
+        const bool main_thread {std::this_thread::get_id() == m_main_thread};
+
+        while (!job.done()) {
+            // Nobody else executes the main thread jobs, and the awaited job may depend on them
+            const bool executed_main {main_thread && execute_main_jobs()};
+
+            if (!try_execute(worker_index) && !executed_main) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::update() {
+        execute_main_jobs();
+
+        throw_exception();
+    }
+
+    void JobSystem::cancel() {
+        {
+            std::lock_guard lock {m_stop_mutex};
+
+            m_stop->store(true);
+            m_stop = std::make_shared<std::atomic_bool>(false);
+        }
+
+        // The cancelled jobs are skipped, but they still need to finish, so that their dependents are scheduled
+        while (m_unfinished.load() > 0) {
+            const bool executed_main {execute_main_jobs()};
+
+            if (!try_execute(0) && !executed_main) {
+                std::this_thread::yield();
+            }
+        }
+
+        throw_exception();
+    }
+
+    std::size_t JobSystem::get_thread_count() const {
+        return m_threads.size();
+    }
+
+    Job JobSystem::create(Job::Function&& function, std::span<const Job> dependencies, bool main_thread) {
+        auto state {std::make_shared<JobState>()};
+        state->function = std::move(function);
+        state->main_thread = main_thread;
+        state->dependencies = 1;  // Hold the job until all dependencies are registered
+
+        // Jobs added by jobs belong to the same scene
+        if (t_stop != nullptr) {
+            state->stop = t_stop;
+        } else {
+            std::lock_guard lock {m_stop_mutex};
+
+            state->stop = m_stop;
+        }
+
+        m_unfinished++;
+
+        for (const Job& dependency : dependencies) {
+            if (dependency.m_state == nullptr) {
+                continue;
+            }
+
+            std::lock_guard lock {dependency.m_state->mutex};
+
+            if (dependency.m_state->finished) {
+                if (dependency.m_state->failed) {
+                    state->dependency_failed.store(true);
+                }
+            } else {
+                state->dependencies++;
+                dependency.m_state->continuations.push_back(state);
+            }
+        }
+
+        if (--state->dependencies == 0) {
+            schedule(state);
+        }
+
+        return Job(std::move(state));
+    }
+
+    void JobSystem::schedule(std::shared_ptr<JobState> state) {
+        if (state->main_thread) {
+            std::lock_guard lock {m_main_mutex};
+
+            m_main_jobs.push_back(std::move(state));
+
+            return;
+        }
+
+        // Workers push to their own queue, for locality; other threads distribute the jobs
+        const std::size_t worker_index {
+            t_worker_index != NO_WORKER ? t_worker_index : m_next_worker++ % m_workers.size()
+        };
+
+        // Counted before it's pushed, so that the counter never underflows
+        {
+            std::lock_guard lock {m_sleep_mutex};
+
+            m_queued++;
+        }
+
+        {
+            Worker& worker {*m_workers[worker_index]};
+            std::lock_guard lock {worker.mutex};
+
+            worker.queue.push_back(std::move(state));
+        }
+
+        m_sleep.notify_one();
+    }
+
+    void JobSystem::execute(const std::shared_ptr<JobState>& state) {
+        // Cancelled jobs and jobs whose dependencies didn't complete are skipped
+        if (state->stop->load() || state->dependency_failed.load()) {
+            finish(state, true);
+            return;
+        }
+
+        bool failed {false};
+
+        // Waiting jobs may execute other jobs
+        auto previous_stop {std::exchange(t_stop, state->stop)};
+
+        try {
+            SM_PROFILE_SCOPE("Job");
+
+            state->function();
+        } catch (const RuntimeError&) {
+            std::lock_guard lock {m_exception_mutex};
+
+            m_exception = std::current_exception();
+            failed = true;
+        }
+
+        t_stop = std::move(previous_stop);
+
+        finish(state, failed);
+    }
+
+    void JobSystem::finish(const std::shared_ptr<JobState>& state, bool failed) {
+        std::vector<std::shared_ptr<JobState>> continuations;
+
+        {
+            std::lock_guard lock {state->mutex};
+
+            state->finished = true;
+            state->failed = failed;
+            std::swap(continuations, state->continuations);
+        }
+
+        state->function = nullptr;  // Release the captures
+
+        for (const auto& continuation : continuations) {
+            if (failed) {
+                continuation->dependency_failed.store(true);
+            }
+
+            if (--continuation->dependencies == 0) {
+                schedule(continuation);
+            }
+        }
+
+        m_unfinished--;
+    }
+
+    bool JobSystem::execute_main_jobs() {
+        assert(std::this_thread::get_id() == m_main_thread);
+
+        std::vector<std::shared_ptr<JobState>> main_jobs;
+
+        {
+            std::lock_guard lock {m_main_mutex};
+
+            std::swap(main_jobs, m_main_jobs);
+        }
+
+        for (const auto& state : main_jobs) {
+            execute(state);
+        }
+
+        return !main_jobs.empty();
+    }
+
+    bool JobSystem::try_execute(std::size_t worker_index) {
+        const auto state {pop(worker_index)};
+
+        if (state == nullptr) {
+            return false;
+        }
+
+        execute(state);
+
+        return true;
+    }
+
+    std::shared_ptr<JobState> JobSystem::pop(std::size_t worker_index) {
+        // Newest job first from the own queue
+        {
+            Worker& worker {*m_workers[worker_index]};
+            std::lock_guard lock {worker.mutex};
+
+            if (!worker.queue.empty()) {
+                auto state {std::move(worker.queue.back())};
+                worker.queue.pop_back();
+                m_queued--;
+
+                return state;
+            }
+        }
+
+        // Oldest job first from the others
+        for (std::size_t i {1}; i < m_workers.size(); i++) {
+            Worker& worker {*m_workers[(worker_index + i) % m_workers.size()]};
+            std::lock_guard lock {worker.mutex};
+
+            if (!worker.queue.empty()) {
+                auto state {std::move(worker.queue.front())};
+                worker.queue.pop_front();
+                m_queued--;
+
+                return state;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void JobSystem::worker_loop(std::size_t worker_index) {
+        t_worker_index = worker_index;
+
+        while (true) {
+            if (try_execute(worker_index)) {
+                continue;
+            }
+
+            std::unique_lock lock {m_sleep_mutex};
+
+            m_sleep.wait(lock, [this]() {
+                return !m_running || m_queued.load() > 0;
+            });
+
+            if (!m_running) {
+                break;
+            }
+        }
+    }
+
+    void JobSystem::throw_exception() {
+        std::exception_ptr exception;
+
+        {
+            std::lock_guard lock {m_exception_mutex};
+
+            std::swap(exception, m_exception);
+        }
+
+        if (exception) {
+            try {
+                std::rethrow_exception(exception);
+            } catch (const RuntimeError& e) {
+                SM_THROW_ERROR(OtherError, "An error occurred inside a job: {}", e.what());
+            }
+        }
+    }
+}
@@ -0,0 +1,303 @@
+#include "nine_morris_3d_engine/application/internal/profiler.hpp"
+
+#include <array>
+#include <algorithm>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <utility>
+
+#include <glad/glad.h>
+
+#include "nine_morris_3d_engine/application/internal/error.hpp"
+#include "nine_morris_3d_engine/application/logging.hpp"
+#include "nine_morris_3d_engine/other/utilities.hpp"
+
+// trace format https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+
+namespace sm::internal {
+    static constexpr std::size_t FRAMES {128};
+    static constexpr std::size_t GPU_FRAMES {4};  // Frames in flight before the queries are read back
+    static constexpr std::size_t MAX_GPU_ZONES {32};
+
+    struct OpenZone {
+        const char* name {};
+        double begin {};
+    };
+
+    // Timer queries issued during one frame
+    struct GpuFrame {
+        std::uint64_t index {};
+        std::array<unsigned int, MAX_GPU_ZONES * 2> queries {};  // Begin and end timestamps
+        std::array<const char*, MAX_GPU_ZONES> names {};
+        std::size_t count {};
+        bool open {false};
+        bool pending {false};
+    };
+
+    static struct Profiler {
+        std::chrono::steady_clock::time_point epoch;
+        std::int64_t gpu_offset {};  // Nanoseconds from the CPU clock to the GPU clock
+
+        std::mutex mutex;  // Guards the current frame
+        profiler::Frame current;
+        std::array<profiler::Frame, FRAMES> frames;
+        std::uint64_t frame_index {};
+
+        std::array<GpuFrame, GPU_FRAMES> gpu_frames;
+        bool gpu_initialized {false};
+
+        std::atomic<std::size_t> next_thread {};
+    } g_profiler;
+
+    static thread_local std::vector<OpenZone> t_open_zones;
+
+    static std::int64_t now_nanoseconds() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - g_profiler.epoch
+        ).count();
+    }
+
+    static double now_microseconds() {
+        return static_cast<double>(now_nanoseconds()) / 1000.0;
+    }
+
+    static std::size_t thread_index() {
+        thread_local const std::size_t index {g_profiler.next_thread++};
+
+        return index;
+    }
+
+    static void collect_gpu_frame(GpuFrame& gpu_frame) {
+        if (!gpu_frame.pending) {
+            return;
+        }
+
+        gpu_frame.pending = false;
+
+        profiler::Frame& frame {g_profiler.frames[gpu_frame.index % FRAMES]};
+
+        // The ring has already moved past it
+        if (frame.index != gpu_frame.index) {
+            return;
+        }
+
+        frame.gpu_zones.clear();
+
+        for (std::size_t i {0}; i < gpu_frame.count; i++) {
+            GLuint64 begin {};
+            GLuint64 end {};
+
+            // Blocks only if the GPU is more than a few frames behind
+            glGetQueryObjectui64v(gpu_frame.queries[i * 2 + 0], GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(gpu_frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+
+            profiler::Zone zone;
+            zone.name = gpu_frame.names[i];
+            zone.begin = static_cast<double>(static_cast<std::int64_t>(begin) - g_profiler.gpu_offset) / 1000.0;
+            zone.duration = static_cast<double>(end - begin) / 1000.0;
+
+            frame.gpu_zones.push_back(zone);
+        }
+
+        frame.gpu_ready = true;
+    }
+
+    void profiler::initialize() {
+        g_profiler.epoch = std::chrono::steady_clock::now();
+
+        // The main thread records first
+        thread_index();
+
+        for (GpuFrame& gpu_frame : g_profiler.gpu_frames) {
+            glGenQueries(static_cast<GLsizei>(gpu_frame.queries.size()), gpu_frame.queries.data());
+        }
+
+        GLint64 gpu_time {};
+        glGetInteger64v(GL_TIMESTAMP, &gpu_time);
+
+        g_profiler.gpu_offset = static_cast<std::int64_t>(gpu_time) - now_nanoseconds();
+        g_profiler.gpu_initialized = true;
+
+        LOG_INFO("Initialized profiler");
+    }
+
+    void profiler::uninitialize() {
+        for (GpuFrame& gpu_frame : g_profiler.gpu_frames) {
+            glDeleteQueries(static_cast<GLsizei>(gpu_frame.queries.size()), gpu_frame.queries.data());
+        }
+
+        g_profiler.gpu_initialized = false;
+
+        LOG_INFO("Uninitialized profiler");
+    }
+
+    void profiler::begin_frame() {
+        {
+            std::lock_guard lock {g_profiler.mutex};
+
+            g_profiler.current.index = g_profiler.frame_index;
+            g_profiler.current.begin = now_microseconds();
+        }
+
+        if (!g_profiler.gpu_initialized) {
+            return;
+        }
+
+        // Reuse the queries of an old frame
+        GpuFrame& gpu_frame {g_profiler.gpu_frames[g_profiler.frame_index % GPU_FRAMES]};
+
+        collect_gpu_frame(gpu_frame);
+
+        gpu_frame.index = g_profiler.frame_index;
+        gpu_frame.count = 0;
+        gpu_frame.open = false;
+    }
+
+    void profiler::end_frame() {
+        {
+            std::lock_guard lock {g_profiler.mutex};
+
+            g_profiler.current.duration = now_microseconds() - g_profiler.current.begin;
+            g_profiler.current.gpu_zones.clear();
+            g_profiler.current.gpu_ready = false;
+
+            // Keep the memory of the frame that is overwritten
+            Frame& frame {g_profiler.frames[g_profiler.frame_index % FRAMES]};
+            std::swap(frame, g_profiler.current);
+            g_profiler.current.cpu_zones.clear();
+        }
+
+        if (g_profiler.gpu_initialized) {
+            g_profiler.gpu_frames[g_profiler.frame_index % GPU_FRAMES].pending = true;
+        }
+
+        g_profiler.frame_index++;
+    }
+
+    void profiler::begin_zone(const char* name) {
+        t_open_zones.push_back({name, now_microseconds()});
+    }
+
+    void profiler::end_zone() {
+        const double end {now_microseconds()};
+
+        const OpenZone open_zone {t_open_zones.back()};
+        t_open_zones.pop_back();
+
+        Zone zone;
+        zone.name = open_zone.name;
+        zone.begin = open_zone.begin;
+        zone.duration = end - open_zone.begin;
+        zone.thread = thread_index();
+        zone.depth = static_cast<unsigned int>(t_open_zones.size());
+
+        std::lock_guard lock {g_profiler.mutex};
+
+        g_profiler.current.cpu_zones.push_back(zone);
+    }
+
+    void profiler::begin_gpu_zone(const char* name) {
+        if (!g_profiler.gpu_initialized) {
+            return;
+        }
+
+        GpuFrame& gpu_frame {g_profiler.gpu_frames[g_profiler.frame_index % GPU_FRAMES]};
+
+        if (gpu_frame.count == MAX_GPU_ZONES) {
+            return;
+        }
+
+        glQueryCounter(gpu_frame.queries[gpu_frame.count * 2 + 0], GL_TIMESTAMP);
+        gpu_frame.names[gpu_frame.count] = name;
+        gpu_frame.open = true;
+    }
+
+    void profiler::end_gpu_zone() {
+        if (!g_profiler.gpu_initialized) {
+            return;
+        }
+
+        GpuFrame& gpu_frame {g_profiler.gpu_frames[g_profiler.frame_index % GPU_FRAMES]};
+
+        // The zone was dropped
+        if (!gpu_frame.open) {
+            return;
+        }
+
+        glQueryCounter(gpu_frame.queries[gpu_frame.count * 2 + 1], GL_TIMESTAMP);
+        gpu_frame.count++;
+        gpu_frame.open = false;
+    }
+
+    const profiler::Frame* profiler::get_last_frame() {
+        if (g_profiler.frame_index == 0) {
+            return nullptr;
+        }
+
+        return &g_profiler.frames[(g_profiler.frame_index - 1) % FRAMES];
+    }
+
+    const profiler::Frame* profiler::get_last_gpu_frame() {
+        const std::uint64_t frames {std::min<std::uint64_t>(g_profiler.frame_index, FRAMES)};
+
+        for (std::uint64_t i {1}; i <= frames; i++) {
+            const Frame& frame {g_profiler.frames[(g_profiler.frame_index - i) % FRAMES]};
+
+            if (frame.gpu_ready) {
+                return &frame;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void profiler::export_chrome_trace(const std::filesystem::path& file_path) {
+        const std::uint64_t frames {std::min<std::uint64_t>(g_profiler.frame_index, FRAMES)};
+
+        std::string buffer;
+        buffer += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+        // The CPU is the first process and the GPU is the second one
+        buffer += R"({"name":"process_name","ph":"M","pid":0,"tid":0,"args":{"name":"CPU"}},)" "\n";
+        buffer += R"({"name":"process_name","ph":"M","pid":1,"tid":0,"args":{"name":"GPU"}})";
+
+        const auto event {[&buffer](const char* name, double begin, double duration, int process, std::size_t thread) {
+            buffer += fmt::format(
+                ",\n{{\"name\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":{},\"tid\":{}}}",
+                name,
+                begin,
+                duration,
+                process,
+                thread
+            );
+        }};
+
+        // From oldest to newest
+        for (std::uint64_t i {frames}; i > 0; i--) {
+            const Frame& frame {g_profiler.frames[(g_profiler.frame_index - i) % FRAMES]};
+
+            event("Frame", frame.begin, frame.duration, 0, 0);
+
+            for (const Zone& zone : frame.cpu_zones) {
+                event(zone.name, zone.begin, zone.duration, 0, zone.thread);
+            }
+
+            for (const Zone& zone : frame.gpu_zones) {
+                event(zone.name, zone.begin, zone.duration, 1, 0);
+            }
+        }
+
+        buffer += "\n]}\n";
+
+        try {
+            utils::write_file_ex(file_path, buffer, true);
+        } catch (const ResourceError& e) {
+            LOG_ERROR("Could not export trace `{}`: {}", file_path.string(), e.what());
+            return;
+        }
+
+        LOG_INFO("Exported trace of {} frames to `{}`", frames, file_path.string());
+    }
+}
@@ -1,10 +1,7 @@
 #include "nine_morris_3d_engine/application/internal/task_manager.hpp"
 
-#include <algorithm>
-#include <exception>
-
 #include "nine_morris_3d_engine/application/internal/window.hpp"
-#include "nine_morris_3d_engine/application/internal/error.hpp"
+#include "nine_morris_3d_engine/application/internal/profiler.hpp"
 #include "nine_morris_3d_engine/application/logging.hpp"
 
 namespace sm::internal {
@@ -26,46 +23,12 @@ namespace sm::internal {
         m_tasks_next.emplace_back(std::move(function), Window::get_time(), 0.0, true);
     }
 
-    void TaskManager::add_async(AsyncTask::Function&& function) {
-        std::lock_guard lock {m_async_mutex};
-
-        m_async_tasks.push_back(std::make_unique<AsyncTask>(std::move(function)));
-    }
-
     void TaskManager::update() {
-        {
-            std::lock_guard lock {m_mutex};
+        SM_PROFILE_SCOPE("Tasks");
 
-            update_tasks();
-        }
-
-        {
-            std::lock_guard lock {m_async_mutex};
-
-            update_async_tasks();
-        }
-    }
-
-    void TaskManager::wait_async() {
-        std::lock_guard lock {m_async_mutex};
-
-        for (const auto& async_task : m_async_tasks) {
-            async_task->m_stop.store(true);
-        }
-
-        std::exception_ptr last_exception;
-
-        while (!m_async_tasks.empty()) {
-            try {
-                update_async_tasks();
-            } catch (const OtherError&) {
-                last_exception = std::current_exception();
-            }
-        }
+        std::lock_guard lock {m_mutex};
 
-        if (last_exception) {
-            std::rethrow_exception(last_exception);
-        }
+        update_tasks();
     }
 
     void TaskManager::clear() {
@@ -105,36 +68,4 @@ namespace sm::internal {
         std::swap(m_tasks_active, m_tasks_next);
         m_tasks_next.clear();
     }
-
-    void TaskManager::update_async_tasks() {
-        bool tasks_done {false};
-        std::exception_ptr exception;
-
-        for (const auto& async_task : m_async_tasks) {
-            if (async_task->m_done.load()) {
-                if (async_task->m_exception) {
-                    exception = async_task->m_exception;
-                }
-
-                tasks_done = true;
-            }
-        }
-
-        if (tasks_done) {
-            m_async_tasks.erase(
-                std::remove_if(m_async_tasks.begin(), m_async_tasks.end(), [](const std::unique_ptr<AsyncTask>& async_task) {
-                    return async_task->m_done.load();
-                }),
-                m_async_tasks.cend()
-            );
-        }
-
-        if (exception) {
-            try {
-                std::rethrow_exception(exception);
-            } catch (const RuntimeError& e) {
-                SM_THROW_ERROR(OtherError, "An error occurred inside an async task: {}", e.what());
-            }
-        }
-    }
 }
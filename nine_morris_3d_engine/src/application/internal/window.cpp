@@ -17,7 +17,18 @@
 
 namespace sm::internal {
     Window::Window(const ApplicationProperties& properties, EventDispatcher& evt)
-        : m_width(properties.width), m_height(properties.height), m_evt(evt) {
+        : m_width(properties.width), m_height(properties.height), m_headless(properties.headless), m_evt(evt) {
+        if (m_headless) {
+            // Without a GPU, the driver falls back to a software rasterizer, like Mesa's llvmpipe
+            if (!SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen")) {
+                SM_THROW_ERROR(VideoError, "Could not set offscreen video driver: {}", SDL_GetError());
+            }
+
+            if (!SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy")) {
+                LOG_DIST_ERROR("Could not set dummy audio driver: {}", SDL_GetError());
+            }
+        }
+
         if (!SDL_Init(SDL_INIT_VIDEO)) {
             SM_THROW_ERROR(VideoError, "Could not initialize SDL: {}", SDL_GetError());
         }
@@ -80,7 +91,8 @@ namespace sm::internal {
             SM_THROW_ERROR(VideoError, "Could not initialize GLAD");
         }
 
-        if (!SDL_GL_SetSwapInterval(1)) {
+        // Don't wait for a display that isn't there
+        if (!SDL_GL_SetSwapInterval(m_headless ? 0 : 1)) {
             LOG_DIST_ERROR("Could not set swap interval: {}", SDL_GetError());
         }
 
@@ -92,7 +104,11 @@ namespace sm::internal {
         opengl_debug::initialize();
 #endif
 
-        LOG_INFO("Initialized SDL and created window and OpenGL context");
+        if (m_headless) {
+            LOG_INFO("Initialized SDL and created offscreen window and OpenGL context");
+        } else {
+            LOG_INFO("Initialized SDL and created window and OpenGL context");
+        }
     }
 
     Window::~Window() {
@@ -112,12 +128,20 @@ namespace sm::internal {
     }
 
     void Window::show() const {
+        if (m_headless) {
+            return;
+        }
+
         if (!SDL_ShowWindow(m_window)) {
             SM_THROW_ERROR(VideoError, "Could not show window: {}", SDL_GetError());
         }
     }
 
     void Window::set_vsync(bool enable) const {
+        if (m_headless) {
+            return;
+        }
+
         if (!SDL_GL_SetSwapInterval(static_cast<int>(enable))) {
             LOG_DIST_ERROR("Could not set swap interval: {}", SDL_GetError());
         }
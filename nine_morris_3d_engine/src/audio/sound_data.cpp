@@ -15,6 +15,7 @@ namespace sm {
         }
 
         m_data = data;
+        m_size = data->alen;
 
         LOG_DEBUG("Loaded sound data");
     }
@@ -3,6 +3,8 @@
 #include <cstring>
 #include <cstddef>
 #include <cassert>
+#include <optional>
+#include <utility>
 
 #include <stb_truetype.h>
 #include <stb_image_write.h>
@@ -11,10 +13,19 @@
 #include "nine_morris_3d_engine/application/internal/error.hpp"
 #include "nine_morris_3d_engine/application/platform.hpp"
 #include "nine_morris_3d_engine/application/logging.hpp"
+#include "nine_morris_3d_engine/graphics/internal/font_atlas_cache.hpp"
 
 namespace sm {
-    Font::Font(const std::string& buffer, const FontSpecification& specification)
-        : m_font_buffer(buffer), m_size_height(specification.size_height), m_bitmap_size(specification.bitmap_size) {
+    // Distance field glyphs are surrounded by this many pixels, in which the distance fades out
+    static constexpr int DISTANCE_FIELD_PADDING {4};
+
+    // Distance fields of smaller glyphs lose their corners and thin strokes, so glyphs are generated at least this
+    // tall and their quads are scaled down to the size of the font
+    static constexpr float DISTANCE_FIELD_SIZE_HEIGHT {40.0f};
+
+    Font::Font(const std::string& buffer, const FontSpecification& specification, const internal::FontAtlasCache* cache)
+        : m_font_buffer(buffer), m_cache(cache), m_size_height(specification.size_height), m_bitmap_size(specification.bitmap_size),
+        m_distance_field(specification.distance_field) {
         assert(m_bitmap_size % 4 == 0);  // Needs 4 byte alignment
 
         m_font_info = new stbtt_fontinfo;
@@ -42,9 +53,7 @@ namespace sm {
     }
 
     Font::~Font() {
-        for (const PackRange& pack_range : m_pack_ranges) {
-            delete[] static_cast<stbtt_packedchar*>(pack_range.packed_characters);
-        }
+        free_pack_ranges();
 
         delete m_font_info;
 
@@ -55,22 +64,22 @@ namespace sm {
         return m_bitmap_texture.get();
     }
 
+    bool Font::is_distance_field() const {
+        return m_distance_field;
+    }
+
     void Font::begin_baking() {
         LOG_DEBUG("Begin baking font");
 
-        m_bitmap = std::make_unique<unsigned char[]>(m_bitmap_size * m_bitmap_size);
-        m_pack_context = new stbtt_pack_context;
-
-        if (!stbtt_PackBegin(m_pack_context, m_bitmap.get(), m_bitmap_size, m_bitmap_size, 0, 1, nullptr)) {
-            SM_THROW_ERROR(internal::ResourceError, "Could not begin packing");
-        }
+        free_pack_ranges();
+        m_packed = false;
 
+        m_bitmap.reset();
         m_bitmap_texture.reset();
     }
 
     void Font::end_baking(const char* name) {
-        stbtt_PackEnd(m_pack_context);
-        delete m_pack_context;
+        pack();
 
         TextureSpecification specification;
         specification.format = TextureFormat::R8;
@@ -88,17 +97,11 @@ namespace sm {
     }
 
     void Font::bake_characters(int begin_codepoint, int count) {
+        assert(!m_packed);
+
         PackRange& pack_range {m_pack_ranges.emplace_back()};
 
         pack_range.packed_characters = new stbtt_packedchar[count];
-
-        const auto* data {reinterpret_cast<unsigned char*>(m_font_buffer.data())};
-        auto* characters {static_cast<stbtt_packedchar*>(pack_range.packed_characters)};
-
-        if (!stbtt_PackFontRange(m_pack_context, data, 0, m_size_height, begin_codepoint, count, characters)) {
-            SM_THROW_ERROR(internal::ResourceError, "Could not pack range [{}, {}]", begin_codepoint, begin_codepoint + count);
-        }
-
         pack_range.begin_codepoint = begin_codepoint;
         pack_range.count = count;
     }
@@ -107,6 +110,63 @@ namespace sm {
         bake_characters(32, 95);
     }
 
+    void Font::pack() {
+        if (m_packed) {
+            return;
+        }
+
+        std::uint64_t key {};
+
+        if (m_cache != nullptr) {
+            std::vector<std::pair<int, int>> ranges;
+
+            for (const PackRange& pack_range : m_pack_ranges) {
+                ranges.emplace_back(pack_range.begin_codepoint, pack_range.count);
+            }
+
+            FontSpecification specification;
+            specification.size_height = m_size_height;
+            specification.bitmap_size = m_bitmap_size;
+            specification.distance_field = m_distance_field;
+
+            key = m_cache->key(m_font_buffer, specification, ranges);
+
+            auto atlas {m_cache->load(key)};
+
+            if (atlas && load_atlas(std::move(*atlas))) {
+                m_packed = true;
+
+                LOG_DEBUG("Loaded font atlas from cache");
+
+                return;
+            }
+        }
+
+        m_bitmap = std::make_unique<unsigned char[]>(m_bitmap_size * m_bitmap_size);
+
+        if (m_distance_field) {
+            pack_distance_field();
+        } else {
+            pack_bitmap();
+        }
+
+        m_packed = true;
+
+        if (m_cache != nullptr) {
+            internal::FontAtlas atlas;
+            atlas.bitmap.assign(reinterpret_cast<const char*>(m_bitmap.get()), m_bitmap_size * m_bitmap_size);
+
+            for (const PackRange& pack_range : m_pack_ranges) {
+                atlas.packed_characters.emplace_back(
+                    static_cast<const char*>(pack_range.packed_characters),
+                    pack_range.count * sizeof(stbtt_packedchar)
+                );
+            }
+
+            m_cache->store(key, atlas);
+        }
+    }
+
     void Font::render(const std::string& string, int index, std::vector<CharacterBuffer>& buffer) const {
         const std::u32string utf32_string {utf8::utf8to32(string)};
 
@@ -237,6 +297,151 @@ namespace sm {
         quad->t1 = aligned_quad.t1;
     }
 
+    void Font::pack_bitmap() {
+        stbtt_pack_context pack_context {};
+
+        if (!stbtt_PackBegin(&pack_context, m_bitmap.get(), m_bitmap_size, m_bitmap_size, 0, 1, nullptr)) {
+            SM_THROW_ERROR(internal::ResourceError, "Could not begin packing");
+        }
+
+        const auto* data {reinterpret_cast<unsigned char*>(m_font_buffer.data())};
+
+        for (const PackRange& pack_range : m_pack_ranges) {
+            auto* characters {static_cast<stbtt_packedchar*>(pack_range.packed_characters)};
+
+            if (!stbtt_PackFontRange(&pack_context, data, 0, m_size_height, pack_range.begin_codepoint, pack_range.count, characters)) {
+                stbtt_PackEnd(&pack_context);
+
+                SM_THROW_ERROR(
+                    internal::ResourceError,
+                    "Could not pack range [{}, {}]",
+                    pack_range.begin_codepoint,
+                    pack_range.begin_codepoint + pack_range.count
+                );
+            }
+        }
+
+        stbtt_PackEnd(&pack_context);
+    }
+
+    void Font::pack_distance_field() {
+        const float size_height {glm::max(m_size_height, DISTANCE_FIELD_SIZE_HEIGHT)};
+        const float sf {stbtt_ScaleForPixelHeight(m_font_info, size_height)};
+        const float quad_scale {m_size_height / size_height};
+
+        // Glyphs are placed in rows, one pixel apart, like the rectangle packer does
+        int x {1};
+        int y {1};
+        int row_height {0};
+
+        for (const PackRange& pack_range : m_pack_ranges) {
+            auto* characters {static_cast<stbtt_packedchar*>(pack_range.packed_characters)};
+
+            for (int i {0}; i < pack_range.count; i++) {
+                const int codepoint {pack_range.begin_codepoint + i};
+
+                int advance_width {};
+                stbtt_GetCodepointHMetrics(m_font_info, codepoint, &advance_width, nullptr);
+
+                stbtt_packedchar& character {characters[i]};
+                character = {};
+                character.xadvance = static_cast<float>(advance_width) * m_sf;
+
+                int width {};
+                int height {};
+                int x_offset {};
+                int y_offset {};
+
+                unsigned char* glyph {stbtt_GetCodepointSDF(
+                    m_font_info,
+                    sf,
+                    codepoint,
+                    DISTANCE_FIELD_PADDING,
+                    static_cast<unsigned char>(DISTANCE_FIELD_EDGE),
+                    static_cast<float>(DISTANCE_FIELD_EDGE) / static_cast<float>(DISTANCE_FIELD_PADDING),
+                    &width,
+                    &height,
+                    &x_offset,
+                    &y_offset
+                )};
+
+                // Blank glyphs only advance
+                if (glyph == nullptr) {
+                    continue;
+                }
+
+                if (x + width + 1 > m_bitmap_size) {
+                    x = 1;
+                    y += row_height + 1;
+                    row_height = 0;
+                }
+
+                if (y + height + 1 > m_bitmap_size) {
+                    stbtt_FreeSDF(glyph, nullptr);
+
+                    SM_THROW_ERROR(
+                        internal::ResourceError,
+                        "Could not pack range [{}, {}]",
+                        pack_range.begin_codepoint,
+                        pack_range.begin_codepoint + pack_range.count
+                    );
+                }
+
+                for (int row {0}; row < height; row++) {
+                    std::memcpy(m_bitmap.get() + (y + row) * m_bitmap_size + x, glyph + row * width, static_cast<std::size_t>(width));
+                }
+
+                stbtt_FreeSDF(glyph, nullptr);
+
+                character.x0 = static_cast<unsigned short>(x);
+                character.y0 = static_cast<unsigned short>(y);
+                character.x1 = static_cast<unsigned short>(x + width);
+                character.y1 = static_cast<unsigned short>(y + height);
+                character.xoff = static_cast<float>(x_offset) * quad_scale;
+                character.yoff = static_cast<float>(y_offset) * quad_scale;
+                character.xoff2 = static_cast<float>(x_offset + width) * quad_scale;
+                character.yoff2 = static_cast<float>(y_offset + height) * quad_scale;
+
+                x += width + 1;
+                row_height = glm::max(row_height, height);
+            }
+        }
+    }
+
+    bool Font::load_atlas(internal::FontAtlas&& atlas) {
+        const std::size_t bitmap_size {static_cast<std::size_t>(m_bitmap_size * m_bitmap_size)};
+
+        // The key already covers the ranges, so a mismatch means that the file is corrupted
+        if (atlas.bitmap.size() != bitmap_size || atlas.packed_characters.size() != m_pack_ranges.size()) {
+            LOG_WARNING("Invalid cached font atlas");
+            return false;
+        }
+
+        for (std::size_t i {0}; i < m_pack_ranges.size(); i++) {
+            if (atlas.packed_characters[i].size() != m_pack_ranges[i].count * sizeof(stbtt_packedchar)) {
+                LOG_WARNING("Invalid cached font atlas");
+                return false;
+            }
+        }
+
+        m_bitmap = std::make_unique<unsigned char[]>(bitmap_size);
+        std::memcpy(m_bitmap.get(), atlas.bitmap.data(), bitmap_size);
+
+        for (std::size_t i {0}; i < m_pack_ranges.size(); i++) {
+            std::memcpy(m_pack_ranges[i].packed_characters, atlas.packed_characters[i].data(), atlas.packed_characters[i].size());
+        }
+
+        return true;
+    }
+
+    void Font::free_pack_ranges() {
+        for (const PackRange& pack_range : m_pack_ranges) {
+            delete[] static_cast<stbtt_packedchar*>(pack_range.packed_characters);
+        }
+
+        m_pack_ranges.clear();
+    }
+
     void Font::write_bitmap_to_file([[maybe_unused]] const char* name, [[maybe_unused]] const unsigned char* bitmap, [[maybe_unused]] int size) {
 #ifndef SM_BUILD_DISTRIBUTION
         const auto file_name {"bitmap_" + std::string(name) + ".png"};
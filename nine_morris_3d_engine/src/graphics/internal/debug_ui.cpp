@@ -1,12 +1,15 @@
 #include "nine_morris_3d_engine/graphics/internal/debug_ui.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
+#include <limits>
 
 #include <imgui.h>
 #include <glm/gtc/type_ptr.hpp>
 
 #include "nine_morris_3d_engine/application/context.hpp"
+#include "nine_morris_3d_engine/application/internal/profiler.hpp"
 
 namespace sm::internal {
 #ifndef SM_BUILD_DISTRIBUTION
@@ -19,6 +22,9 @@ namespace sm::internal {
             ImGui::Checkbox("Texts", &m_texts);
             ImGui::Checkbox("Tasks", &m_tasks);
             ImGui::Checkbox("Frame Time", &m_frame_time);
+            ImGui::Checkbox("Renderer", &m_renderer);
+            ImGui::Checkbox("Resources", &m_resources);
+            ImGui::Checkbox("Profiler", &m_profiler);
 
             if (ImGui::Checkbox("VSync", &m_vsync)) {
                 ctx.m_win.set_vsync(m_vsync);
@@ -90,6 +96,18 @@ namespace sm::internal {
         if (m_frame_time) {
             frame_time(ctx);
         }
+
+        if (m_renderer) {
+            renderer(ctx);
+        }
+
+        if (m_resources) {
+            resources(ctx);
+        }
+
+        if (m_profiler) {
+            frame_profiler(ctx);
+        }
     }
 
     void DebugUi::render(const Scene& scene) {
@@ -222,7 +240,8 @@ namespace sm::internal {
     void DebugUi::tasks(Ctx& ctx) {
         if (ImGui::Begin("Debug Tasks")) {
             ImGui::Text("Tasks count: %lu", ctx.m_tsk.m_tasks_active.size());
-            ImGui::Text("Async tasks count: %lu", ctx.m_tsk.m_async_tasks.size());
+            ImGui::Text("Jobs count: %lu", ctx.m_job.m_unfinished.load());
+            ImGui::Text("Job threads: %lu", ctx.m_job.get_thread_count());
         }
 
         ImGui::End();
@@ -250,6 +269,95 @@ namespace sm::internal {
         ImGui::End();
     }
 
+    void DebugUi::renderer(Ctx& ctx) {
+        const RendererStatistics& statistics {ctx.m_rnd.get_statistics()};
+
+        if (ImGui::Begin("Debug Renderer")) {
+            ImGui::Text("Draw items: %lu", statistics.draw_items);
+            ImGui::Text("Drawn items: %lu (culled %lu)", statistics.drawn_items, statistics.culled_items);
+            ImGui::Text("Drawn shadow items: %lu (culled %lu)", statistics.drawn_shadow_items, statistics.culled_shadow_items);
+            ImGui::Text("Draw calls: %lu", statistics.draw_calls);
+            ImGui::Text("Shader changes: %lu", statistics.shader_changes);
+            ImGui::Text("Material changes: %lu", statistics.material_changes);
+            ImGui::Text("Vertex array changes: %lu", statistics.vertex_array_changes);
+            ImGui::Text("Culling changes: %lu", statistics.culling_changes);
+            ImGui::Text("Streamed bytes: %lu", statistics.streamed_bytes);
+        }
+
+        ImGui::End();
+    }
+
+    void DebugUi::resources(Ctx& ctx) {
+        if (ImGui::Begin("Debug Resources")) {
+            const std::size_t memory_budget {ctx.m_res.get_memory_budget()};
+
+            ImGui::Text("Memory usage: %.2f MiB", static_cast<double>(ctx.m_res.get_memory_usage()) / 1048576.0);
+
+            if (memory_budget == std::numeric_limits<std::size_t>::max()) {
+                ImGui::Text("Memory budget: unlimited");
+            } else {
+                ImGui::Text("Memory budget: %.2f MiB", static_cast<double>(memory_budget) / 1048576.0);
+            }
+
+            for (const auto& [name, cache] : ctx.m_res.get_caches()) {
+                const CacheStatistics statistics {cache->get_statistics()};
+
+                ImGui::Separator();
+                ImGui::Text("%s%s", name, cache->is_evictable() ? "" : " (not evictable)");
+                ImGui::Text("Count: %lu, size: %.2f KiB", statistics.count, static_cast<double>(statistics.size) / 1024.0);
+                ImGui::Text("Hits: %lu, misses: %lu, evictions: %lu", statistics.hits, statistics.misses, statistics.evictions);
+            }
+        }
+
+        ImGui::End();
+    }
+
+    void DebugUi::frame_profiler(Ctx& ctx) {
+        if (ImGui::Begin("Debug Profiler")) {
+            if (const profiler::Frame* frame {profiler::get_last_frame()}; frame != nullptr) {
+                ImGui::Text("CPU frame %lu: %.3f ms", static_cast<unsigned long>(frame->index), frame->duration / 1000.0);
+                ImGui::Separator();
+
+                // Zones are recorded when they end, so put parents before their children
+                m_profiler_zones = frame->cpu_zones;
+
+                std::sort(m_profiler_zones.begin(), m_profiler_zones.end(), [](const auto& lhs, const auto& rhs) {
+                    return lhs.thread != rhs.thread ? lhs.thread < rhs.thread : lhs.begin < rhs.begin;
+                });
+
+                for (const profiler::Zone& zone : m_profiler_zones) {
+                    ImGui::Text(
+                        "%*s%s: %.3f ms (thread %lu)",
+                        static_cast<int>(zone.depth * 2),
+                        "",
+                        zone.name,
+                        zone.duration / 1000.0,
+                        static_cast<unsigned long>(zone.thread)
+                    );
+                }
+            }
+
+            ImGui::Spacing();
+
+            if (const profiler::Frame* frame {profiler::get_last_gpu_frame()}; frame != nullptr) {
+                ImGui::Text("GPU frame %lu", static_cast<unsigned long>(frame->index));
+                ImGui::Separator();
+
+                for (const profiler::Zone& zone : frame->gpu_zones) {
+                    ImGui::Text("%s: %.3f ms", zone.name, zone.duration / 1000.0);
+                }
+            }
+
+            ImGui::Spacing();
+
+            if (ImGui::Button("Export Trace")) {
+                profiler::export_chrome_trace(ctx.path_logs("trace.json"));
+            }
+        }
+
+        ImGui::End();
+    }
+
     void DebugUi::shadows_lines(
         const Scene& scene,
         float left,
@@ -0,0 +1,151 @@
+#include "nine_morris_3d_engine/graphics/internal/font_atlas_cache.hpp"
+
+#include <string>
+#include <thread>
+#include <functional>
+#include <cstdio>
+#include <utility>
+
+#include "nine_morris_3d_engine/application/internal/error.hpp"
+#include "nine_morris_3d_engine/application/logging.hpp"
+#include "nine_morris_3d_engine/other/internal/binary_buffer.hpp"
+#include "nine_morris_3d_engine/other/utilities.hpp"
+
+namespace sm::internal {
+    static constexpr std::uint32_t MAGIC {0x41465053};  // SPFA
+    static constexpr std::uint32_t VERSION {2};
+
+    static bool read_atlas(BinaryReader& reader, FontAtlas& atlas) {
+        std::uint32_t magic {};
+        std::uint32_t version {};
+        std::uint32_t range_count {};
+
+        if (!reader.read_uint(magic) || magic != MAGIC || !reader.read_uint(version) || version != VERSION) {
+            return false;
+        }
+
+        if (!reader.read_string(atlas.bitmap) || !reader.read_uint(range_count)) {
+            return false;
+        }
+
+        for (std::uint32_t i {0}; i < range_count; i++) {
+            std::string packed_characters;
+
+            if (!reader.read_string(packed_characters)) {
+                return false;
+            }
+
+            atlas.packed_characters.push_back(std::move(packed_characters));
+        }
+
+        return reader.at_end();
+    }
+
+    FontAtlasCache::FontAtlasCache(const FileSystem& fs)
+        : m_directory(fs.path_saved_data("font_cache")) {
+        // Does nothing, if the directory already exists
+        try {
+            FileSystem::create_directory(m_directory);
+        } catch (const OtherError& e) {
+            LOG_DIST_WARNING("{}", e.what());
+            return;
+        }
+
+        m_enabled = true;
+
+        LOG_INFO("Using font cache `{}`", m_directory.string());
+    }
+
+    bool FontAtlasCache::is_enabled() const {
+        return m_enabled;
+    }
+
+    std::uint64_t FontAtlasCache::key(std::string_view font_buffer, const FontSpecification& specification, const std::vector<std::pair<int, int>>& ranges) const {
+        std::uint64_t result {HASH_BASIS};
+
+        result = hash_bytes(result, &VERSION, sizeof(VERSION));
+        result = hash_bytes(result, font_buffer.data(), font_buffer.size());
+        result = hash_bytes(result, &specification.size_height, sizeof(specification.size_height));
+        result = hash_bytes(result, &specification.bitmap_size, sizeof(specification.bitmap_size));
+        result = hash_bytes(result, &specification.distance_field, sizeof(specification.distance_field));
+
+        for (const auto& [begin_codepoint, count] : ranges) {
+            result = hash_bytes(result, &begin_codepoint, sizeof(begin_codepoint));
+            result = hash_bytes(result, &count, sizeof(count));
+        }
+
+        return result;
+    }
+
+    std::optional<FontAtlas> FontAtlasCache::load(std::uint64_t key) const {
+        if (!m_enabled) {
+            return std::nullopt;
+        }
+
+        std::string buffer;
+
+        try {
+            buffer = utils::read_file_ex(file_path(key));
+        } catch (const ResourceError&) {
+            return std::nullopt;  // Not cached yet
+        }
+
+        BinaryReader reader {buffer};
+        FontAtlas atlas;
+
+        if (!read_atlas(reader, atlas)) {
+            LOG_WARNING("Invalid font cache file `{}`", file_path(key).string());
+            return std::nullopt;
+        }
+
+        return atlas;
+    }
+
+    void FontAtlasCache::store(std::uint64_t key, const FontAtlas& atlas) const {
+        if (!m_enabled) {
+            return;
+        }
+
+        BinaryWriter writer;
+        writer.write_uint(MAGIC);
+        writer.write_uint(VERSION);
+        writer.write_string(atlas.bitmap);
+        writer.write_uint(static_cast<std::uint32_t>(atlas.packed_characters.size()));
+
+        for (const std::string& packed_characters : atlas.packed_characters) {
+            writer.write_string(packed_characters);
+        }
+
+        // Written next to its final path and renamed into place, so that load() never reads a truncated file, even
+        // if the game crashes mid-write; fonts may be packed on several jobs, so the name is unique per thread
+        const auto temporary_file_path {
+            file_path(key).concat("." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp")
+        };
+
+        try {
+            utils::write_file_ex(temporary_file_path, writer.get_buffer());
+        } catch (const ResourceError& e) {
+            LOG_DIST_WARNING("Could not write font cache file `{}`: {}", temporary_file_path.string(), e.what());
+            return;
+        }
+
+        try {
+            FileSystem::rename_file(temporary_file_path, file_path(key));
+        } catch (const OtherError& e) {
+            LOG_DIST_WARNING("{}", e.what());
+
+            try {
+                FileSystem::delete_file(temporary_file_path);
+            } catch (const OtherError&) {
+                // Left behind, but never loaded
+            }
+        }
+    }
+
+    std::filesystem::path FontAtlasCache::file_path(std::uint64_t key) const {
+        char name[32] {};
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+
+        return m_directory / name;
+    }
+}
@@ -1,8 +1,17 @@
 #include "nine_morris_3d_engine/graphics/internal/opengl.hpp"
 
+#include <array>
+#include <cstddef>
+
 #include <glad/glad.h>
 
 namespace sm::internal {
+    static constexpr std::size_t TRACKED_TEXTURE_UNITS {16};
+    static constexpr unsigned int UNKNOWN_TEXTURE {~0u};
+
+    // The 2D texture bound to each unit; in the beginning, nothing is bound
+    static std::array<unsigned int, TRACKED_TEXTURE_UNITS> bound_textures_2d {};
+
     void opengl::initialize_default() {
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -48,28 +57,80 @@ namespace sm::internal {
     }
 
     void opengl::bind_texture_2d(unsigned int texture, int unit) {
+        const auto index {static_cast<std::size_t>(unit)};
+
+        if (index < TRACKED_TEXTURE_UNITS) {
+            if (bound_textures_2d[index] == texture) {
+                return;
+            }
+
+            bound_textures_2d[index] = texture;
+        }
+
         glActiveTexture(GL_TEXTURE0 + unit);
         glBindTexture(GL_TEXTURE_2D, texture);
     }
 
-    void opengl::draw_arrays(int count) {
-        glDrawArrays(GL_TRIANGLES, 0, count);
+    void opengl::invalidate_texture_2d_bindings() {
+        bound_textures_2d.fill(UNKNOWN_TEXTURE);
+    }
+
+    void opengl::uniform_mat4(int location, const float* matrix) {
+        glUniformMatrix4fv(location, 1, GL_FALSE, matrix);
+    }
+
+    void opengl::uniform_int(int location, int value) {
+        glUniform1i(location, value);
+    }
+
+    void opengl::uniform_float(int location, float value) {
+        glUniform1f(location, value);
+    }
+
+    void opengl::uniform_vec2(int location, const float* vector) {
+        glUniform2fv(location, 1, vector);
+    }
+
+    void opengl::uniform_vec3(int location, const float* vector) {
+        glUniform3fv(location, 1, vector);
+    }
+
+    void opengl::uniform_vec4(int location, const float* vector) {
+        glUniform4fv(location, 1, vector);
+    }
+
+    void opengl::draw_arrays(int count, int first) {
+        glDrawArrays(GL_TRIANGLES, first, count);
     }
 
-    void opengl::draw_arrays_lines(int count) {
-        glDrawArrays(GL_LINES, 0, count);
+    void opengl::draw_arrays_lines(int count, int first) {
+        glDrawArrays(GL_LINES, first, count);
     }
 
-    void opengl::draw_elements(int count) {
-        glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+    void opengl::draw_elements(int count, int base_vertex) {
+        glDrawElementsBaseVertex(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr, base_vertex);
     }
 
-    void opengl::draw_elements_instanced(int count, int instance_count) {
-        glDrawElementsInstanced(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr, instance_count);
+    void opengl::draw_elements_instanced(int count, int instance_count, int base_instance) {
+        glDrawElementsInstancedBaseInstance(
+            GL_TRIANGLES,
+            count,
+            GL_UNSIGNED_INT,
+            nullptr,
+            instance_count,
+            static_cast<GLuint>(base_instance)
+        );
     }
 
-    void opengl::draw_elements_adjacency(int count) {
-        glDrawElements(GL_TRIANGLES_ADJACENCY, count, GL_UNSIGNED_INT, nullptr);
+    void opengl::draw_elements_adjacency_instanced(int count, int instance_count, int base_instance) {
+        glDrawElementsInstancedBaseInstance(
+            GL_TRIANGLES_ADJACENCY,
+            count,
+            GL_UNSIGNED_INT,
+            nullptr,
+            instance_count,
+            static_cast<GLuint>(base_instance)
+        );
     }
 
     void opengl::disable_depth_test() {
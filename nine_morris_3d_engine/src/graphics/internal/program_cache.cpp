@@ -0,0 +1,200 @@
+#include "nine_morris_3d_engine/graphics/internal/program_cache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstddef>
+#include <utility>
+
+#include <glad/glad.h>
+
+#include "nine_morris_3d_engine/application/internal/error.hpp"
+#include "nine_morris_3d_engine/application/logging.hpp"
+#include "nine_morris_3d_engine/graphics/opengl/debug.hpp"
+#include "nine_morris_3d_engine/other/internal/binary_buffer.hpp"
+#include "nine_morris_3d_engine/other/utilities.hpp"
+
+namespace sm::internal {
+    static constexpr std::uint32_t MAGIC {0x42505053};  // SPPB
+    static constexpr std::uint32_t VERSION {1};
+
+    static bool read_binary(BinaryReader& reader, ProgramBinary& binary) {
+        std::uint32_t magic {};
+        std::uint32_t version {};
+        std::uint32_t format {};
+        std::uint32_t uniform_count {};
+        std::uint32_t uniform_block_count {};
+
+        if (!reader.read_uint(magic) || magic != MAGIC || !reader.read_uint(version) || version != VERSION) {
+            return false;
+        }
+
+        if (!reader.read_uint(format) || !reader.read_string(binary.data) || !reader.read_uint(uniform_count)) {
+            return false;
+        }
+
+        binary.format = format;
+
+        for (std::uint32_t i {0}; i < uniform_count; i++) {
+            std::string uniform;
+
+            if (!reader.read_string(uniform)) {
+                return false;
+            }
+
+            binary.uniforms.push_back(std::move(uniform));
+        }
+
+        if (!reader.read_uint(uniform_block_count)) {
+            return false;
+        }
+
+        for (std::uint32_t i {0}; i < uniform_block_count; i++) {
+            UniformBlockSpecification block;
+            std::uint32_t binding_index {};
+            std::uint32_t block_uniform_count {};
+
+            if (!reader.read_string(block.block_name) || !reader.read_uint(binding_index) || !reader.read_uint(block_uniform_count)) {
+                return false;
+            }
+
+            block.binding_index = binding_index;
+
+            for (std::uint32_t j {0}; j < block_uniform_count; j++) {
+                std::string uniform;
+
+                if (!reader.read_string(uniform)) {
+                    return false;
+                }
+
+                block.uniforms.push_back(std::move(uniform));
+            }
+
+            binary.uniform_blocks.push_back(std::move(block));
+        }
+
+        return reader.at_end();
+    }
+
+    ProgramCache::ProgramCache(const FileSystem& fs)
+        : m_directory(fs.path_saved_data("shader_cache")) {
+        int format_count {};
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+
+        if (format_count <= 0) {
+            LOG_INFO("Shader program binaries are not supported");
+            return;
+        }
+
+        m_formats.resize(static_cast<std::size_t>(format_count));
+        glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, m_formats.data());
+
+        // Does nothing, if the directory already exists
+        try {
+            FileSystem::create_directory(m_directory);
+        } catch (const OtherError& e) {
+            LOG_DIST_WARNING("{}", e.what());
+            return;
+        }
+
+        m_driver += opengl_debug::get_vendor();
+        m_driver += '\n';
+        m_driver += opengl_debug::get_renderer();
+        m_driver += '\n';
+        m_driver += opengl_debug::get_opengl_version();
+
+        m_enabled = true;
+
+        LOG_INFO("Using shader cache `{}`", m_directory.string());
+    }
+
+    bool ProgramCache::is_enabled() const {
+        return m_enabled;
+    }
+
+    std::uint64_t ProgramCache::key(std::initializer_list<std::string_view> sources) const {
+        std::uint64_t result {HASH_BASIS};
+
+        result = hash_bytes(result, m_driver.data(), m_driver.size());
+
+        // Sizes separate the stages
+        for (const std::string_view source : sources) {
+            const std::uint64_t size {source.size()};
+
+            result = hash_bytes(result, &size, sizeof(size));
+            result = hash_bytes(result, source.data(), source.size());
+        }
+
+        return result;
+    }
+
+    std::optional<ProgramBinary> ProgramCache::load(std::uint64_t key) const {
+        if (!m_enabled) {
+            return std::nullopt;
+        }
+
+        std::string buffer;
+
+        try {
+            buffer = utils::read_file_ex(file_path(key));
+        } catch (const ResourceError&) {
+            return std::nullopt;  // Not cached yet
+        }
+
+        BinaryReader reader {buffer};
+        ProgramBinary binary;
+
+        if (!read_binary(reader, binary)) {
+            LOG_WARNING("Invalid shader cache file `{}`", file_path(key).string());
+            return std::nullopt;
+        }
+
+        // The driver may have changed its formats without changing its version string
+        if (std::find(m_formats.cbegin(), m_formats.cend(), static_cast<int>(binary.format)) == m_formats.cend()) {
+            return std::nullopt;
+        }
+
+        return binary;
+    }
+
+    void ProgramCache::store(std::uint64_t key, const ProgramBinary& binary) const {
+        if (!m_enabled) {
+            return;
+        }
+
+        BinaryWriter writer;
+        writer.write_uint(MAGIC);
+        writer.write_uint(VERSION);
+        writer.write_uint(binary.format);
+        writer.write_string(binary.data);
+        writer.write_uint(static_cast<std::uint32_t>(binary.uniforms.size()));
+
+        for (const std::string& uniform : binary.uniforms) {
+            writer.write_string(uniform);
+        }
+
+        writer.write_uint(static_cast<std::uint32_t>(binary.uniform_blocks.size()));
+
+        for (const UniformBlockSpecification& block : binary.uniform_blocks) {
+            writer.write_string(block.block_name);
+            writer.write_uint(block.binding_index);
+            writer.write_uint(static_cast<std::uint32_t>(block.uniforms.size()));
+
+            for (const std::string& uniform : block.uniforms) {
+                writer.write_string(uniform);
+            }
+        }
+
+        try {
+            utils::write_file_ex(file_path(key), writer.get_buffer());
+        } catch (const ResourceError& e) {
+            LOG_DIST_WARNING("Could not write shader cache file `{}`: {}", file_path(key).string(), e.what());
+        }
+    }
+
+    std::filesystem::path ProgramCache::file_path(std::uint64_t key) const {
+        char name[32] {};
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+
+        return m_directory / name;
+    }
+}
@@ -2,12 +2,15 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/color_space.hpp>
 #include <resmanager/resmanager.hpp>
 
 #include "nine_morris_3d_engine/application/id.hpp"
+#include "nine_morris_3d_engine/application/internal/profiler.hpp"
+#include "nine_morris_3d_engine/application/logging.hpp"
 #include "nine_morris_3d_engine/graphics/internal/opengl.hpp"
 #include "nine_morris_3d_engine/graphics/opengl/vertex_array.hpp"
 #include "nine_morris_3d_engine/graphics/opengl/buffer.hpp"
@@ -18,11 +21,65 @@
 // shader uniform limit https://www.khronos.org/opengl/wiki/Uniform_(GLSL)#Implementation_limits
 // gamma https://blog.johnnovak.net/2016/09/21/what-every-coder-should-know-about-gamma/
 // gamma https://www.cambridgeincolour.com/tutorials/gamma-correction.htm
+// frustum planes https://www.gamedevs.org/uploads/fast-extraction-viewing-frustum-planes-from-world-view-projection-matrix.pdf
 
 using namespace resmanager::literals;
 
 namespace sm::internal {
-    Renderer::Renderer(int width, int height, const FileSystem& fs, const ShaderLibrary& shd) {
+    static void apply_node_flag(NodeFlag flag, bool& value) {
+        switch (flag) {
+            case NodeFlag::Inherited:
+                break;
+            case NodeFlag::Enabled:
+                value = true;
+                break;
+            case NodeFlag::Disabled:
+                value = false;
+                break;
+        }
+    }
+
+    // Planes of the volume that a clip space matrix projects, pointing inside; not normalized
+    static std::array<glm::vec4, 6> extract_planes(const glm::mat4& matrix) {
+        const glm::vec4 row0 {matrix[0][0], matrix[1][0], matrix[2][0], matrix[3][0]};
+        const glm::vec4 row1 {matrix[0][1], matrix[1][1], matrix[2][1], matrix[3][1]};
+        const glm::vec4 row2 {matrix[0][2], matrix[1][2], matrix[2][2], matrix[3][2]};
+        const glm::vec4 row3 {matrix[0][3], matrix[1][3], matrix[2][3], matrix[3][3]};
+
+        return {
+            row3 + row0,
+            row3 - row0,
+            row3 + row1,
+            row3 - row1,
+            row3 + row2,
+            row3 - row2
+        };
+    }
+
+    static glm::mat4 calculate_light_space_matrix(const Scene& scene) {
+        const glm::mat4 projection {
+            glm::ortho(
+                scene.root_node_3d->shadow_box.left,
+                scene.root_node_3d->shadow_box.right,
+                scene.root_node_3d->shadow_box.bottom,
+                scene.root_node_3d->shadow_box.top,
+                scene.root_node_3d->shadow_box.near_,
+                scene.root_node_3d->shadow_box.far_
+            )
+        };
+
+        const glm::mat4 view {
+            glm::lookAt(
+                scene.root_node_3d->shadow_box.position,
+                scene.root_node_3d->directional_light.direction,
+                glm::vec3(0.0f, 1.0f, 0.0f)
+            )
+        };
+
+        return projection * view;
+    }
+
+    Renderer::Renderer(int width, int height, const FileSystem& fs, const ShaderLibrary& shd, const ProgramCache& prg) {
         opengl::initialize_default();
         opengl::enable_depth_test();
 
@@ -46,14 +103,16 @@ namespace sm::internal {
             // Doesn't have uniform buffers for sure
             m_storage.screen_quad_shader = std::make_unique<GlShader>(
                 utils::read_file(fs.path_engine_assets("shaders/internal/screen_quad.vert")),
-                utils::read_file(fs.path_engine_assets("shaders/internal/screen_quad.frag"))
+                utils::read_file(fs.path_engine_assets("shaders/internal/screen_quad.frag")),
+                &prg
             );
         }
 
         {
             m_storage.shadow_shader = std::make_shared<GlShader>(
                 utils::read_file(fs.path_engine_assets("shaders/internal/shadow.vert")),
-                utils::read_file(fs.path_engine_assets("shaders/internal/shadow.frag"))
+                utils::read_file(fs.path_engine_assets("shaders/internal/shadow.frag")),
+                &prg
             );
 
             register_shader(m_storage.shadow_shader);
@@ -69,7 +128,23 @@ namespace sm::internal {
                 shd.load_shader(
                     utils::read_file(fs.path_engine_assets("shaders/internal/text.frag")),
                     {{"D_MAX_TEXTS", std::to_string(SHADER_MAX_BATCH_TEXTS)}}
-                )
+                ),
+                &prg
+            );
+
+            m_storage.text_distance_field_shader = std::make_unique<GlShader>(
+                shd.load_shader(
+                    utils::read_file(fs.path_engine_assets("shaders/internal/text.vert")),
+                    {{"D_MAX_TEXTS", std::to_string(SHADER_MAX_BATCH_TEXTS)}}
+                ),
+                shd.load_shader(
+                    utils::read_file(fs.path_engine_assets("shaders/internal/text.frag")),
+                    {
+                        {"D_MAX_TEXTS", std::to_string(SHADER_MAX_BATCH_TEXTS)},
+                        {"D_DISTANCE_FIELD_EDGE", std::to_string(Font::DISTANCE_FIELD_EDGE)}
+                    }
+                ),
+                &prg
             );
         }
 
@@ -77,7 +152,8 @@ namespace sm::internal {
             // Doesn't have uniform buffers for sure
             m_storage.quad_shader = std::make_unique<GlShader>(
                 utils::read_file(fs.path_engine_assets("shaders/internal/quad.vert")),
-                utils::read_file(fs.path_engine_assets("shaders/internal/quad.frag"))
+                utils::read_file(fs.path_engine_assets("shaders/internal/quad.frag")),
+                &prg
             );
 
             m_storage.quad_shader->bind();
@@ -89,7 +165,8 @@ namespace sm::internal {
             // Doesn't have uniform buffers for sure
             m_storage.skybox_shader = std::make_unique<GlShader>(
                 utils::read_file(fs.path_engine_assets("shaders/internal/skybox.vert")),
-                utils::read_file(fs.path_engine_assets("shaders/internal/skybox.frag"))
+                utils::read_file(fs.path_engine_assets("shaders/internal/skybox.frag")),
+                &prg
             );
         }
 
@@ -97,7 +174,8 @@ namespace sm::internal {
             m_storage.outline_shader = std::make_shared<GlShader>(
                 utils::read_file(fs.path_engine_assets("shaders/internal/outline.vert")),
                 utils::read_file(fs.path_engine_assets("shaders/internal/outline.geom")),
-                utils::read_file(fs.path_engine_assets("shaders/internal/outline.frag"))
+                utils::read_file(fs.path_engine_assets("shaders/internal/outline.frag")),
+                &prg
             );
 
             register_shader(m_storage.outline_shader);
@@ -153,7 +231,7 @@ namespace sm::internal {
         }
 
         {
-            const auto vertex_buffer {std::make_shared<GlVertexBuffer>(MAX_QUADS_BUFFER_SIZE, DrawHint::Stream)};
+            const auto stream_buffer {std::make_shared<GlStreamBuffer>(QUADS_STREAM_REGION_SIZE)};
             const auto index_buffer {initialize_quads_index_buffer()};
 
             m_storage.quad_vertex_array = std::make_unique<GlVertexArray>();
@@ -163,18 +241,20 @@ namespace sm::internal {
                 layout.add(1, VertexBufferLayout::Float, 2);
                 layout.add(2, VertexBufferLayout::Int, 1);
 
-                va->add_vertex_buffer(vertex_buffer, layout);
+                va->add_vertex_buffer(stream_buffer, layout);
                 va->add_index_buffer(index_buffer);
                 va->bind_index_buffer(0);
             });
 
-            m_storage.wquad_vertex_buffer = vertex_buffer;
+            m_storage.wquad_stream_buffer = stream_buffer;
 
             m_storage.quad.buffer = std::make_unique<QuadVertex[]>(MAX_QUAD_COUNT * 4);
         }
 
+        m_storage.instance_stream_buffer = std::make_shared<GlStreamBuffer>(MAX_INSTANCE_COUNT * sizeof(Instance));
+
 #ifndef SM_BUILD_DISTRIBUTION
-        debug_initialize(fs);
+        debug_initialize(fs, prg);
 #endif
     }
 
@@ -204,18 +284,24 @@ namespace sm::internal {
         setup_scene_framebuffer(width, height, samples);
     }
 
-    void Renderer::set_scale(const FileSystem& fs, int scale) {
-        setup_default_font(fs, scale);
+    void Renderer::set_scale(int scale) {
+        m_scale = scale;
+    }
+
+    int Renderer::get_scale() const {
+        return m_scale;
     }
 
     void Renderer::set_shadow_map_size(int size) {
         setup_shadow_framebuffer(size);
     }
 
-    void Renderer::initialize(int width, int height, const FileSystem& fs, const RendererSpecification& specification) {
+    void Renderer::initialize(int width, int height, const FileSystem& fs, const FontAtlasCache& atl, const RendererSpecification& specification) {
         setup_scene_framebuffer(width, height, specification.samples);
         setup_shadow_framebuffer(specification.shadow_map_size);
-        setup_default_font(fs, specification.scale);
+        setup_default_font(fs, atl);
+
+        m_scale = specification.scale;
     }
 
     void Renderer::register_shader(std::shared_ptr<GlShader> shader) {
@@ -228,8 +314,24 @@ namespace sm::internal {
     }
 
     void Renderer::render(const Scene& scene, int width, int height) {
+        SM_PROFILE_SCOPE("Render");
+
+        m_statistics = {};
+
+        // Dear ImGui binds textures behind our back; within the frame, redundant binds are skipped
+        opengl::invalidate_texture_2d_bindings();
+
+        extract_scene(scene);
         set_and_upload_uniform_buffer_data(scene);
 
+        // Culling is conservative; boxes that intersect the volumes are kept
+        m_statistics.drawn_items = cull(scene.root_node_3d->camera.projection_view(), m_storage.scene.visible);
+        m_statistics.culled_items = m_storage.scene.items.size() - m_statistics.drawn_items;
+        m_statistics.drawn_shadow_items = cull(calculate_light_space_matrix(scene), m_storage.scene.visible_shadow);
+        m_statistics.culled_shadow_items = m_storage.scene.items.size() - m_statistics.drawn_shadow_items;
+
+        batch_models(scene);
+
         // Draw to depth buffer for shadows
         m_storage.shadow_map_framebuffer->bind();
         opengl::clear(opengl::Buffers::D);
@@ -238,7 +340,7 @@ namespace sm::internal {
             m_storage.shadow_map_framebuffer->get_specification().height
         );
 
-        draw_models_to_shadow_map(scene);
+        draw_models_to_shadow_map();
 
         // Draw normal things
         m_storage.scene_framebuffer->bind();
@@ -250,8 +352,8 @@ namespace sm::internal {
 
         opengl::bind_texture_2d(m_storage.shadow_map_framebuffer->get_depth_attachment(), SHADOW_MAP_UNIT);
 
-        draw_models(scene);
-        draw_models_outlined(scene);
+        draw_models();
+        draw_models_outlined();
 
         // Skybox is rendered last, but with its depth values modified to keep it in the background
         if (scene.root_node_3d->skybox.texture != nullptr) {
@@ -274,7 +376,11 @@ namespace sm::internal {
 
 #ifndef SM_BUILD_DISTRIBUTION
         debug_render(scene);
+        m_debug_storage.wstream_buffer.lock()->end_frame();
 #endif
+
+        m_storage.wquad_stream_buffer.lock()->end_frame();
+        m_storage.instance_stream_buffer->end_frame();
     }
 
     void Renderer::pre_setup() {
@@ -311,6 +417,350 @@ namespace sm::internal {
         return SHADER_MAX_POINT_LIGHTS;
     }
 
+    const RendererStatistics& Renderer::get_statistics() const {
+        return m_statistics;
+    }
+
+    void Renderer::extract_scene(const Scene& scene) {
+        SM_PROFILE_SCOPE("Extract scene");
+
+        m_storage.scene.items.clear();
+        m_storage.scene.point_lights.clear();
+        m_storage.scene.material_ordinals.clear();
+
+        extract_node(scene.root_node_3d.get(), Context3D());
+
+        // Group the draws by state, so that the passes change as little state as possible
+        std::sort(m_storage.scene.items.begin(), m_storage.scene.items.end(), [](const DrawItem& lhs, const DrawItem& rhs) {
+            return lhs.sort_key < rhs.sort_key;
+        });
+
+        calculate_bounds();
+
+        m_statistics.draw_items = m_storage.scene.items.size();
+    }
+
+    void Renderer::extract_node(const SceneNode3D* node, Context3D context) {
+        switch (node->type()) {
+            case SceneNode3DType::Root3D:
+                break;
+            case SceneNode3DType::OutlinedModel:
+                apply_node_flag(static_cast<const OutlinedModelNode*>(node)->outline, context.outline);
+                [[fallthrough]];
+            case SceneNode3DType::Model: {
+                const auto model_node {static_cast<const ModelNode*>(node)};
+
+                model_node->update_world_transform(context);
+
+                context.transform_scale *= model_node->scale;
+
+                apply_node_flag(model_node->disable_back_face_culling, context.disable_back_face_culling);
+                apply_node_flag(model_node->cast_shadow, context.cast_shadow);
+
+                DrawItem& item {m_storage.scene.items.emplace_back()};
+                item.transform = context.transform;
+                item.sort_key = calculate_sort_key(model_node);
+                item.model_node = model_node;
+                item.index_count = model_node->m_vertex_array->get_index_buffer(0)->get_index_count();
+                item.outline = context.outline;
+                item.disable_back_face_culling = context.disable_back_face_culling;
+                item.cast_shadow = context.cast_shadow;
+
+                if (node->type() == SceneNode3DType::OutlinedModel) {
+                    item.outlined_model_node = static_cast<const OutlinedModelNode*>(node);
+                }
+
+                break;
+            }
+            case SceneNode3DType::PointLight: {
+                const auto point_light_node {static_cast<const PointLightNode*>(node)};
+
+                context.transform = glm::translate(context.transform, point_light_node->position);
+                context.transform_version = TRANSFORM_VERSION_NONE;
+
+                PointLightItem& item {m_storage.scene.point_lights.emplace_back()};
+                item.point_light_node = point_light_node;
+                item.position = context.transform * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+                break;
+            }
+        }
+
+        for (const auto& child : node->m_children) {
+            extract_node(child.get(), context);
+        }
+    }
+
+    std::uint64_t Renderer::calculate_sort_key(const ModelNode* model_node) {
+        // Materials get small ordinals in the order in which they are first seen
+        const auto iter {m_storage.scene.material_ordinals.try_emplace(
+            model_node->m_material.get(),
+            static_cast<std::uint32_t>(m_storage.scene.material_ordinals.size())
+        ).first};
+
+        const std::uint64_t shader {model_node->m_material->get_shader()->get_id() & 0xFFFFu};
+        const std::uint64_t material {iter->second & 0xFFFFFFu};
+        const std::uint64_t vertex_array {model_node->m_vertex_array->get_id() & 0xFFFFFFu};
+
+        return (shader << 48) | (material << 24) | vertex_array;
+    }
+
+    void Renderer::calculate_bounds() {
+        DrawBounds& bounds {m_storage.scene.bounds};
+        const std::size_t count {m_storage.scene.items.size()};
+
+        bounds.center_x.resize(count);
+        bounds.center_y.resize(count);
+        bounds.center_z.resize(count);
+        bounds.extent_x.resize(count);
+        bounds.extent_y.resize(count);
+        bounds.extent_z.resize(count);
+
+        for (std::size_t i {0}; i < count; i++) {
+            const DrawItem& item {m_storage.scene.items[i]};
+            const utils::AABB& aabb {item.model_node->get_aabb()};
+            const glm::mat4& matrix {item.transform};
+
+            const glm::vec3 center {matrix * glm::vec4((aabb.min + aabb.max) * 0.5f, 1.0f)};
+            const glm::vec3 extent {(aabb.max - aabb.min) * 0.5f};
+
+            // Transforming a box yields a box that encloses the transformed box
+            bounds.center_x[i] = center.x;
+            bounds.center_y[i] = center.y;
+            bounds.center_z[i] = center.z;
+            bounds.extent_x[i] = glm::abs(matrix[0][0]) * extent.x + glm::abs(matrix[1][0]) * extent.y + glm::abs(matrix[2][0]) * extent.z;
+            bounds.extent_y[i] = glm::abs(matrix[0][1]) * extent.x + glm::abs(matrix[1][1]) * extent.y + glm::abs(matrix[2][1]) * extent.z;
+            bounds.extent_z[i] = glm::abs(matrix[0][2]) * extent.x + glm::abs(matrix[1][2]) * extent.y + glm::abs(matrix[2][2]) * extent.z;
+        }
+    }
+
+    std::size_t Renderer::cull(const glm::mat4& projection_view, std::vector<unsigned char>& visible) const {
+        SM_PROFILE_SCOPE("Cull");
+
+        const DrawBounds& bounds {m_storage.scene.bounds};
+        const std::size_t count {m_storage.scene.items.size()};
+
+        visible.assign(count, 1);
+
+        // Test all boxes against one plane at a time, so that the inner loop is simple enough to be vectorized
+        for (const glm::vec4& plane : extract_planes(projection_view)) {
+            const glm::vec3 absolute {glm::abs(glm::vec3(plane))};
+
+            for (std::size_t i {0}; i < count; i++) {
+                const float distance {
+                    plane.x * bounds.center_x[i] + plane.y * bounds.center_y[i] + plane.z * bounds.center_z[i] + plane.w
+                };
+
+                const float radius {
+                    absolute.x * bounds.extent_x[i] + absolute.y * bounds.extent_y[i] + absolute.z * bounds.extent_z[i]
+                };
+
+                visible[i] &= static_cast<unsigned char>(distance + radius >= 0.0f);
+            }
+        }
+
+        std::size_t result {};
+
+        for (const unsigned char value : visible) {
+            result += value;
+        }
+
+        return result;
+    }
+
+    void Renderer::batch_models(const Scene& scene) {
+        SM_PROFILE_SCOPE("Batch models");
+
+        auto& items {m_storage.scene.items};
+        auto& instances {m_storage.scene.instances};
+
+        m_storage.scene.batches.clear();
+        m_storage.scene.shadow_batches.clear();
+        m_storage.scene.outline_batches.clear();
+        m_storage.scene.shadow_order.clear();
+        m_storage.scene.outline_order.clear();
+        instances.clear();
+
+        // The items are sorted by state, so the ones that can be merged are consecutive
+        for (std::size_t i {0}; i < items.size(); i++) {
+            if (!m_storage.scene.visible[i]) {
+                continue;
+            }
+
+            const DrawItem& item {items[i]};
+
+            if (!m_storage.scene.batches.empty()) {
+                DrawBatch& last {m_storage.scene.batches.back()};
+
+                const bool compatible {
+                    item.model_node->m_material == last.item->model_node->m_material &&
+                    item.model_node->m_vertex_array == last.item->model_node->m_vertex_array &&
+                    item.disable_back_face_culling == last.item->disable_back_face_culling
+                };
+
+                if (compatible) {
+                    instances.push_back(Instance {item.transform, glm::vec4(0.0f), glm::vec4(item.model_node->highlight_color, 0.0f)});
+                    last.instance_count++;
+                    continue;
+                }
+            }
+
+            DrawBatch& batch {m_storage.scene.batches.emplace_back()};
+            batch.item = &item;
+            batch.base_instance = static_cast<int>(instances.size());
+            batch.instance_count = 1;
+
+            attach_instance_buffer(item.model_node->m_vertex_array.get());
+
+            instances.push_back(Instance {item.transform, glm::vec4(0.0f), glm::vec4(item.model_node->highlight_color, 0.0f)});
+        }
+
+        // The shadow pass doesn't care about materials, so it merges by vertex array only
+        for (std::size_t i {0}; i < items.size(); i++) {
+            if (items[i].cast_shadow && m_storage.scene.visible_shadow[i]) {
+                m_storage.scene.shadow_order.push_back(i);
+            }
+        }
+
+        std::stable_sort(m_storage.scene.shadow_order.begin(), m_storage.scene.shadow_order.end(), [&items](std::size_t lhs, std::size_t rhs) {
+            return items[lhs].model_node->m_vertex_array.get() < items[rhs].model_node->m_vertex_array.get();
+        });
+
+        for (const std::size_t index : m_storage.scene.shadow_order) {
+            const DrawItem& item {items[index]};
+
+            if (!m_storage.scene.shadow_batches.empty()) {
+                DrawBatch& last {m_storage.scene.shadow_batches.back()};
+
+                if (item.model_node->m_vertex_array == last.item->model_node->m_vertex_array) {
+                    instances.push_back(Instance {item.transform});
+                    last.instance_count++;
+                    continue;
+                }
+            }
+
+            DrawBatch& batch {m_storage.scene.shadow_batches.emplace_back()};
+            batch.item = &item;
+            batch.base_instance = static_cast<int>(instances.size());
+            batch.instance_count = 1;
+
+            attach_instance_buffer(item.model_node->m_vertex_array.get());
+
+            instances.push_back(Instance {item.transform});
+        }
+
+        // The outline pass draws the outline meshes on top of the models, merging them by outline vertex array
+        for (std::size_t i {0}; i < items.size(); i++) {
+            if (items[i].outline && items[i].outlined_model_node != nullptr && m_storage.scene.visible[i]) {
+                m_storage.scene.outline_order.push_back(i);
+            }
+        }
+
+        std::stable_sort(m_storage.scene.outline_order.begin(), m_storage.scene.outline_order.end(), [&items](std::size_t lhs, std::size_t rhs) {
+            return items[lhs].outlined_model_node->m_outline_vertex_array.get() < items[rhs].outlined_model_node->m_outline_vertex_array.get();
+        });
+
+        for (const std::size_t index : m_storage.scene.outline_order) {
+            const DrawItem& item {items[index]};
+            const OutlinedModelNode* outlined_model_node {item.outlined_model_node};
+
+            const glm::vec3 color {
+                m_color_correction ? glm::convertSRGBToLinear(outlined_model_node->outline_color) : outlined_model_node->outline_color
+            };
+
+            const float distance {glm::distance(
+                glm::vec3(item.transform * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)),
+                scene.root_node_3d->m_camera_position
+            )};
+
+            const Instance instance {item.transform, glm::vec4(color, utils::map(distance, 5.0f, 20.0f, 0.004f, 0.001f))};
+
+            if (!m_storage.scene.outline_batches.empty()) {
+                DrawBatch& last {m_storage.scene.outline_batches.back()};
+
+                if (outlined_model_node->m_outline_vertex_array == last.item->outlined_model_node->m_outline_vertex_array) {
+                    instances.push_back(instance);
+                    last.instance_count++;
+                    continue;
+                }
+            }
+
+            DrawBatch& batch {m_storage.scene.outline_batches.emplace_back()};
+            batch.item = &item;
+            batch.base_instance = static_cast<int>(instances.size());
+            batch.instance_count = 1;
+
+            attach_instance_buffer(outlined_model_node->m_outline_vertex_array.get());
+
+            instances.push_back(instance);
+        }
+
+        if (instances.empty()) {
+            return;
+        }
+
+        if (instances.size() > MAX_INSTANCE_COUNT) {
+            LOG_WARNING("Too many model instances: {}; some are not drawn", instances.size());
+
+            clip_batches(m_storage.scene.batches, MAX_INSTANCE_COUNT);
+            clip_batches(m_storage.scene.shadow_batches, MAX_INSTANCE_COUNT);
+            clip_batches(m_storage.scene.outline_batches, MAX_INSTANCE_COUNT);
+            instances.resize(MAX_INSTANCE_COUNT);
+        }
+
+        const std::size_t size {instances.size() * sizeof(Instance)};
+
+        m_storage.instance_stream_buffer->bind();
+        const std::size_t offset {m_storage.instance_stream_buffer->write(instances.data(), size, sizeof(Instance))};
+        GlStreamBuffer::unbind();
+
+        m_statistics.streamed_bytes += size;
+
+        // The base instances of the draws point into the region that has just been written
+        const int first_instance {static_cast<int>(offset / sizeof(Instance))};
+
+        for (auto* batches : {&m_storage.scene.batches, &m_storage.scene.shadow_batches, &m_storage.scene.outline_batches}) {
+            for (DrawBatch& batch : *batches) {
+                batch.base_instance += first_instance;
+            }
+        }
+    }
+
+    void Renderer::clip_batches(std::vector<DrawBatch>& batches, std::size_t instance_count) {
+        const int count {static_cast<int>(instance_count)};
+
+        batches.erase(
+            std::remove_if(batches.begin(), batches.end(), [count](const DrawBatch& batch) {
+                return batch.base_instance >= count;
+            }),
+            batches.cend()
+        );
+
+        for (DrawBatch& batch : batches) {
+            batch.instance_count = std::min(batch.instance_count, count - batch.base_instance);
+        }
+    }
+
+    void Renderer::attach_instance_buffer(GlVertexArray* vertex_array) const {
+        // Every vertex array drawn by the model passes gets it the first time, no matter who created it
+        if (vertex_array->has_vertex_buffer(m_storage.instance_stream_buffer.get())) {
+            return;
+        }
+
+        vertex_array->configure([this](GlVertexArray* va) {
+            // A matrix attribute takes four consecutive locations
+            VertexBufferLayout layout;
+            layout.add(INSTANCE_MODEL_MATRIX_LOCATION + 0, VertexBufferLayout::Float, 4, true);
+            layout.add(INSTANCE_MODEL_MATRIX_LOCATION + 1, VertexBufferLayout::Float, 4, true);
+            layout.add(INSTANCE_MODEL_MATRIX_LOCATION + 2, VertexBufferLayout::Float, 4, true);
+            layout.add(INSTANCE_MODEL_MATRIX_LOCATION + 3, VertexBufferLayout::Float, 4, true);
+            layout.add(INSTANCE_OUTLINE_LOCATION, VertexBufferLayout::Float, 4, true);
+            layout.add(INSTANCE_HIGHLIGHT_LOCATION, VertexBufferLayout::Float, 4, true);
+
+            va->add_vertex_buffer(m_storage.instance_stream_buffer, layout);
+        });
+    }
+
     void Renderer::set_and_upload_uniform_buffer_data(const Scene& scene) {
         for (const auto& [binding_index, wuniform_buffer] : m_storage.uniform_buffers) {
             const auto uniform_buffer {wuniform_buffer.lock()};
@@ -364,6 +814,7 @@ namespace sm::internal {
             step->setup(m_post_processing_context);
 
             opengl::draw_arrays(6);
+            m_statistics.draw_calls++;
 
             m_post_processing_context.last_texture = step->m_framebuffer->get_color_attachment(0);
             m_post_processing_context.textures.push_back(m_post_processing_context.last_texture);
@@ -371,6 +822,8 @@ namespace sm::internal {
     }
 
     void Renderer::finish_3d(const Scene& scene, int width, int height) {
+        SM_PROFILE_GPU_SCOPE("Post processing pass");
+
         opengl::disable_depth_test();
         opengl::clear_color(0.0f, 0.0f, 0.0f);
 
@@ -400,6 +853,7 @@ namespace sm::internal {
         shader->bind();
         opengl::bind_texture_2d(texture, 0);
         opengl::draw_arrays(6);
+        m_statistics.draw_calls++;
     }
 
     void Renderer::setup_shader_uniform_buffers(std::shared_ptr<GlShader> shader) {
@@ -415,6 +869,10 @@ namespace sm::internal {
             const auto uniform_buffer {std::make_shared<GlUniformBuffer>(block)};
             shader->add_uniform_buffer(uniform_buffer);
 
+            if (block.binding_index == POINT_LIGHT_UNIFORM_BLOCK_BINDING) {
+                setup_point_light_fields(*uniform_buffer);
+            }
+
             m_storage.uniform_buffers[block.binding_index] = uniform_buffer;
         }
     }
@@ -443,119 +901,108 @@ namespace sm::internal {
         }
     }
 
-    void Renderer::draw_models(const Scene& scene) {
-        scene.root_node_3d->traverse([this](const SceneNode3D* node, Context3D& context) {
-            auto model_node {dynamic_cast<const ModelNode*>(node)};
+    void Renderer::draw_models() {
+        SM_PROFILE_GPU_SCOPE("Models pass");
 
-            if (model_node == nullptr) {
-                return false;
-            }
+        BindState state;
+        bool back_face_culling {true};
 
-            if (context.outline) {
-                return false;  // This one is rendered differently
-            }
+        for (const DrawBatch& batch : m_storage.scene.batches) {
+            if (batch.item->disable_back_face_culling == back_face_culling) {
+                back_face_culling = !batch.item->disable_back_face_culling;
+                m_statistics.culling_changes++;
 
-            if (context.disable_back_face_culling) {
-                opengl::disable_back_face_culling();
-                draw_model(model_node, context);
-                opengl::enable_back_face_culling();
-            } else {
-                draw_model(model_node, context);
+                if (back_face_culling) {
+                    opengl::enable_back_face_culling();
+                } else {
+                    opengl::disable_back_face_culling();
+                }
             }
 
-            return false;
-        });
+            draw_model(batch, state);
+        }
+
+        if (!back_face_culling) {
+            opengl::enable_back_face_culling();
+        }
 
         GlVertexArray::unbind();
     }
 
-    void Renderer::draw_model(const ModelNode* model_node, const Context3D& context) {
-        model_node->m_vertex_array->bind();
-        model_node->m_material->bind_and_upload();
-        model_node->m_material->get_shader()->upload_uniform_mat4("u_model_matrix"_H, context.transform);
-
-        opengl::draw_elements(model_node->m_vertex_array->get_index_buffer(0)->get_index_count());
+    void Renderer::draw_model(const DrawBatch& batch, BindState& state) {
+        const MaterialInstance* material {batch.item->model_node->m_material.get()};
+        const GlVertexArray* vertex_array {batch.item->model_node->m_vertex_array.get()};
 
-        // Don't unbind the vertex array
-    }
+        if (vertex_array != state.vertex_array) {
+            vertex_array->bind();
+            state.vertex_array = vertex_array;
+            m_statistics.vertex_array_changes++;
+        }
 
-    void Renderer::draw_models_outlined(const Scene& scene) {
-        scene.root_node_3d->traverse([this, &scene](const SceneNode3D* node, Context3D& context) {
-            auto outlined_model_node {dynamic_cast<const OutlinedModelNode*>(node)};
+        if (material->get_shader() != state.shader) {
+            material->get_shader()->bind();
+            state.shader = material->get_shader();
+            m_statistics.shader_changes++;
+        }
 
-            if (outlined_model_node == nullptr) {
-                return false;
-            }
+        if (material != state.material) {
+            material->upload();
+            state.material = material;
+            m_statistics.material_changes++;
+        }
 
-            if (context.outline) {
-                draw_model_outlined(scene, outlined_model_node, context);
-            }
+        // The model matrices come from the instance buffer
+        opengl::draw_elements_instanced(batch.item->index_count, batch.instance_count, batch.base_instance);
+        m_statistics.draw_calls++;
 
-            return false;
-        });
+        // Don't unbind the vertex array
     }
 
-    void Renderer::draw_model_outlined(const Scene& scene, const OutlinedModelNode* outlined_model_node, const Context3D& context) {
-        {
-            outlined_model_node->m_vertex_array->bind();
-            outlined_model_node->m_material->bind_and_upload();
-            outlined_model_node->m_material->get_shader()->upload_uniform_mat4("u_model_matrix"_H, context.transform);
+    void Renderer::draw_models_outlined() {
+        SM_PROFILE_GPU_SCOPE("Outlined models pass");
 
-            opengl::draw_elements(outlined_model_node->m_vertex_array->get_index_buffer(0)->get_index_count());
+        if (m_storage.scene.outline_batches.empty()) {
+            return;
         }
 
         opengl::disable_back_face_culling();
 
-        {
-            outlined_model_node->m_outline_vertex_array->bind();
-
-            const glm::vec3 color {
-                m_color_correction ? glm::convertSRGBToLinear(outlined_model_node->outline_color) : outlined_model_node->outline_color
-            };
-
-            const float distance {glm::distance(
-                glm::vec3(context.transform * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)),
-                scene.root_node_3d->m_camera_position
-            )};
+        m_storage.outline_shader->bind();
+        m_storage.outline_shader->upload_uniform_float("u_overhang"_H, 0.03f);
+        m_statistics.shader_changes++;
 
-            m_storage.outline_shader->bind();
-            m_storage.outline_shader->upload_uniform_mat4("u_model_matrix"_H, context.transform);
-            m_storage.outline_shader->upload_uniform_float("u_width"_H, utils::map(distance, 5.0f, 20.0f, 0.004f, 0.001f));
-            m_storage.outline_shader->upload_uniform_float("u_overhang"_H, 0.03f);
-            m_storage.outline_shader->upload_uniform_vec3("u_color"_H, color);
+        for (const DrawBatch& batch : m_storage.scene.outline_batches) {
+            const GlVertexArray* vertex_array {batch.item->outlined_model_node->m_outline_vertex_array.get()};
 
-            opengl::draw_elements_adjacency(outlined_model_node->m_outline_vertex_array->get_index_buffer(0)->get_index_count());
+            vertex_array->bind();
+            m_statistics.vertex_array_changes++;
 
-            GlVertexArray::unbind();
+            // The model matrices, colors and widths come from the instance buffer
+            opengl::draw_elements_adjacency_instanced(vertex_array->get_index_buffer(0)->get_index_count(), batch.instance_count, batch.base_instance);
+            m_statistics.draw_calls++;
         }
 
+        GlVertexArray::unbind();
+
         opengl::enable_back_face_culling();
+        m_statistics.culling_changes += 2;
     }
 
-    void Renderer::draw_models_to_shadow_map(const Scene& scene) {
+    void Renderer::draw_models_to_shadow_map() {
+        SM_PROFILE_GPU_SCOPE("Shadow pass");
+
         opengl::disable_back_face_culling();
 
         m_storage.shadow_shader->bind();
+        m_statistics.shader_changes++;
 
-        scene.root_node_3d->traverse([this](const SceneNode3D* node, Context3D& context) {
-            auto model_node {dynamic_cast<const ModelNode*>(node)};
+        for (const DrawBatch& batch : m_storage.scene.shadow_batches) {
+            batch.item->model_node->m_vertex_array->bind();
+            m_statistics.vertex_array_changes++;
 
-            if (model_node == nullptr) {
-                return false;
-            }
-
-            if (!context.cast_shadow) {
-                return false;
-            }
-
-            model_node->m_vertex_array->bind();
-
-            m_storage.shadow_shader->upload_uniform_mat4("u_model_matrix"_H, context.transform);
-
-            opengl::draw_elements(model_node->m_vertex_array->get_index_buffer(0)->get_index_count());
-
-            return false;
-        });
+            opengl::draw_elements_instanced(batch.item->index_count, batch.instance_count, batch.base_instance);
+            m_statistics.draw_calls++;
+        }
 
         GlVertexArray::unbind();
 
@@ -563,6 +1010,8 @@ namespace sm::internal {
     }
 
     void Renderer::draw_skybox(const Scene& scene) {
+        SM_PROFILE_GPU_SCOPE("Skybox pass");
+
         const glm::mat4& projection {scene.root_node_3d->camera.projection()};
         const glm::mat4 view {glm::mat4(glm::mat3(scene.root_node_3d->camera.view()))};
 
@@ -573,16 +1022,17 @@ namespace sm::internal {
         scene.root_node_3d->skybox.texture->bind(0);
 
         opengl::draw_arrays(36);
+        m_statistics.draw_calls++;
 
         GlVertexArray::unbind();
     }
 
     void Renderer::draw_texts(const Scene& scene) {
-        opengl::disable_depth_test();
+        SM_PROFILE_GPU_SCOPE("Texts pass");
 
-        m_storage.text_shader->bind();
+        opengl::disable_depth_test();
 
-        std::vector<std::pair<const TextNode*, Context2D>> text_nodes;
+        auto& text_nodes {m_storage.text.nodes};
 
         scene.root_node_2d->traverse([&text_nodes](const SceneNode2D* node, Context2D& context) {
             auto text_node {dynamic_cast<const TextNode*>(node)};
@@ -618,25 +1068,69 @@ namespace sm::internal {
             m_storage.text.batches.back().texts.push_back(text_node);
         }
 
+        // Put the characters of all batches in one buffer, so that it can be uploaded at once
+        for (auto& batch : m_storage.text.batches) {
+            batch.first_character = m_storage.text.buffer.size();
+
+            for (int index {0}; const auto& text_node : batch.texts) {
+                for (Font::CharacterBuffer character : layout_text(text_node.first)) {
+                    character.i0 = index;
+                    character.i1 = index;
+                    character.i2 = index;
+                    character.i3 = index;
+                    character.i4 = index;
+                    character.i5 = index;
+
+                    m_storage.text.buffer.push_back(character);
+                }
+
+                index++;
+            }
+
+            batch.character_count = m_storage.text.buffer.size() - batch.first_character;
+        }
+
+        // Most text doesn't change from one frame to the next
+        const bool changed {
+            m_storage.text.buffer.size() != m_storage.text.uploaded_buffer.size() ||
+            !m_storage.text.buffer.empty() && std::memcmp(
+                m_storage.text.buffer.data(),
+                m_storage.text.uploaded_buffer.data(),
+                m_storage.text.buffer.size() * sizeof(Font::CharacterBuffer)
+            ) != 0
+        };
+
+        if (changed) {
+            const auto vertex_buffer {m_storage.wtext_vertex_buffer.lock()};
+            vertex_buffer->bind();
+            vertex_buffer->upload_data(m_storage.text.buffer.data(), m_storage.text.buffer.size() * sizeof(Font::CharacterBuffer));
+            GlVertexBuffer::unbind();
+
+            m_storage.text.uploaded_buffer = m_storage.text.buffer;
+        }
+
         for (const auto& batch : m_storage.text.batches) {
             draw_text_batch(scene, batch);
-            m_storage.text.batch_buffer.clear();
             m_storage.text.batch_matrices.clear();
             m_storage.text.batch_colors.clear();
         }
 
+        m_storage.text.nodes.clear();
         m_storage.text.batches.clear();
+        m_storage.text.buffer.clear();
 
         opengl::enable_depth_test();
     }
 
     void Renderer::draw_text_batch(const Scene& scene, const TextBatch& batch) {
-        for (std::size_t i {0}; const auto& text_node : batch.texts) {
-            assert(i < SHADER_MAX_BATCH_TEXTS);
+        // Batches are made of texts with the same font
+        const GlShader* shader {
+            batch.font->is_distance_field() ? m_storage.text_distance_field_shader.get() : m_storage.text_shader.get()
+        };
 
-            // Pushes the rendered text onto the buffer
-            batch.font->render(text_node.first->text, static_cast<int>(i++), m_storage.text.batch_buffer);
+        shader->bind();
 
+        for (const auto& text_node : batch.texts) {
             glm::mat4 matrix {1.0f};  // TODO upload mat3 instead
             matrix = glm::translate(matrix, glm::vec3(text_node.first->position, 0.0f));
             matrix = glm::scale(matrix, glm::vec3(text_node.first->scale, text_node.first->scale, 1.0f));
@@ -646,25 +1140,38 @@ namespace sm::internal {
         }
 
         // Uniforms must be set as arrays
-        m_storage.text_shader->upload_uniform_mat4_array("u_model_matrix[0]"_H, m_storage.text.batch_matrices);
-        m_storage.text_shader->upload_uniform_vec3_array("u_color[0]"_H, m_storage.text.batch_colors);
-        m_storage.text_shader->upload_uniform_mat4("u_projection_matrix"_H, scene.root_node_2d->camera.projection());
-
-        const auto vertex_buffer {m_storage.wtext_vertex_buffer.lock()};
-        vertex_buffer->bind();
-        vertex_buffer->upload_data(m_storage.text.batch_buffer.data(), m_storage.text.batch_buffer.size() * sizeof(Font::CharacterBuffer));
-        GlVertexBuffer::unbind();
+        shader->upload_uniform_mat4_array("u_model_matrix[0]"_H, m_storage.text.batch_matrices);
+        shader->upload_uniform_vec3_array("u_color[0]"_H, m_storage.text.batch_colors);
+        shader->upload_uniform_mat4("u_projection_matrix"_H, scene.root_node_2d->camera.projection());
 
         m_storage.text_vertex_array->bind();
 
         opengl::bind_texture_2d(batch.font->get_bitmap()->get_id(), 0);
 
-        opengl::draw_arrays(static_cast<int>(m_storage.text.batch_buffer.size()) * 6);
+        opengl::draw_arrays(static_cast<int>(batch.character_count) * 6, static_cast<int>(batch.first_character) * 6);
+        m_statistics.draw_calls++;
 
         GlVertexArray::unbind();
     }
 
+    const std::vector<Font::CharacterBuffer>& Renderer::layout_text(const TextNode* text_node) {
+        auto& layout {text_node->m_layout};
+
+        if (layout.font.lock() != text_node->m_font || layout.text != text_node->text) {
+            layout.font = text_node->m_font;
+            layout.text = text_node->text;
+            layout.characters.clear();
+
+            // The index is set when batching
+            text_node->m_font->render(text_node->text, 0, layout.characters);
+        }
+
+        return layout.characters;
+    }
+
     void Renderer::draw_images(const Scene& scene) {
+        SM_PROFILE_GPU_SCOPE("Images pass");
+
         opengl::disable_depth_test();
 
         m_storage.quad_shader->bind();
@@ -753,10 +1260,14 @@ namespace sm::internal {
     void Renderer::end_images_batch() {
         const std::size_t size {(m_storage.quad.buffer_pointer - m_storage.quad.buffer.get()) * sizeof(QuadVertex)};
 
-        const auto vertex_buffer {m_storage.wquad_vertex_buffer.lock()};
+        const auto stream_buffer {m_storage.wquad_stream_buffer.lock()};
 
-        vertex_buffer->bind();
-        vertex_buffer->upload_sub_data(m_storage.quad.buffer.get(), 0, size);
+        stream_buffer->bind();
+        const std::size_t offset {stream_buffer->write(m_storage.quad.buffer.get(), size, sizeof(QuadVertex))};
+        GlStreamBuffer::unbind();
+
+        m_storage.quad.base_vertex = static_cast<int>(offset / sizeof(QuadVertex));
+        m_statistics.streamed_bytes += size;
     }
 
     void Renderer::flush_images_batch() {
@@ -764,43 +1275,43 @@ namespace sm::internal {
             opengl::bind_texture_2d(m_storage.quad.textures[i], static_cast<int>(i));
         }
 
-        opengl::draw_elements(static_cast<int>(m_storage.quad.quad_count * 6));
+        opengl::draw_elements(static_cast<int>(m_storage.quad.quad_count * 6), m_storage.quad.base_vertex);
+        m_statistics.draw_calls++;
     }
 
-    void Renderer::setup_point_light_uniform_buffer(const Scene& scene, const std::shared_ptr<GlUniformBuffer> uniform_buffer) {
-        // Sort front to back with respect to the camera; lights in the front of the list will be used
-        // auto point_lights {scene.m_point_lights};
-
-        std::vector<std::pair<const PointLightNode*, Context3D>> point_light_nodes;
+    void Renderer::setup_point_light_fields(const GlUniformBuffer& uniform_buffer) {
+        // Only done once, so building the names here is fine
+        m_storage.point_light_fields.resize(SHADER_MAX_POINT_LIGHTS);
 
-        scene.root_node_3d->traverse([&point_light_nodes](const SceneNode3D* node, Context3D& context) {
-            auto point_light_node {dynamic_cast<const PointLightNode*>(node)};
+        for (std::size_t i {0}; i < SHADER_MAX_POINT_LIGHTS; i++) {
+            const std::string index {std::to_string(i)};
 
-            if (point_light_node == nullptr) {
-                return false;
-            }
+            PointLightFields& fields {m_storage.point_light_fields[i]};
+            fields.position = uniform_buffer.get_field_offset(Id("u_point_lights[" + index + "].position"));
+            fields.ambient = uniform_buffer.get_field_offset(Id("u_point_lights[" + index + "].ambient"));
+            fields.diffuse = uniform_buffer.get_field_offset(Id("u_point_lights[" + index + "].diffuse"));
+            fields.specular = uniform_buffer.get_field_offset(Id("u_point_lights[" + index + "].specular"));
+            fields.falloff_linear = uniform_buffer.get_field_offset(Id("u_point_lights[" + index + "].falloff_linear"));
+            fields.falloff_quadratic = uniform_buffer.get_field_offset(Id("u_point_lights[" + index + "].falloff_quadratic"));
+        }
+    }
 
-            if (context.outline) {
-                point_light_nodes.emplace_back(point_light_node, context);
-            }
+    void Renderer::setup_point_light_uniform_buffer(const Scene& scene, const std::shared_ptr<GlUniformBuffer> uniform_buffer) {
+        auto& point_lights {m_storage.scene.point_lights};
 
-            return false;
-        });
+        for (PointLightItem& item : point_lights) {
+            item.distance = glm::distance(item.position, scene.root_node_3d->m_camera_position);
+        }
 
-        std::sort(
-            point_light_nodes.begin(),
-            point_light_nodes.end(),
-            [&](const auto& lhs, const auto& rhs) {
-                const float distance_left {glm::distance(
-                    glm::vec3(lhs.second.transform * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)),
-                    scene.root_node_3d->m_camera_position
-                )};
-                const float distance_right {glm::distance(
-                    glm::vec3(rhs.second.transform * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)),
-                    scene.root_node_3d->m_camera_position
-                )};
-
-                return distance_left < distance_right;
+        // Sort front to back with respect to the camera; lights in the front of the list will be used
+        const auto used_point_lights {std::min(point_lights.size(), SHADER_MAX_POINT_LIGHTS)};
+
+        std::partial_sort(
+            point_lights.begin(),
+            point_lights.begin() + static_cast<std::ptrdiff_t>(used_point_lights),
+            point_lights.end(),
+            [](const PointLightItem& lhs, const PointLightItem& rhs) {
+                return lhs.distance < rhs.distance;
             }
         );
 
@@ -809,44 +1320,24 @@ namespace sm::internal {
             glm::vec3 position {};
             PointLight point_light;
 
-            if (i + 1 <= point_light_nodes.size()) {
-                position = point_light_nodes[i].second.transform * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
-                point_light = *point_light_nodes[i].first;
+            if (i < used_point_lights) {
+                position = point_lights[i].position;
+                point_light = *point_lights[i].point_light_node;
             }
 
-            const std::string index {std::to_string(i)};
+            const PointLightFields& fields {m_storage.point_light_fields[i]};
 
-            // Uniforms must be set individually by index
-            uniform_buffer->set(&position, Id("u_point_lights[" + index + "].position"));
-            uniform_buffer->set(&point_light.ambient_color, Id("u_point_lights[" + index + "].ambient"));
-            uniform_buffer->set(&point_light.diffuse_color, Id("u_point_lights[" + index + "].diffuse"));
-            uniform_buffer->set(&point_light.specular_color, Id("u_point_lights[" + index + "].specular"));
-            uniform_buffer->set(&point_light.falloff_linear, Id("u_point_lights[" + index + "].falloff_linear"));
-            uniform_buffer->set(&point_light.falloff_quadratic, Id("u_point_lights[" + index + "].falloff_quadratic"));
+            uniform_buffer->set(&position, fields.position, sizeof(position));
+            uniform_buffer->set(&point_light.ambient_color, fields.ambient, sizeof(point_light.ambient_color));
+            uniform_buffer->set(&point_light.diffuse_color, fields.diffuse, sizeof(point_light.diffuse_color));
+            uniform_buffer->set(&point_light.specular_color, fields.specular, sizeof(point_light.specular_color));
+            uniform_buffer->set(&point_light.falloff_linear, fields.falloff_linear, sizeof(point_light.falloff_linear));
+            uniform_buffer->set(&point_light.falloff_quadratic, fields.falloff_quadratic, sizeof(point_light.falloff_quadratic));
         }
     }
 
     void Renderer::setup_light_space_uniform_buffer(const Scene& scene, std::shared_ptr<GlUniformBuffer> uniform_buffer) {
-        const glm::mat4 projection {
-            glm::ortho(
-                scene.root_node_3d->shadow_box.left,
-                scene.root_node_3d->shadow_box.right,
-                scene.root_node_3d->shadow_box.bottom,
-                scene.root_node_3d->shadow_box.top,
-                scene.root_node_3d->shadow_box.near_,
-                scene.root_node_3d->shadow_box.far_
-            )
-        };
-
-        const glm::mat4 view {
-            glm::lookAt(
-                scene.root_node_3d->shadow_box.position,
-                scene.root_node_3d->directional_light.direction,
-                glm::vec3(0.0f, 1.0f, 0.0f)
-            )
-        };
-
-        const glm::mat4 light_space_matrix {projection * view};
+        const glm::mat4 light_space_matrix {calculate_light_space_matrix(scene)};
 
         uniform_buffer->set(&light_space_matrix, "u_light_space_matrix"_H);
     }
@@ -881,14 +1372,20 @@ namespace sm::internal {
         register_framebuffer(m_storage.shadow_map_framebuffer);
     }
 
-    void Renderer::setup_default_font(const FileSystem& fs, int scale) {
+    void Renderer::setup_default_font(const FileSystem& fs, const FontAtlasCache& atl) {
+        // Doesn't depend on the renderer parameters
+        if (m_storage.default_font != nullptr) {
+            return;
+        }
+
         FontSpecification specification;
-        specification.size_height *= static_cast<float>(scale);
-        specification.bitmap_size *= scale;
+        specification.bitmap_size = 512;  // Glyphs are generated larger and padded
+        specification.distance_field = true;
 
         m_storage.default_font = std::make_unique<Font>(
             utils::read_file(fs.path_engine_assets("fonts/CodeNewRoman/code-new-roman.regular.ttf")),
-            specification
+            specification,
+            &atl
         );
 
         m_storage.default_font->begin_baking();
@@ -915,16 +1412,17 @@ namespace sm::internal {
     }
 
 #ifndef SM_BUILD_DISTRIBUTION
-    void Renderer::debug_initialize(const FileSystem& fs) {
+    void Renderer::debug_initialize(const FileSystem& fs, const ProgramCache& prg) {
         m_debug_storage.shader = std::make_shared<GlShader>(
             utils::read_file(fs.path_engine_assets("shaders/internal/debug.vert")),
-            utils::read_file(fs.path_engine_assets("shaders/internal/debug.frag"))
+            utils::read_file(fs.path_engine_assets("shaders/internal/debug.frag")),
+            &prg
         );
 
         register_shader(m_debug_storage.shader);
 
-        const auto vertex_buffer {std::make_shared<GlVertexBuffer>(DrawHint::Stream)};
-        m_debug_storage.wvertex_buffer = vertex_buffer;
+        const auto stream_buffer {std::make_shared<GlStreamBuffer>(MAX_DEBUG_LINES * 2 * sizeof(BufferVertex))};
+        m_debug_storage.wstream_buffer = stream_buffer;
 
         m_debug_storage.vertex_array = std::make_unique<GlVertexArray>();
         m_debug_storage.vertex_array->configure([&](GlVertexArray* va) {
@@ -932,11 +1430,13 @@ namespace sm::internal {
             layout.add(0, VertexBufferLayout::Float, 3);
             layout.add(1, VertexBufferLayout::Float, 3);
 
-            va->add_vertex_buffer(vertex_buffer, layout);
+            va->add_vertex_buffer(stream_buffer, layout);
         });
     }
 
     void Renderer::debug_render(const Scene& scene) {
+        SM_PROFILE_GPU_SCOPE("Debug pass");
+
         for (const DebugLine& line : scene.root_node_3d->m_debug_lines) {
             BufferVertex v1;
             v1.position = line.position1;
@@ -955,18 +1455,24 @@ namespace sm::internal {
             return;
         }
 
-        const auto vertex_buffer {m_debug_storage.wvertex_buffer.lock()};
+        // The stream buffer has a fixed size; any lines over the limit are not drawn
+        const std::size_t vertex_count {std::min(m_debug_storage.lines_buffer.size(), MAX_DEBUG_LINES * 2)};
+        const std::size_t size {vertex_count * sizeof(BufferVertex)};
+
+        const auto stream_buffer {m_debug_storage.wstream_buffer.lock()};
 
-        vertex_buffer->bind();
-        vertex_buffer->upload_data(m_debug_storage.lines_buffer.data(), m_debug_storage.lines_buffer.size() * sizeof(BufferVertex));
-        GlVertexBuffer::unbind();
+        stream_buffer->bind();
+        const std::size_t offset {stream_buffer->write(m_debug_storage.lines_buffer.data(), size, sizeof(BufferVertex))};
+        GlStreamBuffer::unbind();
 
+        m_statistics.streamed_bytes += size;
         m_debug_storage.lines_buffer.clear();
 
         m_debug_storage.shader->bind();
         m_debug_storage.vertex_array->bind();
 
-        opengl::draw_arrays_lines(static_cast<int>(scene.root_node_3d->m_debug_lines.size()) * 2);
+        opengl::draw_arrays_lines(static_cast<int>(vertex_count), static_cast<int>(offset / sizeof(BufferVertex)));
+        m_statistics.draw_calls++;
 
         GlVertexArray::unbind();
     }
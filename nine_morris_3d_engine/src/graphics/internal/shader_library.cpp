@@ -1,60 +1,99 @@
 #include "nine_morris_3d_engine/graphics/internal/shader_library.hpp"
 
-#include <regex>
-#include <iterator>
-#include <vector>
-#include <sstream>
-
 #include "nine_morris_3d_engine/application/internal/error.hpp"
-#include "nine_morris_3d_engine/application/platform.hpp"
 #include "nine_morris_3d_engine/application/logging.hpp"
 #include "nine_morris_3d_engine/other/utilities.hpp"
 
 namespace sm::internal {
-    ShaderLibrary::ShaderLibrary(std::initializer_list<std::filesystem::path> include_directories) {
-        load_shaders_from_include_directories(include_directories);
+    static bool is_blank(char character) {
+        return character == ' ' || character == '\t' || character == '\r';
     }
 
-    std::string ShaderLibrary::load_shader(const std::string& source) const {
-#if defined(SM_PLATFORM_LINUX)
-        return match_and_include(std::string(source), 0);
-#elif defined(SM_PLATFORM_WINDOWS)
-        std::string result;
+    static std::string_view trim_left(std::string_view string) {
+        std::size_t i {0};
 
-        std::stringstream stream {source};
-        std::string line;
-        std::size_t count {0};
+        while (i < string.size() && is_blank(string[i])) {
+            i++;
+        }
 
-        while (std::getline(stream, line)) {
-            if (line.back() == '\r') {  // Stupid Windows :P
-                line.pop_back();
-            }
+        return string.substr(i);
+    }
 
-            result += match_and_include(std::move(line), ++count) + '\n';
+    // Return the rest of the line, if it's the specified directive
+    static bool match_directive(std::string_view line, std::string_view directive, std::string_view& rest) {
+        line = trim_left(line);
+
+        if (line.empty() || line.front() != '#') {
+            return false;
         }
 
-        return result;
-#endif
-    }
+        line = trim_left(line.substr(1));
 
-    std::string ShaderLibrary::load_shader(const std::string& source, std::initializer_list<Definition> defines) const {
-        std::string result {source};
+        if (line.substr(0, directive.size()) != directive) {
+            return false;
+        }
+
+        rest = line.substr(directive.size());
 
-        for (const auto& define : defines) {
-            std::size_t index {};
+        return rest.empty() || is_blank(rest.front()) || rest.front() == '"';
+    }
 
-            while (true) {
-                const auto position {result.find(define.first, index)};
+    // Comments and empty lines may come before the version directive
+    // Block comments may span multiple lines, so whether the next line starts inside one is tracked
+    static bool is_insignificant(std::string_view line, bool& in_block_comment) {
+        while (true) {
+            if (in_block_comment) {
+                const std::size_t end {line.find("*/")};
 
-                if (position == std::string::npos) {
-                    break;
+                if (end == std::string_view::npos) {
+                    return true;
                 }
 
-                result.replace(position, define.first.size(), define.second);
+                line = line.substr(end + 2);
+                in_block_comment = false;
+            }
+
+            line = trim_left(line);
+
+            if (line.empty() || line.substr(0, 2) == "//") {
+                return true;
+            }
 
-                index = position + define.second.size();
+            if (line.substr(0, 2) != "/*") {
+                return false;
             }
+
+            line = line.substr(2);
+            in_block_comment = true;
         }
+    }
+
+    static void append_line_directive(std::string& result, std::size_t line) {
+        result += "#line ";
+        result += std::to_string(line);
+        result += '\n';
+    }
+
+    static void append_defines(std::string& result, std::initializer_list<ShaderLibrary::Definition> defines) {
+        for (const auto& [name, value] : defines) {
+            result += "#define ";
+            result += name;
+            result += ' ';
+            result += value;
+            result += '\n';
+        }
+    }
+
+    ShaderLibrary::ShaderLibrary(std::initializer_list<std::filesystem::path> include_directories) {
+        load_shaders_from_include_directories(include_directories);
+    }
+
+    std::string ShaderLibrary::load_shader(const std::string& source, std::initializer_list<Definition> defines) const {
+        std::string result;
+        result.reserve(source.size() * 2);
+
+        std::unordered_set<std::string_view> included;
+        preprocess(source, defines, included, result);
 
         return result;
     }
@@ -79,78 +118,81 @@ namespace sm::internal {
         }
     }
 
-    std::string ShaderLibrary::match_and_include(std::string&& string, [[maybe_unused]] std::size_t count) const {
-        const std::regex pattern (
-            R"(^[ \t]*#include[ \t]*"[\w\-\/\.]+"[ \t]*$)",
-#if defined(SM_PLATFORM_LINUX)
-            std::regex::ECMAScript | std::regex::multiline
-#elif defined(SM_PLATFORM_WINDOWS)
-            std::regex::ECMAScript  // Stupid Windows :P
-#endif
-        );
-
-        std::smatch results;
-
-        std::sregex_iterator begin_regex {string.cbegin(), string.cend(), pattern};
-        std::sregex_iterator end_regex;
-
-        std::vector<std::tuple<std::string::const_iterator, std::string::const_iterator, std::size_t, std::string>> matches;
-
-        for (auto iter {begin_regex}; iter != end_regex; iter++) {
-            const auto& match {*iter};
-            const auto& sub_match {*match.cbegin()};
+    void ShaderLibrary::preprocess(
+        std::string_view source,
+        std::initializer_list<Definition> defines,
+        std::unordered_set<std::string_view>& included,
+        std::string& result
+    ) const {
+        bool defines_pending {defines.size() > 0};
+        bool in_block_comment {false};
+        std::size_t line_number {0};
+        std::size_t position {0};
+
+        while (position < source.size()) {
+            std::size_t end {source.find('\n', position)};
+
+            if (end == std::string_view::npos) {
+                end = source.size();
+            }
 
-            const auto argument {get_include_argument(match.str())};
-            const auto iter_arg {m_include_shader_sources.find(utils::file_name(argument))};
+            std::string_view line {source.substr(position, end - position)};
+            position = end + 1;
+            line_number++;
 
-            if (iter_arg == m_include_shader_sources.cend()) {
-                SM_THROW_ERROR(ResourceError, "Cannot include `{}`; file not found", argument);
+            if (!line.empty() && line.back() == '\r') {  // Stupid Windows :P
+                line.remove_suffix(1);
             }
 
-#if defined(SM_PLATFORM_LINUX)
-            const std::size_t line {get_line(string.cbegin(), sub_match.first)};
-#elif defined(SM_PLATFORM_WINDOWS)
-            const std::size_t line {count};
-#endif
+            std::string_view rest;
 
-            matches.push_back(std::make_tuple(sub_match.first, sub_match.second, line, iter_arg->second));
-        }
+            if (defines_pending && !is_insignificant(line, in_block_comment)) {
+                defines_pending = false;
 
-        if (matches.empty()) {
-            return string;
-        }
+                if (match_directive(line, "version", rest)) {
+                    result += line;
+                    result += '\n';
+                    append_defines(result, defines);
+                    append_line_directive(result, line_number + 1);
 
-        std::string result;
-        std::string::const_iterator begin {string.cbegin()};
+                    continue;
+                }
+
+                append_defines(result, defines);
+                append_line_directive(result, line_number);
+            }
 
-        for (auto iter {matches.begin()}; iter != matches.end(); iter++) {
-            std::string::const_iterator end;
+            if (!match_directive(line, "include", rest)) {
+                result += line;
+                result += '\n';
 
-            if (std::next(iter) != matches.end()) {
-                end = std::get<0>(*std::next(iter));
-            } else {
-                end = string.cend();
+                continue;
             }
 
-            result += std::string(begin, std::get<0>(*iter));
-            result += "#line 1\n" + load_shader(std::get<3>(*iter)) + "\n#line " + std::to_string(std::get<2>(*iter) + 1);
+            rest = trim_left(rest);
+            const std::size_t last_quote {rest.find('"', 1)};
 
-            begin = std::get<1>(*iter);
-        }
+            if (rest.empty() || rest.front() != '"' || last_quote == std::string_view::npos) {
+                SM_THROW_ERROR(ResourceError, "Invalid include directive on line {}", line_number);
+            }
 
-        result += std::string(std::get<1>(*std::prev(matches.cend())), string.cend());
+            const std::string argument {rest.substr(1, last_quote - 1)};
+            const auto iter {m_include_shader_sources.find(utils::file_name(argument))};
 
-        return result;
-    }
+            if (iter == m_include_shader_sources.cend()) {
+                SM_THROW_ERROR(ResourceError, "Cannot include `{}`; file not found", argument);
+            }
 
-    std::string ShaderLibrary::get_include_argument(const std::string& string) {
-        const auto first_quote {string.find_first_of("\"")};
-        const auto last_quote {string.find_last_of("\"")};
+            // Already included, or including itself
+            if (!included.insert(iter->first).second) {
+                result += '\n';
 
-        return string.substr(first_quote + 1, last_quote - first_quote - 1);
-    }
+                continue;
+            }
 
-    std::size_t ShaderLibrary::get_line(std::string::const_iterator begin, std::string::const_iterator end) {
-        return std::count(begin, end, '\n') + 1;
+            append_line_directive(result, 1);
+            preprocess(iter->second, {}, included, result);
+            append_line_directive(result, line_number + 1);
+        }
     }
 }
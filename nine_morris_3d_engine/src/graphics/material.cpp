@@ -1,13 +1,18 @@
 #include "nine_morris_3d_engine/graphics/material.hpp"
 
 #include <cstring>
+#include <atomic>
+
+#include <glm/gtc/type_ptr.hpp>
 
 #include "nine_morris_3d_engine/application/logging.hpp"
 #include "nine_morris_3d_engine/graphics/internal/opengl.hpp"
 
 namespace sm {
+    static std::atomic<std::uint64_t> g_material_id {0};
+
     Material::Material(std::shared_ptr<GlShader> shader)
-        : m_shader(shader) {
+        : m_shader(shader), m_id(++g_material_id) {
         LOG_DEBUG("Created material from shader {}", shader->get_id());
     }
 
@@ -38,72 +43,37 @@ namespace sm {
         m_textures.insert(name);
     }
 
-    MaterialInstance::MaterialInstance(std::shared_ptr<Material> material) {
-        m_shader = material->m_shader;
-
+    MaterialInstance::MaterialInstance(std::shared_ptr<Material> material)
+        : m_shader(material->m_shader), m_material(material) {
         std::size_t offset {};
 
+        // All instances of a material iterate the same sets, so they get the same layout
         for (const auto& name : material->m_uniforms_mat4) {
-            Element element;
-            element.type = Element::Type::Mat4;
-            element.offset = offset;
-
-            m_offsets[name] = element;
-            offset += sizeof(glm::mat4);
+            add_element(name, Element::Type::Mat4, offset);
         }
 
         for (const auto& name : material->m_uniforms_int) {
-            Element element;
-            element.type = Element::Type::Int;
-            element.offset = offset;
-
-            m_offsets[name] = element;
-            offset += sizeof(int);
+            add_element(name, Element::Type::Int, offset);
         }
 
         for (const auto& name : material->m_uniforms_float) {
-            Element element;
-            element.type = Element::Type::Float;
-            element.offset = offset;
-
-            m_offsets[name] = element;
-            offset += sizeof(float);
+            add_element(name, Element::Type::Float, offset);
         }
 
         for (const auto& name : material->m_uniforms_vec2) {
-            Element element;
-            element.type = Element::Type::Vec2;
-            element.offset = offset;
-
-            m_offsets[name] = element;
-            offset += sizeof(glm::vec2);
+            add_element(name, Element::Type::Vec2, offset);
         }
 
         for (const auto& name : material->m_uniforms_vec3) {
-            Element element;
-            element.type = Element::Type::Vec3;
-            element.offset = offset;
-
-            m_offsets[name] = element;
-            offset += sizeof(glm::vec3);
+            add_element(name, Element::Type::Vec3, offset);
         }
 
         for (const auto& name : material->m_uniforms_vec4) {
-            Element element;
-            element.type = Element::Type::Vec4;
-            element.offset = offset;
-
-            m_offsets[name] = element;
-            offset += sizeof(glm::vec4);
+            add_element(name, Element::Type::Vec4, offset);
         }
 
         for (const auto& name : material->m_textures) {
-            Element element;
-            element.type = Element::Type::Texture;
-            element.offset = offset;
-
-            m_offsets[name] = element;
-            offset += sizeof(Texture);
+            add_element(name, Element::Type::Texture, offset);
         }
 
         m_size = offset;
@@ -114,98 +84,191 @@ namespace sm {
 
     void MaterialInstance::bind_and_upload() const {
         m_shader->bind();
+        upload();
+    }
 
-        for (const auto& [name, element] : m_offsets) {
-            switch (element.type) {
-                case Element::Type::Mat4: {
-                    glm::mat4 matrix {};
-                    std::memcpy(&matrix, m_data.get() + element.offset, sizeof(matrix));
-
-                    m_shader->upload_uniform_mat4(name, matrix);
+    void MaterialInstance::upload() const {
+        auto& uploaded {m_shader->m_material_uniforms};
 
-                    break;
+        // The program already has exactly these values
+        if (uploaded.layout == m_material->m_id && uploaded.material_instance == this && !m_dirty) {
+            for (const Binding& binding : m_bindings) {
+                if (binding.type == Element::Type::Texture) {
+                    bind_texture(binding);  // Texture units are shared with everything else; skipped, if already bound
                 }
-                case Element::Type::Int: {
-                    int integer {};
-                    std::memcpy(&integer, m_data.get() + element.offset, sizeof(integer));
+            }
+
+            return;
+        }
 
-                    m_shader->upload_uniform_int(name, integer);
+        if (uploaded.layout != m_material->m_id) {
+            // Nothing is known about the values in the program
+            uploaded.data = std::make_unique<unsigned char[]>(m_size);
 
-                    break;
+            for (const Binding& binding : m_bindings) {
+                upload_binding(binding);
+            }
+        } else {
+            for (const Binding& binding : m_bindings) {
+                const std::size_t size {element_size(binding.type)};
+
+                if (std::memcmp(uploaded.data.get() + binding.offset, m_data.get() + binding.offset, size) != 0) {
+                    upload_binding(binding);
+                } else if (binding.type == Element::Type::Texture) {
+                    bind_texture(binding);
                 }
-                case Element::Type::Float: {
-                    float real {};
-                    std::memcpy(&real, m_data.get() + element.offset, sizeof(real));
+            }
+        }
 
-                    m_shader->upload_uniform_float(name, real);
+        std::memcpy(uploaded.data.get(), m_data.get(), m_size);
+        uploaded.layout = m_material->m_id;
+        uploaded.material_instance = this;
+        m_dirty = false;
+    }
 
-                    break;
-                }
-                case Element::Type::Vec2: {
-                    glm::vec2 vector {};
-                    std::memcpy(&vector, m_data.get() + element.offset, sizeof(vector));
+    void MaterialInstance::add_element(Id name, Element::Type type, std::size_t& offset) {
+        Element element;
+        element.type = type;
+        element.offset = offset;
 
-                    m_shader->upload_uniform_vec2(name, vector);
+        m_offsets[name] = element;
 
-                    break;
-                }
-                case Element::Type::Vec3: {
-                    glm::vec3 vector {};
-                    std::memcpy(&vector, m_data.get() + element.offset, sizeof(vector));
+        Binding binding;
+        binding.location = m_shader->get_uniform_location(name);
+        binding.type = type;
+        binding.offset = offset;
 
-                    m_shader->upload_uniform_vec3(name, vector);
+        m_bindings.push_back(binding);
 
-                    break;
-                }
-                case Element::Type::Vec4: {
-                    glm::vec4 vector {};
-                    std::memcpy(&vector, m_data.get() + element.offset, sizeof(vector));
+        offset += element_size(type);
+    }
 
-                    m_shader->upload_uniform_vec4(name, vector);
+    void MaterialInstance::upload_binding(const Binding& binding) const {
+        const unsigned char* data {m_data.get() + binding.offset};
 
-                    break;
-                }
-                case Element::Type::Texture: {
-                    Texture texture;
-                    std::memcpy(&texture, m_data.get() + element.offset, sizeof(texture));
+        switch (binding.type) {
+            case Element::Type::Mat4: {
+                glm::mat4 matrix {};
+                std::memcpy(&matrix, data, sizeof(matrix));
 
-                    m_shader->upload_uniform_int(name, texture.unit);
-                    internal::opengl::bind_texture_2d(texture.texture, texture.unit);
+                internal::opengl::uniform_mat4(binding.location, glm::value_ptr(matrix));
 
-                    break;
-                }
+                break;
+            }
+            case Element::Type::Int: {
+                int integer {};
+                std::memcpy(&integer, data, sizeof(integer));
+
+                internal::opengl::uniform_int(binding.location, integer);
+
+                break;
+            }
+            case Element::Type::Float: {
+                float real {};
+                std::memcpy(&real, data, sizeof(real));
+
+                internal::opengl::uniform_float(binding.location, real);
+
+                break;
             }
+            case Element::Type::Vec2: {
+                glm::vec2 vector {};
+                std::memcpy(&vector, data, sizeof(vector));
+
+                internal::opengl::uniform_vec2(binding.location, glm::value_ptr(vector));
+
+                break;
+            }
+            case Element::Type::Vec3: {
+                glm::vec3 vector {};
+                std::memcpy(&vector, data, sizeof(vector));
+
+                internal::opengl::uniform_vec3(binding.location, glm::value_ptr(vector));
+
+                break;
+            }
+            case Element::Type::Vec4: {
+                glm::vec4 vector {};
+                std::memcpy(&vector, data, sizeof(vector));
+
+                internal::opengl::uniform_vec4(binding.location, glm::value_ptr(vector));
+
+                break;
+            }
+            case Element::Type::Texture: {
+                Texture texture;
+                std::memcpy(&texture, data, sizeof(texture));
+
+                internal::opengl::uniform_int(binding.location, texture.unit);
+                internal::opengl::bind_texture_2d(texture.texture, texture.unit);
+
+                break;
+            }
+        }
+    }
+
+    void MaterialInstance::bind_texture(const Binding& binding) const {
+        Texture texture;
+        std::memcpy(&texture, m_data.get() + binding.offset, sizeof(texture));
+
+        internal::opengl::bind_texture_2d(texture.texture, texture.unit);
+    }
+
+    std::size_t MaterialInstance::element_size(Element::Type type) {
+        switch (type) {
+            case Element::Type::Mat4:
+                return sizeof(glm::mat4);
+            case Element::Type::Int:
+                return sizeof(int);
+            case Element::Type::Float:
+                return sizeof(float);
+            case Element::Type::Vec2:
+                return sizeof(glm::vec2);
+            case Element::Type::Vec3:
+                return sizeof(glm::vec3);
+            case Element::Type::Vec4:
+                return sizeof(glm::vec4);
+            case Element::Type::Texture:
+                return sizeof(Texture);
         }
+
+        return 0;
     }
 
     void MaterialInstance::set_mat4(Id name, const glm::mat4& matrix) {
         const Element& element {m_offsets.at(name)};
         std::memcpy(m_data.get() + element.offset, &matrix, sizeof(matrix));
+        m_dirty = true;
     }
 
     void MaterialInstance::set_int(Id name, int integer) {
         const Element& element {m_offsets.at(name)};
         std::memcpy(m_data.get() + element.offset, &integer, sizeof(integer));
+        m_dirty = true;
     }
 
     void MaterialInstance::set_float(Id name, float real) {
         const Element& element {m_offsets.at(name)};
         std::memcpy(m_data.get() + element.offset, &real, sizeof(real));
+        m_dirty = true;
     }
 
     void MaterialInstance::set_vec2(Id name, glm::vec2 vector) {
         const Element& element {m_offsets.at(name)};
         std::memcpy(m_data.get() + element.offset, &vector, sizeof(vector));
+        m_dirty = true;
     }
 
     void MaterialInstance::set_vec3(Id name, glm::vec3 vector) {
         const Element& element {m_offsets.at(name)};
         std::memcpy(m_data.get() + element.offset, &vector, sizeof(vector));
+        m_dirty = true;
     }
 
     void MaterialInstance::set_vec4(Id name, glm::vec4 vector) {
         const Element& element {m_offsets.at(name)};
         std::memcpy(m_data.get() + element.offset, &vector, sizeof(vector));
+        m_dirty = true;
     }
 
     void MaterialInstance::set_texture(Id name, std::shared_ptr<GlTexture> texture, int unit) {
@@ -219,6 +282,7 @@ namespace sm {
 
         const Element& element {m_offsets.at(name)};
         std::memcpy(m_data.get() + element.offset, &result_texture, sizeof(result_texture));
+        m_dirty = true;
     }
 
     const GlShader* MaterialInstance::get_shader() const {
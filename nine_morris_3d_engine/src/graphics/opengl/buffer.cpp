@@ -37,7 +37,7 @@ namespace sm {
     }
 
     GlVertexBuffer::GlVertexBuffer(std::size_t size, DrawHint hint)
-        : m_hint(hint) {
+        : m_hint(hint), m_size(size) {
         glGenBuffers(1, &m_buffer);
         glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
         glBufferData(GL_ARRAY_BUFFER, size, nullptr, draw_hint_to_int(hint));
@@ -48,7 +48,7 @@ namespace sm {
     }
 
     GlVertexBuffer::GlVertexBuffer(const void* data, std::size_t size, DrawHint hint)
-        : m_hint(hint) {
+        : m_hint(hint), m_size(size) {
         glGenBuffers(1, &m_buffer);
         glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
         glBufferData(GL_ARRAY_BUFFER, size, data, draw_hint_to_int(hint));
@@ -72,14 +72,162 @@ namespace sm {
         glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
-    void GlVertexBuffer::upload_data(const void* data, std::size_t size) const {
+    void GlVertexBuffer::upload_data(const void* data, std::size_t size) {
         glBufferData(GL_ARRAY_BUFFER, size, data, draw_hint_to_int(m_hint));
+
+        m_size = size;
     }
 
     void GlVertexBuffer::upload_sub_data(const void* data, std::size_t offset, std::size_t size) const {
         glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
     }
 
+    std::size_t GlVertexBuffer::get_size() const {
+        return m_size;
+    }
+
+    GlStreamBuffer::GlStreamBuffer(std::size_t region_size)
+        : m_region_size(region_size) {
+        glGenBuffers(1, &m_buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+
+        const std::size_t size {m_region_size * REGIONS};
+
+        if (GLAD_GL_ARB_buffer_storage) {
+            const GLbitfield flags {GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT};
+
+            glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+            m_mapped = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+
+            if (m_mapped == nullptr) {
+                LOG_ERROR("Could not persistently map GL stream buffer {}", m_buffer);
+            }
+        }
+
+        if (m_mapped == nullptr) {
+            // Storage may already be immutable, so start again with a fresh buffer
+            glDeleteBuffers(1, &m_buffer);
+            glGenBuffers(1, &m_buffer);
+            glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+            glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        LOG_DEBUG("Created GL stream buffer {} ({})", m_buffer, m_mapped != nullptr ? "persistent" : "orphaning");
+    }
+
+    GlStreamBuffer::~GlStreamBuffer() {
+        for (void* fence : m_fences) {
+            if (fence != nullptr) {
+                glDeleteSync(static_cast<GLsync>(fence));
+            }
+        }
+
+        if (m_mapped != nullptr) {
+            glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+
+        glDeleteBuffers(1, &m_buffer);
+
+        LOG_DEBUG("Deleted GL stream buffer {}", m_buffer);
+    }
+
+    void GlStreamBuffer::bind() const {
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    }
+
+    void GlStreamBuffer::unbind() {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    std::size_t GlStreamBuffer::write(const void* data, std::size_t size, std::size_t stride) {
+        assert(size <= m_region_size);
+        assert(stride > 0 && m_region_size % stride == 0);
+
+        // Offsets are turned into first vertices by the caller
+        std::size_t cursor {(m_cursor + stride - 1) / stride * stride};
+
+        if (m_mapped != nullptr) {
+            if (cursor + size > m_region_size) {
+                next_region();
+                cursor = 0;
+            }
+
+            const std::size_t offset {m_region * m_region_size + cursor};
+            std::memcpy(m_mapped + offset, data, size);
+            m_cursor = cursor + size;
+
+            return offset;
+        }
+
+        if (cursor + size > m_region_size * REGIONS) {
+            // Let the driver hand out new storage, while the GPU keeps reading the old one
+            glBufferData(GL_ARRAY_BUFFER, m_region_size * REGIONS, nullptr, GL_STREAM_DRAW);
+            cursor = 0;
+        }
+
+        void* pointer {glMapBufferRange(
+            GL_ARRAY_BUFFER,
+            cursor,
+            size,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT
+        )};
+
+        if (pointer != nullptr) {
+            std::memcpy(pointer, data, size);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        } else {
+            LOG_ERROR("Could not map GL stream buffer {}", m_buffer);
+        }
+
+        m_cursor = cursor + size;
+
+        return cursor;
+    }
+
+    void GlStreamBuffer::end_frame() {
+        if (m_mapped != nullptr && m_cursor > 0) {
+            next_region();
+        }
+    }
+
+    std::size_t GlStreamBuffer::get_region_size() const {
+        return m_region_size;
+    }
+
+    void GlStreamBuffer::next_region() {
+        m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        m_region = (m_region + 1) % REGIONS;
+        m_cursor = 0;
+
+        auto fence {static_cast<GLsync>(m_fences[m_region])};
+
+        if (fence == nullptr) {
+            return;
+        }
+
+        // Only blocks when the CPU is a whole ring ahead of the GPU
+        while (true) {
+            const GLenum result {glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000)};
+
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+                break;
+            }
+
+            if (result == GL_WAIT_FAILED) {
+                LOG_ERROR("Could not wait for GL stream buffer {}", m_buffer);
+                break;
+            }
+        }
+
+        glDeleteSync(fence);
+        m_fences[m_region] = nullptr;
+    }
+
     GlIndexBuffer::GlIndexBuffer(const void* data, std::size_t size) {
         glGenBuffers(1, &m_buffer);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_buffer);
@@ -233,6 +381,19 @@ namespace sm {
         glBufferSubData(GL_UNIFORM_BUFFER, offset, size, m_data);
     }
 
+    std::size_t GlUniformBuffer::get_field_offset(Id field) const {
+        assert(m_configured);
+
+        return m_fields.at(field).offset;
+    }
+
+    void GlUniformBuffer::set(const void* field_data, std::size_t offset, std::size_t size) {
+        assert(m_configured);
+        assert(offset + size <= m_size);
+
+        std::memcpy(m_data + offset, field_data, size);
+    }
+
     void GlUniformBuffer::allocate_memory(std::size_t size) {
         m_data = new unsigned char[size];
         m_size = size;
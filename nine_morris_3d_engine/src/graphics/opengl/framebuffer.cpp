@@ -6,6 +6,7 @@
 
 #include "nine_morris_3d_engine/application/internal/error.hpp"
 #include "nine_morris_3d_engine/application/logging.hpp"
+#include "nine_morris_3d_engine/graphics/internal/opengl.hpp"
 
 namespace sm {
     static const unsigned int COLOR_ATTACHMENTS[] {
@@ -227,6 +228,9 @@ namespace sm {
 
         glDeleteFramebuffers(1, &m_framebuffer);
 
+        // The attachment textures are deleted directly
+        internal::opengl::invalidate_texture_2d_bindings();
+
         LOG_DEBUG("Deleted GL framebuffer {}", m_framebuffer);
     }
 
@@ -297,6 +301,9 @@ namespace sm {
     }
 
     void GlFramebuffer::build() {
+        // The attachment textures are bound and deleted directly
+        internal::opengl::invalidate_texture_2d_bindings();
+
         // Delete old framebuffer first
         if (m_framebuffer != 0) {
             for (std::size_t i {0}; i < m_specification.color_attachments.size(); i++) {
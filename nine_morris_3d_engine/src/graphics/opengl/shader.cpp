@@ -11,9 +11,21 @@
 #include "nine_morris_3d_engine/application/internal/error.hpp"
 #include "nine_morris_3d_engine/application/platform.hpp"
 #include "nine_morris_3d_engine/application/logging.hpp"
+#include "nine_morris_3d_engine/graphics/internal/program_cache.hpp"
 
 namespace sm {
-    GlShader::GlShader(const std::string& source_vertex, const std::string& source_fragment) {
+    GlShader::GlShader(const std::string& source_vertex, const std::string& source_fragment, const internal::ProgramCache* cache) {
+        std::uint64_t key {};
+
+        if (cache != nullptr && cache->is_enabled()) {
+            key = cache->key({source_vertex, source_fragment});
+
+            if (load_program_binary(*cache, key)) {
+                LOG_DEBUG("Created GL shader {} from binary", m_program);
+                return;
+            }
+        }
+
         const unsigned int vertex_shader {compile_shader(source_vertex, GL_VERTEX_SHADER)};
         const unsigned int fragment_shader {compile_shader(source_fragment, GL_FRAGMENT_SHADER)};
         create_program(vertex_shader, fragment_shader);
@@ -26,10 +38,25 @@ namespace sm {
         const auto uniforms {introspect_program()};
         check_and_cache_uniforms(uniforms);
 
+        if (cache != nullptr && cache->is_enabled()) {
+            store_program_binary(*cache, key, uniforms);
+        }
+
         LOG_DEBUG("Created GL shader {}", m_program);
     }
 
-    GlShader::GlShader(const std::string& source_vertex, const std::string& source_geometry, const std::string& source_fragment) {
+    GlShader::GlShader(const std::string& source_vertex, const std::string& source_geometry, const std::string& source_fragment, const internal::ProgramCache* cache) {
+        std::uint64_t key {};
+
+        if (cache != nullptr && cache->is_enabled()) {
+            key = cache->key({source_vertex, source_geometry, source_fragment});
+
+            if (load_program_binary(*cache, key)) {
+                LOG_DEBUG("Created GL shader {} from binary", m_program);
+                return;
+            }
+        }
+
         const unsigned int vertex_shader {compile_shader(source_vertex, GL_VERTEX_SHADER)};
         const unsigned int geometry_shader {compile_shader(source_geometry, GL_GEOMETRY_SHADER)};
         const unsigned int fragment_shader {compile_shader(source_fragment, GL_FRAGMENT_SHADER)};
@@ -43,6 +70,10 @@ namespace sm {
         const auto uniforms {introspect_program()};
         check_and_cache_uniforms(uniforms);
 
+        if (cache != nullptr && cache->is_enabled()) {
+            store_program_binary(*cache, key, uniforms);
+        }
+
         LOG_DEBUG("Created GL shader {}", m_program);
     }
 
@@ -61,56 +92,67 @@ namespace sm {
     }
 
     void GlShader::upload_uniform_mat3(Id name, const glm::mat3& matrix) const {
+        m_material_uniforms.layout = 0;
         const int location {get_uniform_location(name)};
         glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
     }
 
     void GlShader::upload_uniform_mat3_array(Id name, const std::vector<glm::mat3>& matrices) const {
+        m_material_uniforms.layout = 0;
         const int location {get_uniform_location(name)};
         glUniformMatrix3fv(location, static_cast<int>(matrices.size()), GL_FALSE, glm::value_ptr(matrices.front()));
     }
 
     void GlShader::upload_uniform_mat4(Id name, const glm::mat4& matrix) const {
+        m_material_uniforms.layout = 0;
         const int location {get_uniform_location(name)};
         glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
     }
 
     void GlShader::upload_uniform_mat4_array(Id name, const std::vector<glm::mat4>& matrices) const {
+        m_material_uniforms.layout = 0;
         const int location {get_uniform_location(name)};
         glUniformMatrix4fv(location, static_cast<int>(matrices.size()), GL_FALSE, glm::value_ptr(matrices.front()));
     }
 
     void GlShader::upload_uniform_int(Id name, int value) const {
+        m_material_uniforms.layout = 0;
         const int location {get_uniform_location(name)};
         glUniform1i(location, value);
     }
 
     void GlShader::upload_uniform_int_array(Id name, const std::vector<int>& values) const {
+        m_material_uniforms.layout = 0;
         const int location {get_uniform_location(name)};
         glUniform1iv(location, static_cast<int>(values.size()), values.data());
     }
 
     void GlShader::upload_uniform_float(Id name, float value) const {
+        m_material_uniforms.layout = 0;
         const int location {get_uniform_location(name)};
         glUniform1f(location, value);
     }
 
     void GlShader::upload_uniform_vec2(Id name, glm::vec2 vector) const {
+        m_material_uniforms.layout = 0;
         const int location {get_uniform_location(name)};
         glUniform2f(location, vector.x, vector.y);
     }
 
     void GlShader::upload_uniform_vec3(Id name, glm::vec3 vector) const {
+        m_material_uniforms.layout = 0;
         const int location {get_uniform_location(name)};
         glUniform3f(location, vector.x, vector.y, vector.z);
     }
 
     void GlShader::upload_uniform_vec3_array(Id name, const std::vector<glm::vec3>& vectors) const {
+        m_material_uniforms.layout = 0;
         const int location {get_uniform_location(name)};
         glUniform3fv(location, static_cast<int>(vectors.size()), glm::value_ptr(vectors.front()));
     }
 
     void GlShader::upload_uniform_vec4(Id name, glm::vec4 vector) const {
+        m_material_uniforms.layout = 0;
         const int location {get_uniform_location(name)};
         glUniform4f(location, vector.x, vector.y, vector.z, vector.w);
     }
@@ -237,6 +279,53 @@ namespace sm {
         return uniforms;
     }
 
+    bool GlShader::load_program_binary(const internal::ProgramCache& cache, std::uint64_t key) {
+        const auto binary {cache.load(key)};
+
+        if (!binary) {
+            return false;
+        }
+
+        m_program = glCreateProgram();
+        glProgramBinary(m_program, binary->format, binary->data.data(), static_cast<int>(binary->data.size()));
+
+        // Drivers reject binaries after updates, or for any other reason
+        int link_status {};
+        glGetProgramiv(m_program, GL_LINK_STATUS, &link_status);
+
+        if (link_status == GL_FALSE) {
+            LOG_WARNING("Shader program binary was rejected by the driver, compiling from source");
+
+            glDeleteProgram(m_program);
+            m_program = 0;
+
+            return false;
+        }
+
+        m_uniform_blocks = binary->uniform_blocks;
+        check_and_cache_uniforms(binary->uniforms);
+
+        return true;
+    }
+
+    void GlShader::store_program_binary(const internal::ProgramCache& cache, std::uint64_t key, const std::vector<std::string>& uniforms) const {
+        int length {};
+        glGetProgramiv(m_program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+        if (length <= 0) {
+            return;
+        }
+
+        internal::ProgramBinary binary;
+        binary.data.resize(static_cast<std::size_t>(length));
+        binary.uniforms = uniforms;
+        binary.uniform_blocks = m_uniform_blocks;
+
+        glGetProgramBinary(m_program, length, nullptr, &binary.format, binary.data.data());
+
+        cache.store(key, binary);
+    }
+
     void GlShader::create_program(unsigned int vertex_shader, unsigned int fragment_shader) {
         assert(vertex_shader != 0);
         assert(fragment_shader != 0);
@@ -244,6 +333,7 @@ namespace sm {
         m_program = glCreateProgram();
         glAttachShader(m_program, vertex_shader);
         glAttachShader(m_program, fragment_shader);
+        glProgramParameteri(m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);  // For the cache
         glLinkProgram(m_program);
         glValidateProgram(m_program);
     }
@@ -257,6 +347,7 @@ namespace sm {
         glAttachShader(m_program, vertex_shader);
         glAttachShader(m_program, geometry_shader);
         glAttachShader(m_program, fragment_shader);
+        glProgramParameteri(m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);  // For the cache
         glLinkProgram(m_program);
         glValidateProgram(m_program);
     }
@@ -6,6 +6,7 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "nine_morris_3d_engine/application/logging.hpp"
+#include "nine_morris_3d_engine/graphics/internal/opengl.hpp"
 #include "nine_morris_3d_engine/graphics/opengl/capabilities.hpp"
 
 namespace sm {
@@ -101,6 +102,7 @@ namespace sm {
         configure_mipmapping(specification);
 
         glBindTexture(GL_TEXTURE_2D, 0);
+        internal::opengl::invalidate_texture_2d_bindings();  // It was bound to whatever unit was active
 
         m_width = data->get_width();
         m_height = data->get_height();
@@ -120,6 +122,7 @@ namespace sm {
         configure_mipmapping(specification);
 
         glBindTexture(GL_TEXTURE_2D, 0);
+        internal::opengl::invalidate_texture_2d_bindings();  // It was bound to whatever unit was active
 
         m_width = width;
         m_height = height;
@@ -129,6 +132,7 @@ namespace sm {
 
     GlTexture::~GlTexture() {
         glDeleteTextures(1, &m_texture);
+        internal::opengl::invalidate_texture_2d_bindings();  // Deleting it unbinds it from every unit
 
         LOG_DEBUG("Deleted GL texture {}", m_texture);
     }
@@ -146,12 +150,12 @@ namespace sm {
     }
 
     void GlTexture::bind(unsigned int unit) const {
-        glActiveTexture(GL_TEXTURE0 + unit);
-        glBindTexture(GL_TEXTURE_2D, m_texture);
+        internal::opengl::bind_texture_2d(m_texture, static_cast<int>(unit));
     }
 
     void GlTexture::unbind() {
         glBindTexture(GL_TEXTURE_2D, 0);
+        internal::opengl::invalidate_texture_2d_bindings();
     }
 
     void GlTexture::allocate_texture(int width, int height, const unsigned char* data) const {
@@ -233,6 +237,8 @@ namespace sm {
 
         glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
 
+        m_size = 6 * static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4;
+
         LOG_DEBUG("Created GL texture cubemap {}", m_texture);
     }
 
@@ -250,4 +256,8 @@ namespace sm {
     void GlTextureCubemap::unbind() {
         glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
     }
+
+    std::size_t GlTextureCubemap::get_size() const {
+        return m_size;
+    }
 }
@@ -1,5 +1,6 @@
 #include "nine_morris_3d_engine/graphics/opengl/vertex_array.hpp"
 
+#include <algorithm>
 #include <cassert>
 
 #include <glad/glad.h>
@@ -7,6 +8,44 @@
 #include "nine_morris_3d_engine/application/logging.hpp"
 
 namespace sm {
+    static void set_attributes(const VertexBufferLayout& layout) {
+        std::size_t offset {0};
+
+        for (std::size_t i {0}; i < layout.elements.size(); i++) {
+            const VertexBufferLayout::VertexElement& element {layout.elements[i]};
+
+            switch (element.type) {
+                case VertexBufferLayout::Float:
+                    glVertexAttribPointer(
+                        element.index,
+                        element.size,
+                        GL_FLOAT,
+                        GL_FALSE,
+                        layout.stride,
+                        reinterpret_cast<void*>(offset)
+                    );
+                    break;
+                case VertexBufferLayout::Int:
+                    glVertexAttribIPointer(
+                        element.index,
+                        element.size,
+                        GL_INT,
+                        layout.stride,
+                        reinterpret_cast<void*>(offset)
+                    );
+                    break;
+            }
+
+            glEnableVertexAttribArray(element.index);
+
+            if (element.per_instance) {
+                glVertexAttribDivisor(element.index, 1);
+            }
+
+            offset += element.size * VertexBufferLayout::VertexElement::get_size(element.type);
+        }
+    }
+
     GlVertexArray::GlVertexArray() {
         glGenVertexArrays(1, &m_array);
         glBindVertexArray(m_array);
@@ -47,46 +86,28 @@ namespace sm {
         assert(layout.elements.size() > 0);
 
         vertex_buffer->bind();
+        set_attributes(layout);
 
-        std::size_t offset {0};
-
-        for (std::size_t i {0}; i < layout.elements.size(); i++) {
-            const VertexBufferLayout::VertexElement& element {layout.elements[i]};
+        m_vertex_buffers.push_back(vertex_buffer);
 
-            switch (element.type) {
-                case VertexBufferLayout::Float:
-                    glVertexAttribPointer(
-                        element.index,
-                        element.size,
-                        GL_FLOAT,
-                        GL_FALSE,
-                        layout.stride,
-                        reinterpret_cast<void*>(offset)
-                    );
-                    break;
-                case VertexBufferLayout::Int:
-                    glVertexAttribIPointer(
-                        element.index,
-                        element.size,
-                        GL_INT,
-                        layout.stride,
-                        reinterpret_cast<void*>(offset)
-                    );
-                    break;
-            }
+        GlVertexBuffer::unbind();
+    }
 
-            glEnableVertexAttribArray(element.index);
+    void GlVertexArray::add_vertex_buffer(std::shared_ptr<GlStreamBuffer> stream_buffer, const VertexBufferLayout& layout) {
+        assert(layout.elements.size() > 0);
 
-            if (element.per_instance) {
-                glVertexAttribDivisor(element.index, 1);
-            }
+        stream_buffer->bind();
+        set_attributes(layout);
 
-            offset += element.size * VertexBufferLayout::VertexElement::get_size(element.type);
-        }
+        m_stream_buffers.push_back(stream_buffer);
 
-        m_vertex_buffers.push_back(vertex_buffer);
+        GlStreamBuffer::unbind();
+    }
 
-        GlVertexBuffer::unbind();
+    bool GlVertexArray::has_vertex_buffer(const GlStreamBuffer* stream_buffer) const {
+        return std::any_of(m_stream_buffers.cbegin(), m_stream_buffers.cend(), [=](const auto& buffer) {
+            return buffer.get() == stream_buffer;
+        });
     }
 
     void GlVertexArray::add_index_buffer(std::shared_ptr<GlIndexBuffer> index_buffer) {
@@ -105,4 +126,8 @@ namespace sm {
 
         return m_index_buffers[index];
     }
+
+    unsigned int GlVertexArray::get_id() const {
+        return m_array;
+    }
 }
@@ -2,15 +2,31 @@
 
 #include <limits>
 #include <array>
+#include <algorithm>
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/matrix_transform_2d.hpp>
 
 namespace sm {
+    static std::uint64_t next_transform_version() {
+        static std::uint64_t version {TRANSFORM_VERSION_ROOT};
+
+        return ++version;
+    }
+
     void SceneNode3D::add_node(std::shared_ptr<SceneNode3D> node) {
         m_children.push_back(node);
     }
 
+    void SceneNode3D::remove_node(const SceneNode3D* node) {
+        m_children.erase(
+            std::remove_if(m_children.begin(), m_children.end(), [node](const std::shared_ptr<SceneNode3D>& child) {
+                return child.get() == node;
+            }),
+            m_children.end()
+        );
+    }
+
     void SceneNode3D::clear_nodes() {
         for (const auto& child : m_children) {
             child->clear_nodes();
@@ -42,11 +58,7 @@ namespace sm {
     void SceneNode3D::traverse(const std::function<bool(const SceneNode3D*, Context3D&)>& process) const {
         traverse<Context3D>(Context3D(), [&](const SceneNode3D* node, Context3D& context) {
             if (auto outlined_model_node {dynamic_cast<const OutlinedModelNode*>(node)}; outlined_model_node != nullptr) {
-                context.transform = glm::translate(context.transform, outlined_model_node->position);
-                context.transform = glm::rotate(context.transform, glm::radians(outlined_model_node->rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-                context.transform = glm::rotate(context.transform, glm::radians(outlined_model_node->rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-                context.transform = glm::rotate(context.transform, glm::radians(outlined_model_node->rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-                context.transform = glm::scale(context.transform, glm::vec3(outlined_model_node->scale));
+                outlined_model_node->update_world_transform(context);
 
                 context.transform_scale *= outlined_model_node->scale;
 
@@ -83,11 +95,7 @@ namespace sm {
                         break;
                 }
             } else if (auto model_node {dynamic_cast<const ModelNode*>(node)}; model_node != nullptr) {
-                context.transform = glm::translate(context.transform, model_node->position);
-                context.transform = glm::rotate(context.transform, glm::radians(model_node->rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-                context.transform = glm::rotate(context.transform, glm::radians(model_node->rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-                context.transform = glm::rotate(context.transform, glm::radians(model_node->rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-                context.transform = glm::scale(context.transform, glm::vec3(model_node->scale));
+                model_node->update_world_transform(context);
 
                 context.transform_scale *= model_node->scale;
 
@@ -114,6 +122,7 @@ namespace sm {
                 }
             } else if (auto point_light_node {dynamic_cast<const PointLightNode*>(node)}; point_light_node != nullptr) {
                 context.transform = glm::translate(context.transform, point_light_node->position);
+                context.transform_version = TRANSFORM_VERSION_NONE;
             }
 
             return process(node, context);
@@ -135,10 +144,65 @@ namespace sm {
         return result;
     }
 
+    const glm::mat4& ModelNode::get_local_transform() const {
+        // The fields are public, so detect changes by comparing against the values last used
+        if (
+            m_transform.local_valid &&
+            m_transform.position == position &&
+            m_transform.rotation == rotation &&
+            m_transform.scale == scale
+        ) {
+            return m_transform.local;
+        }
+
+        glm::mat4 transform {1.0f};
+        transform = glm::translate(transform, position);
+        transform = glm::rotate(transform, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+        transform = glm::rotate(transform, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+        transform = glm::rotate(transform, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+        transform = glm::scale(transform, glm::vec3(scale));
+
+        m_transform.local = transform;
+        m_transform.position = position;
+        m_transform.rotation = rotation;
+        m_transform.scale = scale;
+        m_transform.local_valid = true;
+        m_transform.local_changed = true;
+
+        return m_transform.local;
+    }
+
+    void ModelNode::update_world_transform(Context3D& context) const {
+        get_local_transform();
+
+        if (
+            m_transform.local_changed ||
+            context.transform_version == TRANSFORM_VERSION_NONE ||
+            context.transform_version != m_transform.parent_version
+        ) {
+            m_transform.world = context.transform * m_transform.local;
+            m_transform.parent_version = context.transform_version;
+            m_transform.version = next_transform_version();
+            m_transform.local_changed = false;
+        }
+
+        context.transform = m_transform.world;
+        context.transform_version = m_transform.version;
+    }
+
     void SceneNode2D::add_node(std::shared_ptr<SceneNode2D> node) {
         m_children.push_back(node);
     }
 
+    void SceneNode2D::remove_node(const SceneNode2D* node) {
+        m_children.erase(
+            std::remove_if(m_children.begin(), m_children.end(), [node](const std::shared_ptr<SceneNode2D>& child) {
+                return child.get() == node;
+            }),
+            m_children.end()
+        );
+    }
+
     void SceneNode2D::clear_nodes() {
         m_children.clear();
     }
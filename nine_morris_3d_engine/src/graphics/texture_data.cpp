@@ -1,7 +1,9 @@
 #include "nine_morris_3d_engine/graphics/texture_data.hpp"
 
 #include <cstdlib>
-#include <mutex>
+#include <cstring>
+#include <utility>
+#include <vector>
 
 #include <stb_image.h>
 #include <stb_image_resize2.h>
@@ -11,25 +13,19 @@
 
 namespace sm {
     static constexpr int CHANNELS {4};
-    static std::mutex g_mutex;
 
     TextureData::TextureData(const std::string& buffer, const TexturePostProcessing& post_processing) {
-        {
-            std::lock_guard lock {g_mutex};  // For some stupid reason stbi_load_from_memory is not thread safe :P
-
-            stbi_set_flip_vertically_on_load(static_cast<int>(post_processing.flip));
-
-            int channels {};
-
-            m_data = stbi_load_from_memory(
-                reinterpret_cast<const unsigned char*>(buffer.data()),
-                static_cast<int>(buffer.size()),
-                &m_width,
-                &m_height,
-                &channels,
-                CHANNELS
-            );
-        }
+        // The global flip flag of stb_image is never set, so that images can be decoded from any thread
+        int channels {};
+
+        m_data = stbi_load_from_memory(
+            reinterpret_cast<const unsigned char*>(buffer.data()),
+            static_cast<int>(buffer.size()),
+            &m_width,
+            &m_height,
+            &channels,
+            CHANNELS
+        );
 
         if (m_data == nullptr) {
             SM_THROW_ERROR(internal::ResourceError, "Could not load texture data");
@@ -41,17 +37,44 @@ namespace sm {
             LOG_DEBUG("Resized texture");
         }
 
+        // Flip after resizing, as there are less rows to swap
+        if (post_processing.flip) {
+            flip_vertically();
+        }
+
         LOG_DEBUG("Loaded texture data");
     }
 
     TextureData::~TextureData() {
-        assert(m_data != nullptr);
+        // Moved from
+        if (m_data == nullptr) {
+            return;
+        }
 
         stbi_image_free(m_data);
 
         LOG_DEBUG("Freed texture data");
     }
 
+    TextureData::TextureData(TextureData&& other) noexcept
+        : m_width(other.m_width), m_height(other.m_height), m_data(std::exchange(other.m_data, nullptr)) {}
+
+    TextureData& TextureData::operator=(TextureData&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+
+        if (m_data != nullptr) {
+            stbi_image_free(m_data);
+        }
+
+        m_width = other.m_width;
+        m_height = other.m_height;
+        m_data = std::exchange(other.m_data, nullptr);
+
+        return *this;
+    }
+
     int TextureData::get_width() const {
         return m_width;
     }
@@ -78,4 +101,18 @@ namespace sm {
         m_width = new_width;
         m_height = new_height;
     }
+
+    void TextureData::flip_vertically() {
+        const auto stride {static_cast<std::size_t>(m_width) * CHANNELS};
+        std::vector<unsigned char> row(stride);
+
+        for (int i {0}; i < m_height / 2; i++) {
+            unsigned char* top {m_data + static_cast<std::size_t>(i) * stride};
+            unsigned char* bottom {m_data + static_cast<std::size_t>(m_height - 1 - i) * stride};
+
+            std::memcpy(row.data(), top, stride);
+            std::memcpy(top, bottom, stride);
+            std::memcpy(bottom, row.data(), stride);
+        }
+    }
 }
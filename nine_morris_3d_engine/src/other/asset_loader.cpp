@@ -0,0 +1,268 @@
+#include "nine_morris_3d_engine/other/asset_loader.hpp"
+
+#include <unordered_set>
+#include <algorithm>
+#include <optional>
+#include <chrono>
+#include <utility>
+
+#include <cereal/external/rapidjson/document.h>
+
+#include "nine_morris_3d_engine/application/internal/error.hpp"
+#include "nine_morris_3d_engine/application/internal/profiler.hpp"
+#include "nine_morris_3d_engine/application/context.hpp"
+#include "nine_morris_3d_engine/application/logging.hpp"
+#include "nine_morris_3d_engine/other/utilities.hpp"
+
+namespace sm {
+    static std::optional<AssetLoader::AssetType> parse_type(const std::string& type) {
+        if (type == "mesh") {
+            return AssetLoader::AssetType::Mesh;
+        } else if (type == "texture_data") {
+            return AssetLoader::AssetType::TextureData;
+        } else if (type == "sound_data") {
+            return AssetLoader::AssetType::SoundData;
+        }
+
+        return std::nullopt;
+    }
+
+    // Return nothing, if a variable is empty or undefined
+    static std::optional<std::string> substitute_variables(const std::string& string, const AssetLoader::Variables& variables) {
+        std::string result;
+        std::size_t position {0};
+
+        while (true) {
+            const std::size_t begin {string.find("${", position)};
+
+            if (begin == std::string::npos) {
+                result += string.substr(position);
+                break;
+            }
+
+            const std::size_t end {string.find('}', begin)};
+
+            if (end == std::string::npos) {
+                SM_THROW_ERROR(internal::ResourceError, "Unterminated variable in `{}`", string);
+            }
+
+            const auto iter {variables.find(string.substr(begin + 2, end - begin - 2))};
+
+            if (iter == variables.cend() || iter->second.empty()) {
+                return std::nullopt;
+            }
+
+            result += string.substr(position, begin - position);
+            result += iter->second;
+            position = end + 1;
+        }
+
+        return result;
+    }
+
+    static double milliseconds_since(std::chrono::steady_clock::time_point begin) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    AssetLoader::AssetLoader(const std::filesystem::path& file_path, const Variables& variables, TextureSize texture_size)
+        : m_texture_size(texture_size) {
+        std::string buffer;
+
+        try {
+            buffer = utils::read_file_ex(file_path, true);
+        } catch (const internal::ResourceError& e) {
+            SM_THROW_ERROR(internal::ResourceError, "Could not read asset manifest: {}", e.what());
+        }
+
+        rapidjson::StringStream stream {buffer.data()};
+        rapidjson::Document document;
+        document.ParseStream(stream);
+
+        if (!document.IsObject()) {
+            SM_THROW_ERROR(internal::ResourceError, "Invalid document");
+        }
+
+        if (!document.HasMember("assets")) {
+            SM_THROW_ERROR(internal::ResourceError, "Missing member: `assets`");
+        }
+
+        if (!document["assets"].IsArray()) {
+            SM_THROW_ERROR(internal::ResourceError, "Invalid member: `assets`");
+        }
+
+        std::unordered_map<std::string, std::size_t> indices;
+        std::unordered_set<std::string> skipped;
+
+        for (const auto& element : document["assets"].GetArray()) {
+            if (!element.IsObject()) {
+                SM_THROW_ERROR(internal::ResourceError, "Invalid asset");
+            }
+
+            for (const char* member : {"name", "type", "path"}) {
+                if (!element.HasMember(member) || !element[member].IsString()) {
+                    SM_THROW_ERROR(internal::ResourceError, "Missing or invalid asset member: `{}`", member);
+                }
+            }
+
+            Asset asset;
+            asset.name = element["name"].GetString();
+
+            if (indices.find(asset.name) != indices.cend() || skipped.find(asset.name) != skipped.cend()) {
+                SM_THROW_ERROR(internal::ResourceError, "Duplicate asset `{}`", asset.name);
+            }
+
+            const auto type {parse_type(element["type"].GetString())};
+
+            if (!type) {
+                SM_THROW_ERROR(internal::ResourceError, "Invalid type of asset `{}`", asset.name);
+            }
+
+            asset.type = *type;
+
+            const auto path {substitute_variables(element["path"].GetString(), variables)};
+
+            if (!path) {
+                skipped.insert(asset.name);
+                continue;
+            }
+
+            asset.file_path = *path;
+
+            if (element.HasMember("flip")) {
+                if (!element["flip"].IsBool()) {
+                    SM_THROW_ERROR(internal::ResourceError, "Invalid member `flip` of asset `{}`", asset.name);
+                }
+
+                asset.flip = element["flip"].GetBool();
+            }
+
+            if (element.HasMember("dependencies")) {
+                if (!element["dependencies"].IsArray()) {
+                    SM_THROW_ERROR(internal::ResourceError, "Invalid member `dependencies` of asset `{}`", asset.name);
+                }
+
+                for (const auto& dependency : element["dependencies"].GetArray()) {
+                    if (!dependency.IsString()) {
+                        SM_THROW_ERROR(internal::ResourceError, "Invalid dependency of asset `{}`", asset.name);
+                    }
+
+                    // Dependencies must be listed before, which also prevents cycles
+                    const auto iter {indices.find(dependency.GetString())};
+
+                    if (iter != indices.cend()) {
+                        asset.dependencies.push_back(iter->second);
+                    } else if (skipped.find(dependency.GetString()) == skipped.cend()) {
+                        SM_THROW_ERROR(internal::ResourceError, "Unknown dependency `{}` of asset `{}`", dependency.GetString(), asset.name);
+                    }
+                }
+            }
+
+            indices[asset.name] = m_assets.size();
+            m_assets.push_back(std::move(asset));
+        }
+
+        LOG_DEBUG("Read asset manifest with {} assets, {} skipped", m_assets.size(), skipped.size());
+    }
+
+    Job AssetLoader::load(Ctx& ctx) {
+        const auto begin {std::chrono::steady_clock::now()};
+
+        m_loaded = 0;
+
+        std::vector<Job> jobs;
+        jobs.reserve(m_assets.size());
+
+        for (Asset& asset : m_assets) {
+            std::vector<Job> dependencies;
+
+            for (const std::size_t index : asset.dependencies) {
+                dependencies.push_back(jobs[index]);
+            }
+
+            jobs.push_back(ctx.add_job([this, &ctx, &asset]() {
+                load_asset(ctx, asset);
+            }, dependencies));
+        }
+
+        return ctx.add_job([this, begin]() {
+            m_duration = milliseconds_since(begin);
+        }, jobs);
+    }
+
+    std::size_t AssetLoader::get_loaded_count() const {
+        return m_loaded.load();
+    }
+
+    std::size_t AssetLoader::get_asset_count() const {
+        return m_assets.size();
+    }
+
+    float AssetLoader::get_progress() const {
+        if (m_assets.empty()) {
+            return 1.0f;
+        }
+
+        return static_cast<float>(m_loaded.load()) / static_cast<float>(m_assets.size());
+    }
+
+    const std::vector<AssetLoader::Asset>& AssetLoader::get_assets() const {
+        return m_assets;
+    }
+
+    void AssetLoader::log_report() const {
+        std::vector<const Asset*> assets;
+
+        for (const Asset& asset : m_assets) {
+            assets.push_back(&asset);
+        }
+
+        std::sort(assets.begin(), assets.end(), [](const Asset* left, const Asset* right) {
+            return left->duration > right->duration;
+        });
+
+        double sequential_duration {};
+
+        for (const Asset* asset : assets) {
+            LOG_INFO("Loaded asset `{}` in {:.2f} ms", asset->name, asset->duration);
+
+            sequential_duration += asset->duration;
+        }
+
+        LOG_INFO(
+            "Loaded {} assets in {:.2f} ms, instead of {:.2f} ms sequentially ({:.2f}x)",
+            m_assets.size(),
+            m_duration,
+            sequential_duration,
+            m_duration > 0.0 ? sequential_duration / m_duration : 0.0
+        );
+    }
+
+    void AssetLoader::load_asset(Ctx& ctx, Asset& asset) {
+        SM_PROFILE_SCOPE("Load asset");
+
+        const auto begin {std::chrono::steady_clock::now()};
+        const auto file_path {ctx.path_assets(asset.file_path)};
+
+        switch (asset.type) {
+            case AssetType::Mesh:
+                ctx.load_mesh(ctx.path_baked_assets(asset.file_path));  // Meshes are baked by the build
+                break;
+            case AssetType::TextureData: {
+                TexturePostProcessing post_processing;
+                post_processing.flip = asset.flip;
+                post_processing.size = m_texture_size;
+
+                ctx.load_texture_data(file_path, post_processing);
+
+                break;
+            }
+            case AssetType::SoundData:
+                ctx.load_sound_data(file_path);
+                break;
+        }
+
+        asset.duration = milliseconds_since(begin);
+
+        m_loaded++;
+    }
+}
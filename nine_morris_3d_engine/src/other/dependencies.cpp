@@ -5,7 +5,6 @@
 #include <imgui.h>
 #include <SDL3/SDL.h>
 #include <SDL3_mixer/SDL_mixer.h>
-#include <assimp/version.h>
 #include <glm/glm.hpp>
 #include <spdlog/version.h>
 #include <cereal/version.hpp>
@@ -55,16 +54,6 @@ namespace sm {
         );
         result += buffer;
 
-        std::snprintf(
-            buffer,
-            sizeof(buffer),
-            "Assimp: %u.%u.%u\n",
-            aiGetVersionMajor(),
-            aiGetVersionMinor(),
-            aiGetVersionPatch()
-        );
-        result += buffer;
-
         std::snprintf(
             buffer,
             sizeof(buffer),
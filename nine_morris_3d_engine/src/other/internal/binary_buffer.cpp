@@ -0,0 +1,57 @@
+#include "nine_morris_3d_engine/other/internal/binary_buffer.hpp"
+
+#include <cstring>
+
+namespace sm::internal {
+    std::uint64_t hash_bytes(std::uint64_t hash, const void* data, std::size_t size) {
+        const unsigned char* bytes {static_cast<const unsigned char*>(data)};
+
+        for (std::size_t i {0}; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3;
+        }
+
+        return hash;
+    }
+
+    void BinaryWriter::write_uint(std::uint32_t value) {
+        m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void BinaryWriter::write_string(std::string_view string) {
+        write_uint(static_cast<std::uint32_t>(string.size()));
+        m_buffer.append(string);
+    }
+
+    const std::string& BinaryWriter::get_buffer() const {
+        return m_buffer;
+    }
+
+    bool BinaryReader::read_uint(std::uint32_t& value) {
+        if (m_buffer.size() - m_position < sizeof(value)) {
+            return false;
+        }
+
+        std::memcpy(&value, m_buffer.data() + m_position, sizeof(value));
+        m_position += sizeof(value);
+
+        return true;
+    }
+
+    bool BinaryReader::read_string(std::string& string) {
+        std::uint32_t size {};
+
+        if (!read_uint(size) || m_buffer.size() - m_position < size) {
+            return false;
+        }
+
+        string = m_buffer.substr(m_position, size);
+        m_position += size;
+
+        return true;
+    }
+
+    bool BinaryReader::at_end() const {
+        return m_position == m_buffer.size();
+    }
+}
@@ -0,0 +1,114 @@
+#include "nine_morris_3d_engine/other/internal/mapped_file.hpp"
+
+#include "nine_morris_3d_engine/application/platform.hpp"
+
+#if defined(SM_PLATFORM_LINUX)
+    #include <cerrno>
+    #include <cstring>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#elif defined(SM_PLATFORM_WINDOWS)
+    #include <Windows.h>
+#endif
+
+#include "nine_morris_3d_engine/application/internal/error.hpp"
+#include "nine_morris_3d_engine/application/logging.hpp"
+
+namespace sm::internal {
+#if defined(SM_PLATFORM_LINUX)
+    MappedFile::MappedFile(const std::filesystem::path& file_path) {
+        const int descriptor {open(file_path.c_str(), O_RDONLY)};
+
+        if (descriptor < 0) {
+            SM_THROW_ERROR(ResourceError, "Could not open file `{}`: {}", file_path.string(), std::strerror(errno));
+        }
+
+        struct stat status {};
+
+        if (fstat(descriptor, &status) < 0 || status.st_size == 0) {
+            close(descriptor);
+            SM_THROW_ERROR(ResourceError, "Could not get the size of file `{}`, or it is empty", file_path.string());
+        }
+
+        m_size = static_cast<std::size_t>(status.st_size);
+
+        void* data {mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0)};
+
+        // The mapping keeps its own reference to the file
+        close(descriptor);
+
+        if (data == MAP_FAILED) {
+            SM_THROW_ERROR(ResourceError, "Could not map file `{}`: {}", file_path.string(), std::strerror(errno));
+        }
+
+        m_data = static_cast<const unsigned char*>(data);
+
+        LOG_DEBUG("Mapped file `{}`", file_path.string());
+    }
+
+    MappedFile::~MappedFile() {
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+    }
+#elif defined(SM_PLATFORM_WINDOWS)
+    MappedFile::MappedFile(const std::filesystem::path& file_path) {
+        const HANDLE file {CreateFileW(
+            file_path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr
+        )};
+
+        if (file == INVALID_HANDLE_VALUE) {
+            SM_THROW_ERROR(ResourceError, "Could not open file `{}`: {}", file_path.string(), GetLastError());
+        }
+
+        LARGE_INTEGER size {};
+
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            CloseHandle(file);
+            SM_THROW_ERROR(ResourceError, "Could not get the size of file `{}`, or it is empty", file_path.string());
+        }
+
+        m_size = static_cast<std::size_t>(size.QuadPart);
+
+        const HANDLE mapping {CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+
+        // The mapping keeps its own reference to the file
+        CloseHandle(file);
+
+        if (mapping == nullptr) {
+            SM_THROW_ERROR(ResourceError, "Could not map file `{}`: {}", file_path.string(), GetLastError());
+        }
+
+        const void* data {MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)};
+
+        if (data == nullptr) {
+            CloseHandle(mapping);
+            SM_THROW_ERROR(ResourceError, "Could not map file `{}`: {}", file_path.string(), GetLastError());
+        }
+
+        m_data = static_cast<const unsigned char*>(data);
+        m_mapping = mapping;
+
+        LOG_DEBUG("Mapped file `{}`", file_path.string());
+    }
+
+    MappedFile::~MappedFile() {
+        UnmapViewOfFile(m_data);
+        CloseHandle(static_cast<HANDLE>(m_mapping));
+    }
+#endif
+
+    const unsigned char* MappedFile::get_data() const {
+        return m_data;
+    }
+
+    std::size_t MappedFile::get_size() const {
+        return m_size;
+    }
+}
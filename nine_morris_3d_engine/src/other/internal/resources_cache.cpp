@@ -1,19 +1,179 @@
 #include "nine_morris_3d_engine/other/internal/resources_cache.hpp"
 
+#include <algorithm>
+
+#include "nine_morris_3d_engine/application/internal/profiler.hpp"
+#include "nine_morris_3d_engine/application/logging.hpp"
+#include "nine_morris_3d_engine/other/utilities.hpp"
+
 namespace sm::internal {
+    static std::atomic<std::uint64_t> g_use {0};
+
+    static std::size_t texture_size(int width, int height) {
+        return static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4;
+    }
+
+    std::size_t resource_size(const Mesh& mesh) {
+        return mesh.get_vertices_size() + mesh.get_indices_size();
+    }
+
+    std::size_t resource_size(const TextureData& texture_data) {
+        return texture_size(texture_data.get_width(), texture_data.get_height());
+    }
+
+    std::size_t resource_size(const Font& font) {
+        const GlTexture* bitmap {font.get_bitmap()};
+
+        if (bitmap == nullptr) {
+            return 0;
+        }
+
+        // Single channel
+        return texture_size(bitmap->get_width(), bitmap->get_height()) / 4;
+    }
+
+    std::size_t resource_size(const GlTexture& texture) {
+        return texture_size(texture.get_width(), texture.get_height());
+    }
+
+    std::size_t resource_size(const GlTextureCubemap& texture) {
+        return texture.get_size();
+    }
+
+    std::size_t resource_size(const GlVertexBuffer& vertex_buffer) {
+        return vertex_buffer.get_size();
+    }
+
+    std::size_t resource_size(const GlIndexBuffer& index_buffer) {
+        return static_cast<std::size_t>(index_buffer.get_index_count()) * sizeof(unsigned int);
+    }
+
+    std::size_t resource_size(const SoundData& sound_data) {
+        return sound_data.get_size();
+    }
+
+    std::uint64_t next_use() {
+        return ++g_use;
+    }
+
     void ResourcesCache::clear() {
-        mesh->clear();
-        texture_data->clear();
-        font->clear();
-        material->clear();
-        material_instance->clear();
-        texture->clear();
-        texture_cubemap->clear();
-        vertex_array->clear();
-        vertex_buffer->clear();
-        index_buffer->clear();
-        shader->clear();
-        framebuffer->clear();
-        sound_data->clear();
+        for (const NamedCache& cache : get_caches()) {
+            cache.cache->clear();
+        }
+
+        mesh_sources.clear();
+        texture_data_sources.clear();
+    }
+
+    std::shared_ptr<Mesh> ResourcesCache::get_mesh(Id id) {
+        if (auto resource {mesh.get(id)}) {
+            return resource;
+        }
+
+        // It may have been evicted under the memory budget
+        if (const auto file_path {mesh_sources.get(id)}) {
+            SM_PROFILE_SCOPE("Reload mesh");
+
+            return mesh.load(id, *file_path);
+        }
+
+        return nullptr;
+    }
+
+    std::shared_ptr<TextureData> ResourcesCache::get_texture_data(Id id) {
+        if (auto resource {texture_data.get(id)}) {
+            return resource;
+        }
+
+        // It may have been evicted under the memory budget
+        if (const auto source {texture_data_sources.get(id)}) {
+            SM_PROFILE_SCOPE("Reload texture data");
+
+            return texture_data.load(id, utils::read_file(source->file_path), source->post_processing);
+        }
+
+        return nullptr;
+    }
+
+    void ResourcesCache::trim() {
+        std::size_t memory_usage {get_memory_usage()};
+
+        if (memory_usage <= m_memory_budget) {
+            return;
+        }
+
+        SM_PROFILE_SCOPE("Trim resources");
+
+        std::vector<EvictionCandidate> candidates;
+
+        for (const NamedCache& cache : get_caches()) {
+            if (cache.cache->is_evictable()) {
+                cache.cache->collect_unreferenced(candidates);
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end(), [](const EvictionCandidate& left, const EvictionCandidate& right) {
+            return left.last_use < right.last_use;
+        });
+
+        // Evicting containers, like vertex arrays, releases their contents only for the next trim
+        std::size_t evicted {0};
+
+        for (const EvictionCandidate& candidate : candidates) {
+            if (memory_usage <= m_memory_budget) {
+                break;
+            }
+
+            if (candidate.cache->evict(candidate)) {
+                memory_usage -= std::min(candidate.size, memory_usage);
+                evicted++;
+            }
+        }
+
+        LOG_DEBUG("Evicted {} resources, now using {} bytes out of {}", evicted, memory_usage, m_memory_budget);
+    }
+
+    void ResourcesCache::set_memory_budget(std::size_t memory_budget) {
+        m_memory_budget = memory_budget;
+    }
+
+    std::size_t ResourcesCache::get_memory_budget() const {
+        return m_memory_budget;
+    }
+
+    std::size_t ResourcesCache::get_memory_usage() const {
+        return (
+            mesh.get_statistics().size +
+            texture_data.get_statistics().size +
+            font.get_statistics().size +
+            material.get_statistics().size +
+            material_instance.get_statistics().size +
+            texture.get_statistics().size +
+            texture_cubemap.get_statistics().size +
+            vertex_array.get_statistics().size +
+            vertex_buffer.get_statistics().size +
+            index_buffer.get_statistics().size +
+            shader.get_statistics().size +
+            framebuffer.get_statistics().size +
+            sound_data.get_statistics().size
+        );
+    }
+
+    std::array<ResourcesCache::NamedCache, 13> ResourcesCache::get_caches() {
+        return {{
+            {"Mesh", &mesh},
+            {"Texture data", &texture_data},
+            {"Font", &font},
+            {"Material", &material},
+            {"Material instance", &material_instance},
+            {"Texture", &texture},
+            {"Texture cubemap", &texture_cubemap},
+            {"Vertex array", &vertex_array},
+            {"Vertex buffer", &vertex_buffer},
+            {"Index buffer", &index_buffer},
+            {"Shader", &shader},
+            {"Framebuffer", &framebuffer},
+            {"Sound data", &sound_data}
+        }};
     }
 }
@@ -0,0 +1,301 @@
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <array>
+#include <initializer_list>
+#include <cstddef>
+#include <cstdlib>
+
+#include <nine_morris_3d_engine/application/internal/file_system.hpp>
+#include <nine_morris_3d_engine/application/internal/logging_base.hpp>
+#include <nine_morris_3d_engine/application/internal/job_system.hpp>
+#include <nine_morris_3d_engine/application/internal/error.hpp>
+#include <nine_morris_3d_engine/graphics/internal/shader_library.hpp>
+#include <nine_morris_3d_engine/graphics/internal/font_atlas_cache.hpp>
+#include <nine_morris_3d_engine/other/internal/resources_cache.hpp>
+#include <nine_morris_3d_engine/other/asset_loader.hpp>
+
+// Tests of the engine systems which don't need a window, nor an audio device
+
+using namespace sm;
+
+static int g_failures {0};
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << __FILE__ << ':' << __LINE__ << ": Check failed: " #condition "\n"; \
+            g_failures++; \
+        } \
+    } while (false)
+
+static std::filesystem::path write_manifest(const std::string& contents) {
+    const auto file_path {std::filesystem::temp_directory_path() / "nine_morris_3d_engine_tests_loading.json"};
+
+    std::ofstream stream {file_path};
+    stream << contents;
+
+    return file_path;
+}
+
+static bool manifest_rejected(const std::string& contents) {
+    try {
+        AssetLoader loader {write_manifest(contents), {}, TextureSize::Default};
+    } catch (const internal::ResourceError&) {
+        return true;
+    }
+
+    return false;
+}
+
+static void test_asset_loader_dependencies(internal::JobSystem& job_system) {
+    // A chain of three, and one more asset depending on the chain and on a skipped asset
+    const AssetLoader loader {
+        write_manifest(R"({
+            "assets": [
+                { "name": "mesh", "type": "mesh", "path": "mesh.mesh" },
+                { "name": "texture", "type": "texture_data", "path": "texture.png", "flip": false, "dependencies": ["mesh"] },
+                { "name": "sound", "type": "sound_data", "path": "sound.ogg", "dependencies": ["texture"] },
+                { "name": "skipped", "type": "texture_data", "path": "${skybox}/px.png" },
+                { "name": "last", "type": "mesh", "path": "last.mesh", "dependencies": ["skipped", "sound", "mesh"] }
+            ]
+        })"),
+        {},
+        TextureSize::Default
+    };
+
+    const auto& assets {loader.get_assets()};
+
+    CHECK(assets.size() == 4);
+
+    if (assets.size() != 4) {
+        return;
+    }
+
+    CHECK(assets[0].name == "mesh" && assets[0].dependencies.empty());
+    CHECK(assets[1].name == "texture" && assets[1].dependencies == std::vector<std::size_t>({0}));
+    CHECK(assets[2].name == "sound" && assets[2].dependencies == std::vector<std::size_t>({1}));
+    CHECK(assets[3].name == "last" && assets[3].dependencies == std::vector<std::size_t>({2, 0}));
+    CHECK(assets[1].type == AssetLoader::AssetType::TextureData && !assets[1].flip);
+
+    // Resolve the graph the way the loader does and check that every asset comes after its dependencies
+    std::vector<std::size_t> order;
+    std::mutex mutex;
+    std::vector<Job> jobs;
+
+    for (std::size_t i {0}; i < assets.size(); i++) {
+        std::vector<Job> dependencies;
+
+        for (const std::size_t index : assets[i].dependencies) {
+            dependencies.push_back(jobs[index]);
+        }
+
+        jobs.push_back(job_system.add([&order, &mutex, i]() {
+            std::lock_guard lock {mutex};
+
+            order.push_back(i);
+        }, dependencies));
+    }
+
+    for (const Job& job : jobs) {
+        job_system.wait(job);
+    }
+
+    CHECK(order == std::vector<std::size_t>({0, 1, 2, 3}));
+}
+
+static void test_asset_loader_invalid_dependencies() {
+    // Dependencies must be listed before the assets depending on them
+    CHECK(manifest_rejected(R"({
+        "assets": [
+            { "name": "texture", "type": "texture_data", "path": "texture.png", "dependencies": ["mesh"] },
+            { "name": "mesh", "type": "mesh", "path": "mesh.mesh" }
+        ]
+    })"));
+
+    CHECK(manifest_rejected(R"({
+        "assets": [
+            { "name": "mesh", "type": "mesh", "path": "mesh.mesh", "dependencies": ["mesh"] }
+        ]
+    })"));
+
+    CHECK(manifest_rejected(R"({
+        "assets": [
+            { "name": "mesh", "type": "mesh", "path": "mesh.mesh", "dependencies": "texture" }
+        ]
+    })"));
+}
+
+static std::filesystem::path write_mesh() {
+    const auto file_path {std::filesystem::temp_directory_path() / "nine_morris_3d_engine_tests_triangle.mesh"};
+
+    const std::array<float, 18> vertices {
+        0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+        1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+        0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f
+    };
+    const std::array<unsigned int, 3> indices {0, 1, 2};
+
+    BakedMeshHeader header;
+    header.type = static_cast<std::uint32_t>(MeshType::PN);
+    header.vertex_count = 3;
+    header.vertices_size = sizeof(vertices);
+    header.index_count = 3;
+    header.indices_size = sizeof(indices);
+
+    std::ofstream stream {file_path, std::ios::binary};
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(vertices.data()), sizeof(vertices));
+    stream.write(reinterpret_cast<const char*>(indices.data()), sizeof(indices));
+
+    return file_path;
+}
+
+static void test_resources_evict_and_reload() {
+    const auto file_path {write_mesh()};
+    const Id id {"triangle.mesh"};
+
+    internal::ResourcesCache cache;
+    cache.set_memory_budget(0);
+
+    // Loaded the way Ctx::load_mesh does
+    cache.mesh_sources.set(id, file_path);
+    auto mesh {cache.mesh.load(id, file_path)};
+
+    CHECK(cache.get_memory_usage() == mesh->get_vertices_size() + mesh->get_indices_size());
+
+    // Referenced resources are never evicted
+    cache.trim();
+
+    CHECK(cache.mesh.contains(id));
+    CHECK(cache.mesh.get_statistics().evictions == 0);
+
+    mesh.reset();
+    cache.trim();
+
+    CHECK(!cache.mesh.contains(id));
+    CHECK(cache.mesh.get_statistics().evictions == 1);
+    CHECK(cache.get_memory_usage() == 0);
+
+    // Retrieving it again loads it from its file
+    mesh = cache.get_mesh(id);
+
+    CHECK(mesh != nullptr);
+    CHECK(cache.mesh.contains(id));
+    CHECK(cache.mesh.get_statistics().misses == 2);
+
+    if (mesh != nullptr) {
+        CHECK(mesh->get_type() == MeshType::PN);
+        CHECK(mesh->get_vertices_size() == sizeof(float) * 18);
+        CHECK(mesh->get_indices_size() == sizeof(unsigned int) * 3);
+    }
+
+    // Resources which have never been loaded from a file stay unknown
+    CHECK(cache.get_mesh(Id("unknown.mesh")) == nullptr);
+
+    mesh.reset();
+    cache.clear();
+
+    std::filesystem::remove(file_path);
+}
+
+static void test_shader_library_defines_after_comments() {
+    const internal::ShaderLibrary library {std::initializer_list<std::filesystem::path>()};
+
+    // Defines go after the version directive, even if comments come before it
+    CHECK(library.load_shader(
+        "/* License\n"
+        "   text */\n"
+        "// Comment\n"
+        "/* One */ /* Two\n"
+        "*/\n"
+        "#version 430 core\n"
+        "void main() {}\n",
+        {{"D_POINT_LIGHTS", "4"}}
+    ) == (
+        "/* License\n"
+        "   text */\n"
+        "// Comment\n"
+        "/* One */ /* Two\n"
+        "*/\n"
+        "#version 430 core\n"
+        "#define D_POINT_LIGHTS 4\n"
+        "#line 7\n"
+        "void main() {}\n"
+    ));
+
+    // Without a version directive, they go before the first line of code
+    CHECK(library.load_shader(
+        "/* Comment */\n"
+        "float x;\n",
+        {{"D_POINT_LIGHTS", "4"}}
+    ) == (
+        "/* Comment */\n"
+        "#define D_POINT_LIGHTS 4\n"
+        "#line 2\n"
+        "float x;\n"
+    ));
+}
+
+static void test_font_atlas_cache_store_and_load() {
+    const auto directory {std::filesystem::temp_directory_path() / "nine_morris_3d_engine_tests_saved_data"};
+    std::filesystem::create_directory(directory);
+
+    const internal::FileSystem fs {"", directory, "", "", ""};
+    const internal::FontAtlasCache cache {fs};
+
+    CHECK(cache.is_enabled());
+
+    internal::FontAtlas atlas;
+    atlas.bitmap = std::string(16, '\x7f');
+    atlas.packed_characters = {"first", "second"};
+
+    const auto key {cache.key("font", FontSpecification(), {{32, 95}})};
+
+    CHECK(!cache.load(key));
+
+    cache.store(key, atlas);
+
+    const auto loaded {cache.load(key)};
+
+    CHECK(loaded && loaded->bitmap == atlas.bitmap && loaded->packed_characters == atlas.packed_characters);
+
+    // Only the atlas is left in the cache, as the temporary file is renamed into place
+    std::size_t file_count {0};
+
+    for (const auto& entry : std::filesystem::directory_iterator(directory / "font_cache")) {
+        CHECK(entry.path().extension() == ".bin");
+        file_count++;
+    }
+
+    CHECK(file_count == 1);
+
+    std::filesystem::remove_all(directory);
+}
+
+int main() {
+    internal::FileSystem fs {"", "", "", "", ""};
+    internal::Logging log {"", fs};
+    internal::Logging::get_global_logger()->set_level(spdlog::level::off);  // Rejected manifests are logged as errors
+
+    internal::JobSystem job_system;
+
+    test_asset_loader_dependencies(job_system);
+    test_asset_loader_invalid_dependencies();
+    test_resources_evict_and_reload();
+    test_shader_library_defines_after_comments();
+    test_font_atlas_cache_store_and_load();
+
+    std::filesystem::remove(std::filesystem::temp_directory_path() / "nine_morris_3d_engine_tests_loading.json");
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "All checks passed\n";
+    return EXIT_SUCCESS;
+}
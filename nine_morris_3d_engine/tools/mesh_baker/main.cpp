@@ -0,0 +1,447 @@
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <cassert>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include "nine_morris_3d_engine/graphics/mesh.hpp"
+
+// Import a mesh with Assimp and write it in the baked format, which the engine maps directly into memory
+// Usage: mesh_baker <input_file> <output_file> <object_name> <P|PN|PNT|PNTT> [--adjacency] [--flip-winding] [--benchmark]
+
+namespace sm {
+    struct BakeError : std::runtime_error {
+        explicit BakeError(const std::string& message)
+            : std::runtime_error(message) {}
+    };
+
+    struct MeshSpecification {
+        std::string object_name;
+        MeshType type {MeshType::P};
+        bool generate_adjacency_indices {false};
+        bool flip_winding {false};
+        bool benchmark {false};
+    };
+
+    struct VertexP {
+        aiVector3D position;
+    };
+
+    struct VertexPN {
+        aiVector3D position;
+        aiVector3D normal;
+    };
+
+    struct VertexPNT {
+        aiVector3D position;
+        aiVector3D normal;
+        aiVector2D texture_coordinate;
+    };
+
+    struct VertexPNTT {
+        aiVector3D position;
+        aiVector3D normal;
+        aiVector2D texture_coordinate;
+        aiVector3D tangent;
+    };
+
+    // The opposite vertices of the first two distinct faces sharing an edge, in face order
+    struct EdgeOpposites {
+        unsigned int vertices[2] {};
+        unsigned int count {0};
+    };
+
+    using EdgeMap = std::unordered_map<std::uint64_t, EdgeOpposites>;
+
+    // Edges are undirected, so that faces with inconsistent winding are still adjacent
+    static std::uint64_t edge_key(unsigned int index1, unsigned int index2) {
+        const auto [low, high] {std::minmax(index1, index2)};
+
+        return static_cast<std::uint64_t>(low) << 32 | static_cast<std::uint64_t>(high);
+    }
+
+    static EdgeMap build_edge_map(const aiMesh* mesh) {
+        EdgeMap edges;
+        edges.reserve(static_cast<std::size_t>(mesh->mNumFaces) * 3);
+
+        for (unsigned int i {0}; i < mesh->mNumFaces; i++) {
+            const aiFace& face {mesh->mFaces[i]};
+
+            for (unsigned int edge {0}; edge < 3; edge++) {
+                const unsigned int v1 {face.mIndices[edge]};  // First edge index
+                const unsigned int v2 {face.mIndices[(edge + 1) % 3]};  // Second edge index
+                const unsigned int vopp {face.mIndices[(edge + 2) % 3]};  // Opposite vertex index
+
+                EdgeOpposites& opposites {edges[edge_key(v1, v2)]};
+
+                // Two distinct vertices are enough to find one that differs from any face's own
+                if (opposites.count == 0 || opposites.count == 1 && opposites.vertices[0] != vopp) {
+                    opposites.vertices[opposites.count++] = vopp;
+                }
+            }
+        }
+
+        return edges;
+    }
+
+    static std::optional<unsigned int> find_adjacent_index(const EdgeMap& edges, unsigned int index1, unsigned int index2, unsigned int index3) {
+        const auto iter {edges.find(edge_key(index1, index2))};
+
+        if (iter == edges.end()) {
+            return std::nullopt;
+        }
+
+        const EdgeOpposites& opposites {iter->second};
+
+        for (unsigned int i {0}; i < opposites.count; i++) {
+            if (opposites.vertices[i] != index3) {
+                return opposites.vertices[i];
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    // The previous quadratic search, kept as a reference for the benchmark
+    static std::optional<unsigned int> find_adjacent_index_scan(const aiMesh* mesh, unsigned int index1, unsigned int index2, unsigned int index3) {
+        for (unsigned int i {0}; i < mesh->mNumFaces; i++) {
+            const aiFace& face {mesh->mFaces[i]};
+
+            for (unsigned int edge {0}; edge < 3; edge++) {
+                unsigned int v1 {face.mIndices[edge]};  // First edge index
+                unsigned int v2 {face.mIndices[(edge + 1) % 3]};  // Second edge index
+                unsigned int vopp {face.mIndices[(edge + 2) % 3]};  // Opposite vertex index
+
+                if ((v1 == index1 && v2 == index2 || v2 == index1 && v1 == index2) && vopp != index3) {
+                    return vopp;
+                }
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    static void push_mesh_indices(const aiMesh* mesh, std::vector<unsigned int>& indices) {
+        for (unsigned int i {0}; i < mesh->mNumFaces; i++) {
+            const aiFace& face {mesh->mFaces[i]};
+
+            for (unsigned int j {0}; j < face.mNumIndices; j++) {
+                indices.push_back(face.mIndices[j]);
+            }
+        }
+    }
+
+    template<typename F>
+    static void push_mesh_adjacent_indices(const aiMesh* mesh, std::vector<unsigned int>& indices, F&& find_adjacent) {
+        indices.reserve(static_cast<std::size_t>(mesh->mNumFaces) * 6);
+
+        for (unsigned int i {0}; i < mesh->mNumFaces; i++) {
+            const aiFace& face {mesh->mFaces[i]};
+
+            for (unsigned int j {0}; j < face.mNumIndices; j++) {
+                indices.push_back(face.mIndices[j]);
+
+                unsigned int index1 {face.mIndices[j]};
+                unsigned int index2 {face.mIndices[(j + 1) % face.mNumIndices]};
+                unsigned int index3 {face.mIndices[(j + 2) % face.mNumIndices]};
+
+                const auto vertex_adj {find_adjacent(index1, index2, index3)};
+
+                if (!vertex_adj) {
+                    throw BakeError("Could not find adjacent vertex for mesh");
+                }
+
+                indices.push_back(*vertex_adj);
+            }
+        }
+    }
+
+    // Build the edge map once, then every lookup is constant time
+    static void push_mesh_adjacent_indices(const aiMesh* mesh, std::vector<unsigned int>& indices) {
+        const EdgeMap edges {build_edge_map(mesh)};
+
+        push_mesh_adjacent_indices(mesh, indices, [&edges](unsigned int index1, unsigned int index2, unsigned int index3) {
+            return find_adjacent_index(edges, index1, index2, index3);
+        });
+    }
+
+    static void push_indices(const aiMesh* mesh, std::vector<unsigned int>& indices, bool generate_adjacency_indices) {
+        if (generate_adjacency_indices) {
+            push_mesh_adjacent_indices(mesh, indices);
+        } else {
+            push_mesh_indices(mesh, indices);
+        }
+    }
+
+    template<typename F>
+    static double time_milliseconds(F&& function) {
+        const auto begin {std::chrono::steady_clock::now()};
+        function();
+        const auto end {std::chrono::steady_clock::now()};
+
+        return std::chrono::duration<double, std::milli>(end - begin).count();
+    }
+
+    // Compare the edge map against the quadratic search on the same mesh
+    static void benchmark_adjacency(const aiMesh* mesh) {
+        std::vector<unsigned int> indices_map;
+        std::vector<unsigned int> indices_scan;
+
+        const double time_map {time_milliseconds([&]() {
+            push_mesh_adjacent_indices(mesh, indices_map);
+        })};
+
+        const double time_scan {time_milliseconds([&]() {
+            push_mesh_adjacent_indices(mesh, indices_scan, [mesh](unsigned int index1, unsigned int index2, unsigned int index3) {
+                return find_adjacent_index_scan(mesh, index1, index2, index3);
+            });
+        })};
+
+        if (indices_map != indices_scan) {
+            throw BakeError("Adjacency indices differ between the edge map and the scan");
+        }
+
+        std::cout << "Adjacency of " << mesh->mNumFaces << " faces: edge map " << time_map << " ms, scan " << time_scan << " ms\n";
+    }
+
+    template<typename T>
+    static void push_vertex(const T& vertex, std::vector<unsigned char>& vertices) {
+        const auto bytes {reinterpret_cast<const unsigned char*>(&vertex)};
+        vertices.insert(vertices.end(), bytes, bytes + sizeof(T));
+    }
+
+    // Vertices are written directly in their final layout, without intermediate buffers
+    static void load_vertices(const aiMesh* mesh, MeshType type, std::vector<unsigned char>& vertices) {
+        for (unsigned int i {0}; i < mesh->mNumVertices; i++) {
+            switch (type) {
+                case MeshType::P: {
+                    VertexP vertex;
+                    vertex.position = mesh->mVertices[i];
+
+                    push_vertex(vertex, vertices);
+
+                    break;
+                }
+                case MeshType::PN: {
+                    VertexPN vertex;
+                    vertex.position = mesh->mVertices[i];
+                    vertex.normal = mesh->mNormals[i];
+
+                    push_vertex(vertex, vertices);
+
+                    break;
+                }
+                case MeshType::PNT: {
+                    VertexPNT vertex;
+                    vertex.position = mesh->mVertices[i];
+                    vertex.normal = mesh->mNormals[i];
+                    vertex.texture_coordinate.x = mesh->mTextureCoords[0][i].x;
+                    vertex.texture_coordinate.y = mesh->mTextureCoords[0][i].y;
+
+                    push_vertex(vertex, vertices);
+
+                    break;
+                }
+                case MeshType::PNTT: {
+                    VertexPNTT vertex;
+                    vertex.position = mesh->mVertices[i];
+                    vertex.normal = mesh->mNormals[i];
+                    vertex.texture_coordinate.x = mesh->mTextureCoords[0][i].x;
+                    vertex.texture_coordinate.y = mesh->mTextureCoords[0][i].y;
+                    vertex.tangent = mesh->mTangents[i];
+
+                    push_vertex(vertex, vertices);
+
+                    break;
+                }
+            }
+        }
+    }
+
+    static const aiMesh* find_mesh(const aiNode* node, const std::string& object_name, const aiScene* scene) {
+        for (unsigned int i {0}; i < node->mNumMeshes; i++) {
+            const aiMesh* mesh {scene->mMeshes[node->mMeshes[i]]};
+
+            if (std::strcmp(mesh->mName.C_Str(), object_name.c_str()) == 0) {
+                return mesh;
+            }
+        }
+
+        for (unsigned int i {0}; i < node->mNumChildren; i++) {
+            const aiMesh* mesh {find_mesh(node->mChildren[i], object_name, scene)};
+
+            if (mesh != nullptr) {
+                return mesh;
+            }
+        }
+
+        return nullptr;
+    }
+
+    static void bake(const std::filesystem::path& input_file_path, const std::filesystem::path& output_file_path, const MeshSpecification& specification) {
+        auto flags {static_cast<unsigned int>(aiProcess_ValidateDataStructure | aiProcess_GenBoundingBoxes | aiProcess_JoinIdenticalVertices)};
+
+        if (specification.flip_winding) {
+            flags |= aiProcess_FlipWindingOrder;
+        }
+
+        if (specification.type != MeshType::P) {
+            flags |= aiProcess_GenNormals;
+        }
+
+        if (specification.type == MeshType::PNTT) {
+            flags |= aiProcess_CalcTangentSpace;
+        }
+
+        if (specification.generate_adjacency_indices) {
+            assert(specification.type == MeshType::P);
+
+            flags |= aiProcess_DropNormals;
+            flags |= aiProcess_RemoveComponent;
+        }
+
+        Assimp::Importer importer;
+
+        if (specification.generate_adjacency_indices) {
+            importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, aiComponent_NORMALS | aiComponent_TEXCOORDS);
+        }
+
+        const aiScene* scene {importer.ReadFile(input_file_path.string(), flags)};
+
+        if (scene == nullptr) {
+            throw BakeError("Could not load model data: " + std::string(importer.GetErrorString()));
+        }
+
+        const aiMesh* mesh {find_mesh(scene->mRootNode, specification.object_name, scene)};
+
+        if (mesh == nullptr) {
+            throw BakeError("Model file does not contain `" + specification.object_name + "` mesh");
+        }
+
+        std::vector<unsigned char> vertices;
+        std::vector<unsigned int> indices;
+
+        if (specification.benchmark) {
+            benchmark_adjacency(mesh);
+        }
+
+        load_vertices(mesh, specification.type, vertices);
+        push_indices(mesh, indices, specification.generate_adjacency_indices);
+
+        BakedMeshHeader header;
+        header.type = static_cast<std::uint32_t>(specification.type);
+        header.adjacency = specification.generate_adjacency_indices ? 1 : 0;
+        header.aabb_min[0] = mesh->mAABB.mMin.x;
+        header.aabb_min[1] = mesh->mAABB.mMin.y;
+        header.aabb_min[2] = mesh->mAABB.mMin.z;
+        header.aabb_max[0] = mesh->mAABB.mMax.x;
+        header.aabb_max[1] = mesh->mAABB.mMax.y;
+        header.aabb_max[2] = mesh->mAABB.mMax.z;
+        header.vertex_count = mesh->mNumVertices;
+        header.vertices_size = vertices.size();
+        header.index_count = indices.size();
+        header.indices_size = indices.size() * sizeof(unsigned int);
+
+        std::ofstream stream {output_file_path, std::ios::binary};
+
+        if (!stream.is_open()) {
+            throw BakeError("Could not open file `" + output_file_path.string() + "` for writing");
+        }
+
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        stream.write(reinterpret_cast<const char*>(vertices.data()), static_cast<std::streamsize>(vertices.size()));
+        stream.write(reinterpret_cast<const char*>(indices.data()), static_cast<std::streamsize>(header.indices_size));
+
+        if (stream.fail()) {
+            throw BakeError("Could not write to file `" + output_file_path.string() + "`");
+        }
+    }
+
+    static std::optional<MeshType> parse_type(std::string_view type) {
+        if (type == "P") {
+            return MeshType::P;
+        } else if (type == "PN") {
+            return MeshType::PN;
+        } else if (type == "PNT") {
+            return MeshType::PNT;
+        } else if (type == "PNTT") {
+            return MeshType::PNTT;
+        }
+
+        return std::nullopt;
+    }
+}
+
+static void print_help() {
+    std::cerr << "Usage: mesh_baker <input_file> <output_file> <object_name> <P|PN|PNT|PNTT> [--adjacency] [--flip-winding] [--benchmark]\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc < 5) {
+        print_help();
+        return 1;
+    }
+
+    sm::MeshSpecification specification;
+    specification.object_name = argv[3];
+
+    const auto type {sm::parse_type(argv[4])};
+
+    if (!type) {
+        std::cerr << "Error: Invalid mesh type `" << argv[4] << "`\n";
+        print_help();
+        return 1;
+    }
+
+    specification.type = *type;
+
+    for (int i {5}; i < argc; i++) {
+        const std::string_view option {argv[i]};
+
+        if (option == "--adjacency") {
+            specification.generate_adjacency_indices = true;
+        } else if (option == "--flip-winding") {
+            specification.flip_winding = true;
+        } else if (option == "--benchmark") {
+            specification.benchmark = true;
+        } else {
+            std::cerr << "Error: Invalid option `" << option << "`\n";
+            print_help();
+            return 1;
+        }
+    }
+
+    if (specification.generate_adjacency_indices && specification.type != sm::MeshType::P) {
+        std::cerr << "Error: Adjacency indices require the P type\n";
+        return 1;
+    }
+
+    if (specification.benchmark && !specification.generate_adjacency_indices) {
+        std::cerr << "Error: The benchmark requires adjacency indices\n";
+        return 1;
+    }
+
+    try {
+        sm::bake(argv[1], argv[2], specification);
+    } catch (const sm::BakeError& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    std::cout << "Baked `" << argv[1] << "` into `" << argv[2] << "`\n";
+
+    return 0;
+}
@@ -0,0 +1,270 @@
+#include <iostream>
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <regex>
+#include <chrono>
+#include <algorithm>
+#include <initializer_list>
+#include <stdexcept>
+#include <cstddef>
+
+#include "nine_morris_3d_engine/application/internal/file_system.hpp"
+#include "nine_morris_3d_engine/application/internal/logging_base.hpp"
+#include "nine_morris_3d_engine/application/internal/error.hpp"
+#include "nine_morris_3d_engine/application/logging.hpp"
+#include "nine_morris_3d_engine/graphics/internal/shader_library.hpp"
+#include "nine_morris_3d_engine/other/utilities.hpp"
+
+// Preprocess all shaders with the shader library and with the previous regex based preprocessor
+// Fail, if the outputs are not equivalent
+// Usage: shader_benchmark <assets_directory> <engine_assets_directory> [iterations]
+
+namespace sm {
+    using Sources = std::unordered_map<std::string, std::string>;
+
+    struct Shader {
+        std::filesystem::path file_path;
+        std::string source;
+    };
+
+    static bool is_shader(const std::filesystem::path& file_path) {
+        const auto extension {file_path.extension()};
+
+        return extension == ".vert" || extension == ".frag" || extension == ".geom";
+    }
+
+    static void read_shaders(const std::filesystem::path& directory, std::vector<Shader>& shaders, Sources& includes) {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(directory / "shaders")) {
+            if (!entry.is_regular_file()) {
+                continue;
+            }
+
+            if (entry.path().extension() == ".glsl") {
+                includes[entry.path().filename().string()] = utils::read_file(entry.path());
+            } else if (is_shader(entry.path())) {
+                shaders.push_back({entry.path(), utils::read_file(entry.path())});
+            }
+        }
+    }
+
+    // The previous implementation, kept as reference
+    static std::string reference_load_shader(const Sources& includes, const std::string& source) {
+        const std::regex pattern (R"(^[ \t]*#include[ \t]*"[\w\-\/\.]+"[ \t]*$)", std::regex::ECMAScript | std::regex::multiline);
+
+        std::sregex_iterator begin_regex {source.cbegin(), source.cend(), pattern};
+        std::sregex_iterator end_regex;
+
+        std::string result;
+        auto begin {source.cbegin()};
+
+        for (auto iter {begin_regex}; iter != end_regex; iter++) {
+            const std::string match {iter->str()};
+            const auto first_quote {match.find_first_of('"')};
+            const auto last_quote {match.find_last_of('"')};
+            const std::string argument {match.substr(first_quote + 1, last_quote - first_quote - 1)};
+            const auto iter_include {includes.find(std::filesystem::path(argument).filename().string())};
+
+            if (iter_include == includes.cend()) {
+                throw std::runtime_error("Cannot include `" + argument + "`");
+            }
+
+            const auto match_begin {source.cbegin() + iter->position()};
+            const std::size_t line {static_cast<std::size_t>(std::count(source.cbegin(), match_begin, '\n')) + 1};
+
+            result += std::string(begin, match_begin);
+            result += "#line 1\n" + reference_load_shader(includes, iter_include->second) + "\n#line " + std::to_string(line + 1);
+
+            begin = match_begin + iter->length();
+        }
+
+        result += std::string(begin, source.cend());
+
+        return result;
+    }
+
+    static void substitute_defines(std::string& result, std::initializer_list<internal::ShaderLibrary::Definition> defines) {
+        for (const auto& define : defines) {
+            std::size_t index {};
+
+            while (true) {
+                const auto position {result.find(define.first, index)};
+
+                if (position == std::string::npos) {
+                    break;
+                }
+
+                result.replace(position, define.first.size(), define.second);
+
+                index = position + define.second.size();
+            }
+        }
+    }
+
+    static std::string reference_load_shader(const Sources& includes, const std::string& source, std::initializer_list<internal::ShaderLibrary::Definition> defines) {
+        std::string result {reference_load_shader(includes, source)};
+        substitute_defines(result, defines);
+
+        return result;
+    }
+
+    // The lines that matter to the compiler, without line directives and blank lines
+    static std::vector<std::string> significant_lines(const std::string& source) {
+        std::vector<std::string> lines;
+        std::size_t position {0};
+
+        while (position < source.size()) {
+            std::size_t end {source.find('\n', position)};
+
+            if (end == std::string::npos) {
+                end = source.size();
+            }
+
+            std::string line {source.substr(position, end - position)};
+            position = end + 1;
+
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+
+            if (line.find_first_not_of(" \t") == std::string::npos || line.rfind("#line ", 0) == 0) {
+                continue;
+            }
+
+            lines.push_back(std::move(line));
+        }
+
+        return lines;
+    }
+
+    // The single pass preprocessor emits the defines as directives, while the reference replaces them in the text
+    // Bring the output to the form of the reference, so that they can be compared line by line
+    static std::vector<std::string> normalized_lines(const std::string& source, std::initializer_list<internal::ShaderLibrary::Definition> defines) {
+        std::vector<std::string> lines {significant_lines(source)};
+
+        for (const auto& [name, value] : defines) {
+            const auto iter {std::find(lines.begin(), lines.end(), "#define " + name + ' ' + value)};
+
+            if (iter != lines.end()) {
+                lines.erase(iter);
+            }
+        }
+
+        for (std::string& line : lines) {
+            substitute_defines(line, defines);
+        }
+
+        return lines;
+    }
+
+    // Return false and report the first difference, if the outputs are not equivalent
+    static bool compare(const Shader& shader, const std::string& reference, const std::string& output, std::initializer_list<internal::ShaderLibrary::Definition> defines) {
+        const std::vector<std::string> reference_lines {significant_lines(reference)};
+        const std::vector<std::string> lines {normalized_lines(output, defines)};
+
+        const std::size_t count {std::min(reference_lines.size(), lines.size())};
+
+        for (std::size_t i {0}; i < count; i++) {
+            if (reference_lines[i] != lines[i]) {
+                std::cerr << "Mismatch in `" << shader.file_path.string() << "` on significant line " << i + 1 << ":\n";
+                std::cerr << "Regex: " << reference_lines[i] << '\n';
+                std::cerr << "Single pass: " << lines[i] << '\n';
+                return false;
+            }
+        }
+
+        if (reference_lines.size() != lines.size()) {
+            std::cerr << "Mismatch in `" << shader.file_path.string() << "`: " << reference_lines.size() << " significant lines instead of " << lines.size() << '\n';
+            return false;
+        }
+
+        return true;
+    }
+
+    template<typename F>
+    static double measure(std::size_t iterations, F&& function) {
+        const auto begin {std::chrono::steady_clock::now()};
+
+        for (std::size_t i {0}; i < iterations; i++) {
+            function();
+        }
+
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    static int benchmark(const std::filesystem::path& assets_directory, const std::filesystem::path& engine_assets_directory, std::size_t iterations) {
+        internal::FileSystem fs {"", "", assets_directory, assets_directory, ""};
+        internal::Logging log {"", fs};
+        internal::Logging::get_global_logger()->set_level(spdlog::level::info);
+
+        std::vector<Shader> shaders;
+        Sources includes;
+
+        read_shaders(assets_directory, shaders, includes);
+        read_shaders(engine_assets_directory, shaders, includes);
+
+        const internal::ShaderLibrary library {engine_assets_directory, assets_directory};
+        const std::initializer_list<internal::ShaderLibrary::Definition> defines {
+            {"D_POINT_LIGHTS", "4"},
+            {"D_MAX_TEXTS", "8"}
+        };
+
+        std::size_t reference_size {0};
+        std::size_t size {0};
+
+        const double reference_duration {measure(iterations, [&]() {
+            for (const Shader& shader : shaders) {
+                reference_size += reference_load_shader(includes, shader.source, defines).size();
+            }
+        })};
+
+        const double duration {measure(iterations, [&]() {
+            for (const Shader& shader : shaders) {
+                size += library.load_shader(shader.source, defines).size();
+            }
+        })};
+
+        // The output must not contain any includes left and it must be equivalent to the reference
+        bool equivalent {true};
+
+        for (const Shader& shader : shaders) {
+            const std::string output {library.load_shader(shader.source, defines)};
+
+            if (output.find("#include") != std::string::npos) {
+                std::cerr << "Unresolved include in `" << shader.file_path.string() << "`\n";
+                equivalent = false;
+                continue;
+            }
+
+            equivalent = compare(shader, reference_load_shader(includes, shader.source, defines), output, defines) && equivalent;
+        }
+
+        if (!equivalent) {
+            return 1;
+        }
+
+        std::cout << "Preprocessed " << shaders.size() << " shaders " << iterations << " times\n";
+        std::cout << "Regex: " << reference_duration << " ms (" << reference_size / iterations << " bytes)\n";
+        std::cout << "Single pass: " << duration << " ms (" << size / iterations << " bytes)\n";
+        std::cout << "Speedup: " << (duration > 0.0 ? reference_duration / duration : 0.0) << "x\n";
+
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: shader_benchmark <assets_directory> <engine_assets_directory> [iterations]\n";
+        return 1;
+    }
+
+    const std::size_t iterations {argc > 3 ? static_cast<std::size_t>(std::stoul(argv[3])) : 100};
+
+    try {
+        return sm::benchmark(argv[1], argv[2], iterations);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+}
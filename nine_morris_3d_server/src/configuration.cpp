@@ -28,6 +28,12 @@ static constexpr std::array LOG_LEVELS {
     "off"sv
 };
 
+static constexpr std::array LOG_OVERFLOWS {
+    "block"sv,
+    "overrun_oldest"sv,
+    "discard_new"sv
+};
+
 static void validate(Configuration& configuration) {
     if (configuration.session_collect_period < 1s || configuration.session_collect_period > 60s) {
         goto corrupted;
@@ -45,6 +51,26 @@ static void validate(Configuration& configuration) {
         goto corrupted;
     }
 
+    if (configuration.log_queue_size < 64 || configuration.log_queue_size > 1024 * 1024) {
+        goto corrupted;
+    }
+
+    if (std::find(LOG_OVERFLOWS.begin(), LOG_OVERFLOWS.end(), configuration.log_overflow) == LOG_OVERFLOWS.end()) {
+        goto corrupted;
+    }
+
+    if (configuration.outgoing_low_bytes >= configuration.outgoing_high_bytes) {
+        goto corrupted;
+    }
+
+    if (configuration.outgoing_low_messages >= configuration.outgoing_high_messages) {
+        goto corrupted;
+    }
+
+    if (configuration.outgoing_max_pressure_time < 1s || configuration.outgoing_max_pressure_time > 600s) {
+        goto corrupted;
+    }
+
     return;
 
 corrupted:
@@ -19,6 +19,13 @@ struct Configuration {
     std::chrono::seconds connection_check_period {std::chrono::seconds(10)};
     std::string log_target {"file"};
     std::string log_level {"info"};
+    std::uint32_t log_queue_size {8192};
+    std::string log_overflow {"discard_new"};
+    std::uint32_t outgoing_high_bytes {1024 * 256};
+    std::uint32_t outgoing_low_bytes {1024 * 64};
+    std::uint32_t outgoing_high_messages {1024};
+    std::uint32_t outgoing_low_messages {256};
+    std::chrono::seconds outgoing_max_pressure_time {std::chrono::seconds(10)};
 
     template<typename Archive>
     void serialize(Archive& archive, const std::uint32_t) {
@@ -28,7 +35,14 @@ struct Configuration {
             CEREAL_NVP(session_collect_period),
             CEREAL_NVP(connection_check_period),
             CEREAL_NVP(log_target),
-            CEREAL_NVP(log_level)
+            CEREAL_NVP(log_level),
+            CEREAL_NVP(log_queue_size),
+            CEREAL_NVP(log_overflow),
+            CEREAL_NVP(outgoing_high_bytes),
+            CEREAL_NVP(outgoing_low_bytes),
+            CEREAL_NVP(outgoing_high_messages),
+            CEREAL_NVP(outgoing_low_messages),
+            CEREAL_NVP(outgoing_max_pressure_time)
         );
     }
 };
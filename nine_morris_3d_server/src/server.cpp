@@ -7,7 +7,9 @@ Server::Server(const Configuration& configuration, const std::filesystem::path&
         [this](std::shared_ptr<networking::ClientConnection> connection) { on_client_connected(connection); },
         [this](std::shared_ptr<networking::ClientConnection> connection) { on_client_disconnected(connection); },
         log_target_from_str(configuration.log_target),
-        log_file_path
+        log_file_path,
+        configuration.log_queue_size,
+        log_overflow_policy_from_str(configuration.log_overflow)
     ) {}
 
 void Server::start(const Configuration& configuration) {
@@ -16,7 +18,14 @@ void Server::start(const Configuration& configuration) {
     m_server.get_logger()->info("Version {}.{}.{}", VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH);
     m_server.get_logger()->info("Build {} {}", __DATE__, __TIME__);
 
-    m_server.start(configuration.port, configuration.max_clients);
+    networking::OutgoingLimits outgoing_limits;
+    outgoing_limits.high_bytes = configuration.outgoing_high_bytes;
+    outgoing_limits.low_bytes = configuration.outgoing_low_bytes;
+    outgoing_limits.high_messages = configuration.outgoing_high_messages;
+    outgoing_limits.low_messages = configuration.outgoing_low_messages;
+    outgoing_limits.max_pressure_time = configuration.outgoing_max_pressure_time;
+
+    m_server.start(configuration.port, configuration.max_clients, outgoing_limits);
 
     using namespace std::chrono_literals;
 
@@ -42,6 +51,13 @@ void Server::start(const Configuration& configuration) {
 
         m_server.check_connections();
 
+        const auto dropped_log_messages {m_server.get_dropped_log_messages()};
+
+        if (dropped_log_messages > m_dropped_log_messages) {
+            m_server.get_logger()->warn("Dropped {} log messages", dropped_log_messages - m_dropped_log_messages);
+            m_dropped_log_messages = dropped_log_messages;
+        }
+
         return Task::Result::Repeat;
     }, configuration.connection_check_period);
 }
@@ -159,7 +175,7 @@ void Server::client_hello(std::shared_ptr<networking::ClientConnection> connecti
 
     const auto [major, minor, patch] {version_number(payload.version)};
 
-    if (minor != 6) {
+    if (minor != protocol::CLIENT_VERSION_MINOR) {
         server_hello_reject(connection, protocol::ErrorCode::IncompatibleVersion);
         connection->close();
         return;
@@ -205,7 +221,8 @@ void Server::server_ping(std::shared_ptr<networking::ClientConnection> connectio
     networking::Message message {protocol::message::Server_Ping};
     message.write(payload);
 
-    m_server.send_message(connection, message);
+    // A newer reply makes a queued one stale, so they never pile up for a client that doesn't keep up
+    m_server.send_message(connection, message, networking::SendPolicy::Coalesce);
 }
 
 void Server::client_request_game_session(std::shared_ptr<networking::ClientConnection> connection, const networking::Message& message) {
@@ -288,8 +305,27 @@ void Server::client_request_join_game_session(std::shared_ptr<networking::Client
     payload_accept.session_id = iter->first;
     payload_accept.initial_time = iter->second.initial_time;
     payload_accept.game_over = iter->second.game_over;
-    payload_accept.moves = iter->second.moves;
-    payload_accept.messages = iter->second.messages;
+
+    // Send only what the client is missing
+    // If the client is out of sync, it gets everything and starts over
+    const auto& moves {iter->second.moves};
+    const auto& messages {iter->second.messages};
+
+    if (payload.known_plies <= moves.size() && payload.known_messages <= messages.size()) {
+        payload_accept.first_ply = payload.known_plies;
+        payload_accept.first_message = payload.known_messages;
+    }
+
+    payload_accept.moves.assign(moves.begin() + payload_accept.first_ply, moves.end());
+    payload_accept.messages.assign(messages.begin() + payload_accept.first_message, messages.end());
+
+    m_server.get_logger()->debug(
+        "Client {} joins session {} from ply {} and message {}",
+        connection->get_id(),
+        payload.session_id,
+        payload_accept.first_ply,
+        payload_accept.first_message
+    );
 
     if (iter->second.connection1.expired()) {
         iter->second.connection1 = connection;
@@ -399,7 +435,7 @@ void Server::client_play_move(std::shared_ptr<networking::ClientConnection> conn
         return;
     }
 
-    iter->second.moves.emplace_back(payload.move, payload.time);
+    iter->second.moves.push_back({payload.move, payload.time});
     iter->second.game_over = payload.game_over;
 
     std::shared_ptr<networking::ClientConnection> remote_connection;
@@ -420,7 +456,7 @@ void Server::client_play_move(std::shared_ptr<networking::ClientConnection> conn
     }
 }
 
-void Server::server_remote_played_move(std::shared_ptr<networking::ClientConnection> connection, protocol::ClockTime time, const std::string& move) {
+void Server::server_remote_played_move(std::shared_ptr<networking::ClientConnection> connection, protocol::ClockTime time, protocol::Move move) {
     protocol::Server_RemotePlayedMove payload;
     payload.time = time;
     payload.move = move;
@@ -730,3 +766,15 @@ unsigned int Server::log_target_from_str(const std::string& string) {
 
     return networking::LogTarget::LogTargetNone;
 }
+
+networking::LogOverflowPolicy Server::log_overflow_policy_from_str(const std::string& string) {
+    if (string == "block") {
+        return networking::LogOverflowPolicy::Block;
+    } else if (string == "overrun_oldest") {
+        return networking::LogOverflowPolicy::OverrunOldest;
+    } else if (string == "discard_new") {
+        return networking::LogOverflowPolicy::DiscardNew;
+    }
+
+    return networking::LogOverflowPolicy::DiscardNew;
+}
@@ -38,7 +38,7 @@ private:
     void client_leave_game_session(std::shared_ptr<networking::ClientConnection> connection, const networking::Message& message);
     void server_remote_left_game_session(std::shared_ptr<networking::ClientConnection> connection);
     void client_play_move(std::shared_ptr<networking::ClientConnection> connection, const networking::Message& message);
-    void server_remote_played_move(std::shared_ptr<networking::ClientConnection> connection, protocol::ClockTime time, const std::string& move);
+    void server_remote_played_move(std::shared_ptr<networking::ClientConnection> connection, protocol::ClockTime time, protocol::Move move);
     void client_update_turn_time(std::shared_ptr<networking::ClientConnection> connection, const networking::Message& message);
     void client_timeout(std::shared_ptr<networking::ClientConnection> connection, const networking::Message& message);
     void server_remote_timed_out(std::shared_ptr<networking::ClientConnection> connection);
@@ -56,6 +56,7 @@ private:
     void server_cancel_rematch(std::shared_ptr<networking::ClientConnection> connection);
 
     static unsigned int log_target_from_str(const std::string& string);
+    static networking::LogOverflowPolicy log_overflow_policy_from_str(const std::string& string);
 
     networking::Server m_server;
 
@@ -72,4 +73,7 @@ private:
     SessionPool m_session_pool;
 
     TaskManager m_task_manager;
+
+    // Last known count of lost log messages
+    std::size_t m_dropped_log_messages {};
 };
@@ -3,7 +3,7 @@
 #include <tuple>
 
 inline constexpr unsigned int VERSION_MAJOR {0};
-inline constexpr unsigned int VERSION_MINOR {3};
+inline constexpr unsigned int VERSION_MINOR {4};
 inline constexpr unsigned int VERSION_PATCH {0};
 
 constexpr unsigned int version_number(unsigned int major, unsigned int minor, unsigned int patch) {